@@ -8,7 +8,8 @@
 m6502_p::m6502_p(machine_config &mconfig, const std::string &tag, device_t *owner, u32 clock)
     : device_t(mconfig, tag, owner, clock),
       device_execute_interface(),
-      device_memory_interface()
+      device_memory_interface(),
+      m_debug(*this)
 {
     // ------------------------------------------------------------------------
     //  Initialize the Lookup Table
@@ -247,6 +248,9 @@ m6502_p::m6502_p(machine_config &mconfig, const std::string &tag, device_t *owne
     lookup[0xD8] = { &m6502_p::CLD, &m6502_p::IMP, 2 };
     lookup[0xF8] = { &m6502_p::SED, &m6502_p::IMP, 2 };
     lookup[0xEA] = { &m6502_p::NOP, &m6502_p::IMP, 2 };
+
+    // Derive the disassembler's view of the table
+    dasm_init();
 }
 
 // ============================================================================
@@ -267,25 +271,26 @@ void m6502_p::device_reset() {
     PC = (hi << 8) | lo;
 
     m_icount = 0;
-    m_reset_line = false;
-    m_rdy_line = true; // Default to Ready
+    set_pending(PENDING_RESET | PENDING_HALT, false);  // Default to Ready
     
     std::cout << "[W65C02S] Reset. PC: " << std::hex << PC << std::dec << std::endl;
 }
 
 void m6502_p::set_input_line(int line, bool state) {
     switch(line) {
-        case IRQ_LINE: m_irq_line = state; break;
-        case NMI_LINE: m_nmi_line = state; break;
+        case IRQ_LINE: set_pending(PENDING_IRQ, state); break;
+        case NMI_LINE:
+            // NMI is edge triggered: latch the assertion, the CPU clears
+            // the latch when it takes the interrupt.
+            if (state && !m_nmi_line) set_pending(PENDING_NMI, true);
+            m_nmi_line = state;
+            break;
         case RESET_LINE:
-            if (state && !m_reset_line) {
-                // Rising edge of Reset assertion? Or Level?
-                // Real 6502 resets when line is LOW. We assume active HIGH logic here for simplicity.
-                // If state=true (Asserted), we hold reset.
-            }
-            m_reset_line = state;
+            // Real 6502 resets when line is LOW. We assume active HIGH logic here for simplicity.
+            // If state=true (Asserted), we hold reset.
+            set_pending(PENDING_RESET, state);
             break;
-        case RDY_LINE: m_rdy_line = state; break;
+        case RDY_LINE: set_pending(PENDING_HALT, !state); break;
     }
 }
 
@@ -299,30 +304,48 @@ void m6502_p::memory_map(address_map &map) {
 void m6502_p::execute_run() {
     
     // If Reset is held, do nothing
-    if (m_reset_line) {
+    if (m_pending.load(std::memory_order_relaxed) & PENDING_RESET) {
         m_icount = 0;
         return;
     }
 
+    // Only pay for the debugger when it has something to check
+    if (m_debug.active()) execute_loop<true>();
+    else                  execute_loop<false>();
+}
+
+template <bool Debug>
+void m6502_p::execute_loop() {
     while (m_icount > 0) {
-        // RDY Line Logic: If RDY is Low, CPU halts (simulated by not running)
-        if (!m_rdy_line) {
-            // We just burn cycles waiting
-            m_icount = 0; 
-            break;
-        }
+        // Lines: a single test while nothing is pending
+        if (const u32 pending = m_pending.load(std::memory_order_relaxed)) {
+            // RDY Line Logic: If RDY is Low, CPU halts (simulated by not running)
+            if (pending & (PENDING_HALT | PENDING_RESET)) {
+                // We just burn cycles waiting
+                m_icount = 0;
+                break;
+            }
+
+            // Interrupts
+            if (pending & PENDING_NMI) {
+                m_pending.fetch_and(~(u32)PENDING_NMI, std::memory_order_relaxed);
+                nmi();
+                continue;
+            }
 
-        // Interrupts
-        if (m_nmi_line && !m_nmi_prev) {
-            nmi();
-            m_nmi_prev = m_nmi_line;
-            continue;
+            // Only the IRQ level is left
+            if (get_flag(I) == 0) {
+                irq();
+                continue;
+            }
         }
-        m_nmi_prev = m_nmi_line;
 
-        if (m_irq_line && get_flag(I) == 0) {
-            irq();
-            continue;
+        // Breakpoints: one bit test, stop before the opcode fetch
+        if constexpr (Debug) {
+            if (m_debug.breakpoint_at(PC) && m_debug.breakpoint_hit(PC)) {
+                break;
+            }
+            m_debug.count_execute(PC);
         }
 
         // Execute Instruction
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <atomic>
 #include "emu/device.h"
 #include "emu/di_execute.h"
 #include "emu/di_memory.h"
+#include "emu/debug/debugcpu.h"
 
 
 // ============================================================================
@@ -80,21 +82,64 @@ class m6502_p : public device_t,
         u8  get_y()      const { return Y; }    // Y register
         u8  get_flags()  const { return P; }    // Processor Status Register (Flags)
 
+        // ========================================================================
+        //  Setters used by the debugger (GDB stub)
+        // ========================================================================
+        void set_pc(u16 v)    { PC = v; }
+        void set_sp(u8 v)     { S = v; }
+        void set_a(u8 v)      { A = v; }
+        void set_x(u8 v)      { X = v; }
+        void set_y(u8 v)      { Y = v; }
+        void set_flags(u8 v)  { P = v; }
+
         // DEBUGGER HELPER
         // Reads a byte form the bus for visualization purposes.
-        // We will use the internal 'space' interface if available, or just read_byte.
+        // Goes through the map's debug handler, so peeking at an I/O
+        // register (e.g. the ACIA status) doesn't change it.
         u8 debug_peek(u16 addr) {
-            // Since we are inside the class, we can access the protected read_byte.
-            // In a real emulator,, we might use a specific "non-intrusive" read here.
-            return read_byte(addr);
+            return read_byte_debug(addr);
         }
 
         // Total cycles executed since reset (useful for timing/debugging)
         u64 total_cycles() const { return m_total_cycles; }
 
-        // Setter for Cycle Budget (Used by Driver)
-        void icount_set(int cycles) { m_icount = cycles; }
-        int  icount_get() const { return m_icount; }
+        // WHAT: Lets 'cycles' pass without executing anything.
+        // WHO:  The driver, when it has proven the skipped cycles would only
+        //       repeat an idle polling loop (see mb_driver::skip_lcd_poll).
+        void skip_cycles(u64 cycles) { m_total_cycles += cycles; }
+
+        // WHAT: Would the next instruction boundary take an interrupt?
+        bool interrupt_pending() const {
+            const u32 pending = m_pending.load(std::memory_order_relaxed);
+            return (pending & PENDING_NMI) || ((pending & PENDING_IRQ) && !(P & I));
+        }
+
+        // ========================================================================
+        //  Disassembler (m6502dasm.cpp)
+        // ========================================================================
+        // WHAT: Operand formats, derived from the addressing mode in 'lookup'.
+        enum dasm_mode : u8 {
+            DASM_IMP, DASM_ACC, DASM_IMM, DASM_ZP0, DASM_ZPX, DASM_ZPY, DASM_ZPI,
+            DASM_ABS, DASM_ABX, DASM_ABY, DASM_IND, DASM_IZX, DASM_IZY, DASM_IAX,
+            DASM_REL
+        };
+
+        // WHAT: Instruction length in bytes (1-3) for an opcode.
+        int  dasm_length(u8 op) const { return m_dasm[op].length; }
+        const char* dasm_mnemonic(u8 op) const { return m_dasm[op].mnemonic; }
+
+        // WHAT: Formats the instruction whose bytes are 'ops' (opcode first,
+        //       up to 3 bytes) located at 'pc', e.g. "LDA ($12),Y".
+        // HOW:  Returns the instruction length. Pure: no bus access, so the
+        //       caller decides where the bytes come from (usually a cache).
+        //       16-bit operands and branch targets with an exact label in
+        //       'symbols' are printed by name ("JSR lcd_instruction").
+        int  disassemble(u16 pc, const u8* ops, char* buf, size_t size,
+                         const symbol_table* symbols = nullptr) const;
+
+        // WHAT: Breakpoints / watchpoints for this CPU.
+        // WHO:  Used by the debugger UI and the driver (to stop on a break).
+        device_debug& debug() { return m_debug; }
 
         // ========================================================================
         //  Internal Architecture
@@ -129,15 +174,32 @@ class m6502_p : public device_t,
         };
 
         // Emulation state
-        int m_icount = 0;           // Cycles remaining in this timeslice
+        // (The cycle budget is device_execute_interface::m_icount)
         u64 m_total_cycles = 0;     // Total cycles since power-on
 
+        // Debugger state (breakpoint bitmap, watchpoints)
+        device_debug m_debug;
+
         // Interrupt Lines state
-        bool m_irq_line = false;        // Default High
-        bool m_nmi_line = false;        // Active Low
-        bool m_nmi_prev  = false;       // To detect falling edge
-        bool m_rdy_line  = true;        // Ready is usally High (Active)
-        bool m_reset_line = false;
+        // WHAT: Everything that can stand between two instructions, folded
+        //       into one word. Zero means "fetch the next opcode".
+        // WHY:  The loop pays one load and one test per instruction instead
+        //       of checking every line and the I flag.
+        // HOW:  set_input_line() keeps the bits current; it may be called
+        //       from another thread, hence the atomic.
+        enum pending_bits : u32 {
+            PENDING_IRQ   = 1u << 0,    // /IRQ held (level; masked by I)
+            PENDING_NMI   = 1u << 1,    // /NMI edge latched, not yet taken
+            PENDING_HALT  = 1u << 2,    // RDY pulled low
+            PENDING_RESET = 1u << 3     // /RES held
+        };
+        std::atomic<u32> m_pending{0};
+        bool m_nmi_line = false;        // Last /NMI level (for the edge latch)
+
+        void set_pending(u32 bits, bool state) {
+            if (state) m_pending.fetch_or(bits, std::memory_order_relaxed);
+            else       m_pending.fetch_and(~bits, std::memory_order_relaxed);
+        }
         
         // ========================================================================
         //  Internal State for Addressing Modes
@@ -209,6 +271,11 @@ class m6502_p : public device_t,
         // Interrupt Logic
         void irq(); 
         void nmi();
+
+        // WHAT: The instruction loop behind execute_run().
+        // WHY:  Compiled twice. The <false> copy has no debugger code at all;
+        //       the <true> copy tests the breakpoint bitmap before each opcode.
+        template <bool Debug> void execute_loop();
         
         // ========================================================================
         //  Instruction Table
@@ -221,4 +288,13 @@ class m6502_p : public device_t,
 
         // The lookup Table (Fixed size array)
         Instruction lookup[256];
+
+        // WHAT: Disassembly table, built from 'lookup' so the two can't disagree.
+        struct dasm_entry {
+            const char* mnemonic = "???";
+            u8 mode = DASM_IMP;
+            u8 length = 1;
+        };
+        dasm_entry m_dasm[256];
+        void dasm_init();
 };
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "m6502.h"
+#include <cstdio>
+
+// ============================================================================
+//  W65C02S Disassembler
+// ============================================================================
+//  WHAT: Turns opcode bytes back into assembly text.
+//  WHY:  Driven by the same 'lookup' table the core executes, so the
+//        disassembly always shows what the emulator will actually do
+//        (unimplemented opcodes show up as "???", 1 byte).
+// ============================================================================
+
+// ============================================================================
+//  Table Construction
+// ============================================================================
+//  HOW:  Member function pointers can be compared, so each 'operate' and
+//        'addrmode' in the lookup table is matched against a list once at
+//        construction time.
+// ============================================================================
+void m6502_p::dasm_init() {
+    static const struct { void (m6502_p::*op)(); const char* name; } names[] = {
+        { &m6502_p::LDA, "LDA" }, { &m6502_p::LDX, "LDX" }, { &m6502_p::LDY, "LDY" },
+        { &m6502_p::STA, "STA" }, { &m6502_p::STX, "STX" }, { &m6502_p::STY, "STY" },
+        { &m6502_p::STZ, "STZ" },
+        { &m6502_p::TAX, "TAX" }, { &m6502_p::TAY, "TAY" }, { &m6502_p::TXA, "TXA" },
+        { &m6502_p::TYA, "TYA" }, { &m6502_p::TSX, "TSX" }, { &m6502_p::TXS, "TXS" },
+        { &m6502_p::ADC, "ADC" }, { &m6502_p::SBC, "SBC" },
+        { &m6502_p::AND, "AND" }, { &m6502_p::EOR, "EOR" }, { &m6502_p::ORA, "ORA" },
+        { &m6502_p::BIT, "BIT" },
+        { &m6502_p::ASL, "ASL" }, { &m6502_p::LSR, "LSR" }, { &m6502_p::ROL, "ROL" },
+        { &m6502_p::ROR, "ROR" },
+        { &m6502_p::INC, "INC" }, { &m6502_p::DEC, "DEC" }, { &m6502_p::INX, "INX" },
+        { &m6502_p::DEX, "DEX" }, { &m6502_p::INY, "INY" }, { &m6502_p::DEY, "DEY" },
+        { &m6502_p::CMP, "CMP" }, { &m6502_p::CPX, "CPX" }, { &m6502_p::CPY, "CPY" },
+        { &m6502_p::TRB, "TRB" }, { &m6502_p::TSB, "TSB" },
+        { &m6502_p::JMP, "JMP" }, { &m6502_p::JSR, "JSR" }, { &m6502_p::RTS, "RTS" },
+        { &m6502_p::BCC, "BCC" }, { &m6502_p::BCS, "BCS" }, { &m6502_p::BEQ, "BEQ" },
+        { &m6502_p::BMI, "BMI" }, { &m6502_p::BNE, "BNE" }, { &m6502_p::BPL, "BPL" },
+        { &m6502_p::BVC, "BVC" }, { &m6502_p::BVS, "BVS" }, { &m6502_p::BRA, "BRA" },
+        { &m6502_p::PHA, "PHA" }, { &m6502_p::PLA, "PLA" }, { &m6502_p::PHP, "PHP" },
+        { &m6502_p::PLP, "PLP" }, { &m6502_p::PHX, "PHX" }, { &m6502_p::PLX, "PLX" },
+        { &m6502_p::PHY, "PHY" }, { &m6502_p::PLY, "PLY" },
+        { &m6502_p::BRK, "BRK" }, { &m6502_p::RTI, "RTI" }, { &m6502_p::NOP, "NOP" },
+        { &m6502_p::CLC, "CLC" }, { &m6502_p::SEC, "SEC" }, { &m6502_p::CLI, "CLI" },
+        { &m6502_p::SEI, "SEI" }, { &m6502_p::CLV, "CLV" }, { &m6502_p::CLD, "CLD" },
+        { &m6502_p::SED, "SED" },
+    };
+
+    static const struct { u8 (m6502_p::*am)(); u8 mode; u8 length; } modes[] = {
+        { &m6502_p::IMP, DASM_IMP, 1 }, { &m6502_p::IMM, DASM_IMM, 2 },
+        { &m6502_p::ZP0, DASM_ZP0, 2 }, { &m6502_p::ZPX, DASM_ZPX, 2 },
+        { &m6502_p::ZPY, DASM_ZPY, 2 }, { &m6502_p::ZPI, DASM_ZPI, 2 },
+        { &m6502_p::ABS, DASM_ABS, 3 }, { &m6502_p::ABX, DASM_ABX, 3 },
+        { &m6502_p::ABY, DASM_ABY, 3 }, { &m6502_p::IND, DASM_IND, 3 },
+        { &m6502_p::IZX, DASM_IZX, 2 }, { &m6502_p::IZY, DASM_IZY, 2 },
+        { &m6502_p::IAX, DASM_IAX, 3 }, { &m6502_p::REL, DASM_REL, 2 },
+    };
+
+    for (int op = 0; op < 256; op++) {
+        dasm_entry& e = m_dasm[op];
+        e = dasm_entry();
+        if (lookup[op].operate == &m6502_p::XXX) continue;
+
+        for (const auto& n : names) {
+            if (lookup[op].operate == n.op) { e.mnemonic = n.name; break; }
+        }
+        for (const auto& m : modes) {
+            if (lookup[op].addrmode == m.am) { e.mode = m.mode; e.length = m.length; break; }
+        }
+
+        // Shifts and INC/DEC in implied mode operate on the accumulator
+        if (e.mode == DASM_IMP &&
+            (lookup[op].operate == &m6502_p::ASL || lookup[op].operate == &m6502_p::LSR ||
+             lookup[op].operate == &m6502_p::ROL || lookup[op].operate == &m6502_p::ROR ||
+             lookup[op].operate == &m6502_p::INC || lookup[op].operate == &m6502_p::DEC)) {
+            e.mode = DASM_ACC;
+        }
+    }
+}
+
+// ============================================================================
+//  Disassemble One Instruction
+// ============================================================================
+int m6502_p::disassemble(u16 pc, const u8* ops, char* buf, size_t size,
+                         const symbol_table* symbols) const {
+    const dasm_entry& e = m_dasm[ops[0]];
+    const u8  b1 = (e.length > 1) ? ops[1] : 0;
+    const u16 w  = (e.length > 2) ? (u16)(ops[1] | (ops[2] << 8)) : b1;
+
+    // 16-bit operand text: label if there is one, else $XXXX
+    char addr[40] = "";
+    if (e.length == 3 || e.mode == DASM_REL) {
+        u16 target = (e.mode == DASM_REL) ? (u16)(pc + 2 + (s8)b1) : w;   // Branch: next PC + offset
+        const symbol_table::symbol* sym = symbols ? symbols->exact(target) : nullptr;
+        if (sym) std::snprintf(addr, sizeof(addr), "%s", sym->name.c_str());
+        else     std::snprintf(addr, sizeof(addr), "$%04X", target);
+    }
+
+    switch (e.mode) {
+        case DASM_IMP: std::snprintf(buf, size, "%s", e.mnemonic); break;
+        case DASM_ACC: std::snprintf(buf, size, "%s A", e.mnemonic); break;
+        case DASM_IMM: std::snprintf(buf, size, "%s #$%02X", e.mnemonic, b1); break;
+        case DASM_ZP0: std::snprintf(buf, size, "%s $%02X", e.mnemonic, b1); break;
+        case DASM_ZPX: std::snprintf(buf, size, "%s $%02X,X", e.mnemonic, b1); break;
+        case DASM_ZPY: std::snprintf(buf, size, "%s $%02X,Y", e.mnemonic, b1); break;
+        case DASM_ZPI: std::snprintf(buf, size, "%s ($%02X)", e.mnemonic, b1); break;
+        case DASM_ABS: std::snprintf(buf, size, "%s %s", e.mnemonic, addr); break;
+        case DASM_ABX: std::snprintf(buf, size, "%s %s,X", e.mnemonic, addr); break;
+        case DASM_ABY: std::snprintf(buf, size, "%s %s,Y", e.mnemonic, addr); break;
+        case DASM_IND: std::snprintf(buf, size, "%s (%s)", e.mnemonic, addr); break;
+        case DASM_IZX: std::snprintf(buf, size, "%s ($%02X,X)", e.mnemonic, b1); break;
+        case DASM_IZY: std::snprintf(buf, size, "%s ($%02X),Y", e.mnemonic, b1); break;
+        case DASM_IAX: std::snprintf(buf, size, "%s (%s,X)", e.mnemonic, addr); break;
+        case DASM_REL: std::snprintf(buf, size, "%s %s", e.mnemonic, addr); break;
+    }
+    return e.length;
+}
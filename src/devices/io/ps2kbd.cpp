@@ -0,0 +1,97 @@
+#include "ps2kbd.h"
+
+// ============================================================================
+//  Constructor & Clock
+// ============================================================================
+ps2_keyboard::ps2_keyboard() {
+    m_ready.set(true);          // Clock line idle: the interface output sits high
+}
+
+void ps2_keyboard::set_clock(u32 cpu_hz) {
+    m_bit_cycles = cpu_hz / CLOCK_HZ;
+    if (m_bit_cycles == 0) m_bit_cycles = 1;
+}
+
+// ============================================================================
+//  Scancode Set 2
+// ============================================================================
+int ps2_keyboard::encode(u16 key, bool down, u8 out[3]) {
+    int n = 0;
+    if (key & EXTENDED) out[n++] = 0xE0;
+    if (!down) out[n++] = 0xF0;
+    out[n++] = (u8)key;
+    return n;
+}
+
+bool ps2_keyboard::key_for_char(char c, u16& key, bool& shift) {
+    // Unshifted / shifted character per key, US layout
+    static const struct { u8 code; char plain, shifted; } keys[] = {
+        { 0x1C, 'a', 'A' }, { 0x32, 'b', 'B' }, { 0x21, 'c', 'C' }, { 0x23, 'd', 'D' },
+        { 0x24, 'e', 'E' }, { 0x2B, 'f', 'F' }, { 0x34, 'g', 'G' }, { 0x33, 'h', 'H' },
+        { 0x43, 'i', 'I' }, { 0x3B, 'j', 'J' }, { 0x42, 'k', 'K' }, { 0x4B, 'l', 'L' },
+        { 0x3A, 'm', 'M' }, { 0x31, 'n', 'N' }, { 0x44, 'o', 'O' }, { 0x4D, 'p', 'P' },
+        { 0x15, 'q', 'Q' }, { 0x2D, 'r', 'R' }, { 0x1B, 's', 'S' }, { 0x2C, 't', 'T' },
+        { 0x3C, 'u', 'U' }, { 0x2A, 'v', 'V' }, { 0x1D, 'w', 'W' }, { 0x22, 'x', 'X' },
+        { 0x35, 'y', 'Y' }, { 0x1A, 'z', 'Z' },
+        { 0x45, '0', ')' }, { 0x16, '1', '!' }, { 0x1E, '2', '@' }, { 0x26, '3', '#' },
+        { 0x25, '4', '$' }, { 0x2E, '5', '%' }, { 0x36, '6', '^' }, { 0x3D, '7', '&' },
+        { 0x3E, '8', '*' }, { 0x46, '9', '(' },
+        { 0x0E, '`', '~' }, { 0x4E, '-', '_' }, { 0x55, '=', '+' }, { 0x54, '[', '{' },
+        { 0x5B, ']', '}' }, { 0x5D, '\\', '|' }, { 0x4C, ';', ':' }, { 0x52, '\'', '"' },
+        { 0x41, ',', '<' }, { 0x49, '.', '>' }, { 0x4A, '/', '?' },
+        { KEY_SPACE, ' ', 0 }, { KEY_ENTER, '\n', '\r' }, { KEY_TAB, '\t', 0 },
+        { KEY_BACKSPACE, '\b', 0 }, { KEY_ESC, 0x1B, 0 },
+    };
+
+    for (const auto& k : keys) {
+        if (c == k.plain) { key = k.code; shift = false; return true; }
+        if (c == k.shifted && k.shifted) {
+            key = k.code;
+            shift = (k.code != KEY_ENTER);     // CR is Enter too
+            return true;
+        }
+    }
+    return false;
+}
+
+// ============================================================================
+//  Host Side
+// ============================================================================
+bool ps2_keyboard::queue(u8 byte, u64 now) {
+    if (m_count == QUEUE_SIZE) return false;
+    m_queue[(m_head + m_count) % QUEUE_SIZE] = byte;
+    m_count++;
+
+    // Line idle: the frame starts now (or once the inter-byte gap is over)
+    if (!m_sending && m_event == IDLE) m_event = (now > m_line_free) ? now : m_line_free;
+    return true;
+}
+
+// ============================================================================
+//  Frame Timing
+// ============================================================================
+//  Each step is timed from the cycle it was due on, not the (possibly
+//  later) cycle it was applied on, so a busy board can't stretch frames.
+// ============================================================================
+void ps2_keyboard::update(u64 now) {
+    while (m_event <= now) {
+        const u64 t = m_event;
+        if (!m_sending) {
+            // Start bit: the clock starts toggling and pulls CA1 low
+            m_byte = m_queue[m_head];
+            m_head = (m_head + 1) % QUEUE_SIZE;
+            m_count--;
+            m_sending = true;
+            m_ready.set(false);
+            m_event = t + (u64)(FRAME_BITS + SETTLE_BITS) * m_bit_cycles;
+        } else {
+            // Clock idle again: byte on the port, CA1 rises
+            m_sending = false;
+            m_sent++;
+            m_data.set(m_byte);
+            m_ready.set(true);
+            m_line_free = t + (u64)GAP_BITS * m_bit_cycles;
+            m_event = m_count ? m_line_free : IDLE;
+        }
+    }
+}
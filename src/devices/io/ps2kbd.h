@@ -0,0 +1,91 @@
+#pragma once
+#include "../../emu/signal.h"
+#include "../../emu/types.h"
+
+// ============================================================================
+//  Device: PS/2 Keyboard (with the shift-register interface)
+// ============================================================================
+//  WHO:  The keyboard on Ben Eater's later builds, plugged into a small
+//        serial-to-parallel interface: the finished scancode sits on VIA
+//        port A and CA1 rises to interrupt the CPU.
+//  WHAT: Queues scancode set 2 bytes and sends them one frame at a time,
+//        timed on the CPU clock.
+//  WHY:  Firmware expects bytes spaced the way a keyboard sends them (an
+//        11-bit frame at ~12.5 kHz, about a millisecond per byte). A whole
+//        sequence such as E0 F0 75 handed over at once would overrun its
+//        interrupt handler.
+//  HOW:  No per-cycle work. next_event() is the cycle of the next line
+//        change and update() applies everything due by 'now'; the board
+//        treats that cycle as a slice end.
+//        Frame: while the keyboard clocks bits in, the interface holds CA1
+//        low. One bit time after the stop bit the clock line has gone idle:
+//        the byte is on PA0-PA7 and CA1 rises. (PA shows the byte only once
+//        complete; the intermediate shift states aren't modeled.)
+// ============================================================================
+class ps2_keyboard {
+public:
+    static constexpr u64 IDLE = ~0ull;
+
+    // --- Timing (in PS/2 clock periods) ---
+    static constexpr u32 CLOCK_HZ = 12500;      // Keyboards use 10-16.7 kHz
+    static constexpr u32 FRAME_BITS = 11;       // Start, 8 data (LSB first), parity, stop
+    static constexpr u32 SETTLE_BITS = 1;       // Clock idle -> CA1 high
+    static constexpr u32 GAP_BITS = 4;          // Pause before the next byte
+
+    static constexpr int QUEUE_SIZE = 16;       // The keyboard's own buffer
+
+    // --- Key Codes ---
+    // Set 2 make code; EXTENDED marks the E0-prefixed keys.
+    static constexpr u16 EXTENDED = 0x100;
+    enum : u16 {
+        KEY_LSHIFT = 0x12, KEY_RSHIFT = 0x59, KEY_LCTRL = 0x14, KEY_LALT = 0x11,
+        KEY_ENTER = 0x5A, KEY_BACKSPACE = 0x66, KEY_TAB = 0x0D, KEY_ESC = 0x76,
+        KEY_SPACE = 0x29, KEY_CAPS = 0x58,
+        KEY_UP = EXTENDED | 0x75, KEY_DOWN = EXTENDED | 0x72,
+        KEY_LEFT = EXTENDED | 0x6B, KEY_RIGHT = EXTENDED | 0x74,
+    };
+
+    ps2_keyboard();
+
+    void set_clock(u32 cpu_hz);
+
+    // WHAT: The bytes a key sends going down (make) or up (break):
+    //       [E0] code, or [E0] F0 code. Returns the count (1-3).
+    static int encode(u16 key, bool down, u8 out[3]);
+
+    // WHAT: The key that types 'c' on a US layout, and whether it needs
+    //       Shift. False for characters with no key.
+    static bool key_for_char(char c, u16& key, bool& shift);
+
+    // --- Host Side ---
+    // WHAT: Appends a byte to the keyboard's buffer. False when full (the
+    //       caller checks space() first so a sequence is never split).
+    bool queue(u8 byte, u64 now);
+    int  space() const { return QUEUE_SIZE - m_count; }
+    bool idle() const  { return m_count == 0 && !m_sending; }
+
+    // --- Board Side ---
+    u64  next_event() const { return m_event; }
+    void update(u64 now);
+
+    output_port& data()  { return m_data; }     // PA0-PA7: the last complete byte
+    output_line& ready() { return m_ready; }    // CA1: low while a frame is in flight
+
+    u8  last_byte() const { return m_data.value(); }
+    u64 bytes_sent() const { return m_sent; }
+
+private:
+    u8   m_queue[QUEUE_SIZE] = {};
+    int  m_head = 0;
+    int  m_count = 0;
+
+    bool m_sending = false;
+    u8   m_byte = 0;                // Byte in flight
+    u64  m_event = IDLE;            // Next line change
+    u64  m_line_free = 0;           // Earliest start of the next frame
+    u32  m_bit_cycles = 80;         // One PS/2 clock period in CPU cycles
+    u64  m_sent = 0;
+
+    output_port m_data;
+    output_line m_ready;
+};
@@ -0,0 +1,72 @@
+#include "spi.h"
+
+// ============================================================================
+//  Devices & Chip Selects
+// ============================================================================
+bool spi_bus::attach(spi_device* dev, u8 cs) {
+    // The slot already on that pin, else a free one
+    slot* target = nullptr;
+    for (auto& s : m_slots) if (s.dev && s.cs == cs) target = &s;
+    if (!target) for (auto& s : m_slots) if (!s.dev) { target = &s; break; }
+    if (!target) return false;
+
+    if (target->dev && target->dev == m_selected) {
+        m_selected->select(false);
+        m_selected = nullptr;
+    }
+    target->dev = dev;
+    target->cs = dev ? cs : 0;
+    reselect(m_pins);
+    return true;
+}
+
+void spi_bus::reselect(u8 value) {
+    spi_device* sel = nullptr;
+    for (const auto& s : m_slots) {
+        if (s.dev && !(value & s.cs)) { sel = s.dev; break; }
+    }
+    if (sel == m_selected) return;
+
+    if (m_selected) m_selected->select(false);
+    m_selected = sel;
+    // A new frame: any partial byte is dropped
+    m_bit = 0;
+    m_rx = 0;
+    m_tx = 0xFF;
+    m_miso_level = true;
+    if (m_selected) m_selected->select(true);
+}
+
+// ============================================================================
+//  Pin Decoding
+// ============================================================================
+void spi_bus::port_write(u8 value) {
+    const u8 changed = value ^ m_pins;
+    m_pins = value;
+    if (!changed) return;
+
+    // Chip selects first: a CS and SCK change in one write count as select-then-clock
+    for (const auto& s : m_slots) {
+        if (s.dev && (changed & s.cs)) { reselect(value); break; }
+    }
+    if (!(changed & m_sck) || !m_selected) return;
+
+    if (value & m_sck) {
+        // Rising edge: sample MOSI; the eighth completes the byte
+        m_rx = (u8)((m_rx << 1) | ((value & m_mosi) ? 1 : 0));
+        if (++m_bit == 8) {
+            m_bit = 0;
+            m_bytes++;
+            m_tx = m_selected->transfer(m_rx);
+            m_rx = 0;
+        }
+    } else {
+        // Falling edge: the device shifts its next bit out
+        m_miso_level = (m_tx >> (7 - m_bit)) & 1;
+    }
+}
+
+u8 spi_bus::read_pins(u8 pins) const {
+    const bool level = m_selected ? m_miso_level : true;
+    return level ? (u8)(pins | m_miso) : (u8)(pins & ~m_miso);
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "../../emu/types.h"
+
+// ============================================================================
+//  spi_device (Anything on the SPI Bus)
+// ============================================================================
+//  WHAT: A peripheral seen a whole byte at a time.
+//  HOW:  transfer() gets the byte the host just shifted out (MOSI) and
+//        returns the byte the device shifts out during the NEXT transfer
+//        (MISO is full duplex: the first bit must be on the wire before the
+//        host's first clock edge). After select(true) that is 0xFF.
+// ============================================================================
+class spi_device {
+public:
+    virtual ~spi_device() = default;
+    virtual void select(bool selected) = 0;
+    virtual u8   transfer(u8 mosi) = 0;
+};
+
+// ============================================================================
+//  spi_bus (Bit-Banged SPI on a VIA Port)
+// ============================================================================
+//  WHO:  The driver feeds it every write that changes the port's output pins
+//        and lets it fill in MISO when the CPU reads the port.
+//  WHAT: SPI mode 0 (clock idles low, sample on the rising edge, shift on
+//        the falling edge), MSB first, with one chip select per device.
+//  WHY:  Firmware toggles SCK twice per bit. Decoding that here and handing
+//        devices complete bytes keeps the per-edge work to a shift, and
+//        devices never see pins at all.
+//  HOW:  port_write() looks only at the pins that changed. MISO isn't driven
+//        into the VIA per bit: read_pins() computes it from the byte in
+//        flight when the port is actually read.
+// ============================================================================
+class spi_bus {
+public:
+    static constexpr int MAX_DEVICES = 4;
+
+    // WHAT: Pin assignment on the port (bit masks).
+    void set_pins(u8 sck, u8 mosi, u8 miso) { m_sck = sck; m_mosi = mosi; m_miso = miso; }
+
+    // WHAT: Puts 'dev' on the bus, selected while the 'cs' pin is low.
+    //       nullptr removes whatever was on that pin. False if all
+    //       MAX_DEVICES selects are taken.
+    bool attach(spi_device* dev, u8 cs);
+
+    // WHAT: New output pin levels (the port's value after a write).
+    void port_write(u8 value);
+
+    // WHAT: 'pins' with MISO set to what the selected device drives (high
+    //       when nobody is selected: the line is pulled up).
+    u8 read_pins(u8 pins) const;
+
+    u64 bytes_transferred() const { return m_bytes; }
+
+private:
+    struct slot { spi_device* dev = nullptr; u8 cs = 0; };
+    slot m_slots[MAX_DEVICES];
+
+    u8 m_sck = 0x01, m_mosi = 0x02, m_miso = 0x80;
+    u8 m_pins = 0xFF;           // Last output levels seen
+    spi_device* m_selected = nullptr;
+
+    u8  m_rx = 0;               // Bits sampled from MOSI in this byte
+    u8  m_tx = 0xFF;            // Byte the device is shifting out
+    int m_bit = 0;              // Rising edges in this byte (0-7)
+    bool m_miso_level = true;   // Bit currently on MISO
+    u64 m_bytes = 0;
+
+    void reselect(u8 value);
+};
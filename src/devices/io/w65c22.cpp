@@ -23,8 +23,6 @@ void w65c22::reset() {
     std::memset(m_regs, 0x00, 16);
     m_in_a = 0xFF;
     m_in_b = 0xFF;
-    m_out_a = 0;
-    m_out_b = 0;
     m_latch_a = 0;
     m_latch_b = 0;
 
@@ -50,13 +48,20 @@ void w65c22::reset() {
     m_t2_latch = 0xFFFF;
     m_t2_active = false;
 
-    // Shift Register
+    // Shift Register (ACR cleared: disabled, CB1 released high)
     m_regs[SR] = 0;
     m_sr_count = 0;
     m_sr_running = false;
-    m_cb2_lvl = 0;
+    m_sr_clocked = false;
+    m_sr_timer = 0;
+    m_cb1_out = true;
 
     m_regs[IER] = 0x00; // Disable all interrupts
+
+    // Drive the pins to their reset levels (ports read as 0, CA2/CB2 high)
+    update_outputs();
+    update_control_outputs();
+    m_cb1.set(m_cb1_out);
 }
 
 // ============================================================================
@@ -120,46 +125,82 @@ void w65c22::clock() {
         }
     }
 
-    // --- Shift Register (for now simplified) ---
-    // In real hardware shifts based on T2 or Phi2.
-    // Implement a simple placeholder logic for "Shift Out on Phi2"
-    // ACR Bits 2-4 control SR mode.
-    u8 sr_mode = (m_regs[ACR] >> 2) & 0x07;
-    bool trigger_shift = false;// Modes 1, 2, 5, 6 use internal clocks (T2 or PHI2)
-
-    // Mode 2 (Shift In) & 6 (Shift Out) use PHI2 rate
-    if (m_sr_running) {
-        if (sr_mode == 2 || sr_mode == 6){
-            trigger_shift = true;
-        }
-        // Mode 1 (Shift In) & 5 (Shift Out) use Timer 2 rate
-        else if ((sr_mode == 1 || sr_mode == 5) && m_t2_counter == 0){
-            trigger_shift = true;
-        }
+    // --- Shift Register ---
+    // Internally clocked modes only; CB1-clocked modes shift in set_cb1
+    if (m_sr_clocked && --m_sr_timer == 0) sr_tick();
+}
+
+// ============================================================================
+//  Shift Register
+// ============================================================================
+u16 w65c22::sr_half_period() const {
+    const u8 mode = sr_mode();
+    if (mode == 2 || mode == 6) return 1;               // PHI2 rate
+    return (u16)((m_t2_latch & 0xFF) + 2);              // T2 low latch: N + 2
+}
+
+void w65c22::sr_start() {
+    m_regs[IFR] &= ~INT_SR;
+    m_sr_count = 0;
+    const u8 mode = sr_mode();
+    m_sr_running = sr_internal(mode);
+    if (m_sr_running && !m_sr_clocked) {
+        // Clock starts from idle (a restart mid-byte keeps its phase)
+        m_sr_clocked = true;
+        m_sr_timer = sr_half_period();
     }
-    if (trigger_shift) {
-        // Shift Out (Modes 4, 5, 6, 7) - MSB goes to CB2
-        if (sr_mode & 0x04) {
-            m_cb2_out = (m_regs[SR] & 0x80) ? true : false;
-            m_regs[SR] = (m_regs[SR] << 1) | (m_regs[SR] >> 7); // Rotate
+    update_irq();
+}
+
+void w65c22::sr_mode_changed() {
+    const u8 mode = sr_mode();
+    if (!sr_internal(mode)) {
+        // CB1 becomes an input again (or the SR is off): stop the clock
+        m_sr_running = false;
+        m_sr_clocked = false;
+        m_cb1_out = true;
+        m_cb1.set(true);
+    } else if (m_sr_running && !m_sr_clocked) {
+        m_sr_clocked = true;
+        m_sr_timer = sr_half_period();
+    }
+}
+
+void w65c22::sr_tick() {
+    m_cb1_out = !m_cb1_out;
+    m_cb1.set(m_cb1_out);
+    sr_edge(m_cb1_out);
+    if (m_sr_clocked) m_sr_timer = sr_half_period();
+}
+
+void w65c22::sr_edge(bool rising) {
+    const u8 mode = sr_mode();
+
+    if (!rising) {
+        // Shift out: MSB to CB2, rotated into bit 0
+        if (mode & 0x04) {
+            const u8 sr = m_regs[SR];
+            m_cb2_out = (sr & 0x80) != 0;
+            m_regs[SR] = (u8)((sr << 1) | (sr >> 7));
             update_control_outputs();
         }
-        // Shift In (Modes 0, 1, 2, 3) - CB2 goes to LSB
-        else {
-            u8 bit = m_cb2_in_state ? 1 : 0;
-            m_regs[SR] = (m_regs[SR] << 1) | bit;
-        }
+        return;
+    }
 
-        m_sr_count++;
-        if (m_sr_count >= 8) {
-            // Mode 2 & 6 stop after 8 bits. Mode 000 disables.
-            if (sr_mode != 0) {
-                m_regs[IFR] |= INT_SR;
-                m_sr_running = false; // Stop
-                update_irq();
-            }
-        }
+    // Shift in: CB2 sampled into bit 0
+    if (!(mode & 0x04)) m_regs[SR] = (u8)((m_regs[SR] << 1) | (m_cb2_in_state ? 1 : 0));
+
+    if (++m_sr_count < 8) return;
+    m_sr_count = 0;
+    if (mode == 4) return;                              // Free-running: no flag, no stop
+
+    m_regs[IFR] |= INT_SR;
+    if (sr_internal(mode)) {
+        // Byte done: CB1 is back high, the clock stops
+        m_sr_running = false;
+        m_sr_clocked = false;
     }
+    update_irq();
 }
 
 // ============================================================================
@@ -167,11 +208,7 @@ void w65c22::clock() {
 // ============================================================================
 void w65c22::update_outputs() {
     // 1. Calculate Port A
-    u8 new_out_a = m_regs[ORA] & m_regs[DDRA];
-    if (m_port_a_cb) {
-        m_port_a_cb(new_out_a);
-    }
-    m_out_a = new_out_a;
+    m_port_a.set(m_regs[ORA] & m_regs[DDRA]);
 
     // Port B Calculation
     // Get the standad GPIO output (ORB masked by DDRB)
@@ -188,14 +225,13 @@ void w65c22::update_outputs() {
         }
     }
 
-    if (m_port_b_cb) m_port_b_cb(standard_out);
-    m_out_b = standard_out;
+    m_port_b.set(standard_out);
 }
 
 void w65c22::update_control_outputs() {
-    // Notify external devices of CA2/CB2 state changes
-    if (m_ca2_cb) m_ca2_cb(m_ca2_out);
-    if (m_cb2_cb) m_cb2_cb(m_cb2_out);
+    // Listeners only hear about lines that actually changed
+    m_ca2.set(m_ca2_out);
+    m_cb2.set(m_cb2_out);
 }
 
 void w65c22::update_irq() {
@@ -266,15 +302,19 @@ void w65c22::set_cb1(bool signal) {
         }
         update_irq();
     }
-    // Note: External Shift Clock logic would attach here for Modes 3 & 7
+
+    // External shift clock (modes 3 & 7): every edge, regardless of PCR
+    const u8 mode = sr_mode();
+    if ((mode == 3 || mode == 7) && old_signal != signal) sr_edge(signal);
 }
 
 void w65c22::set_cb2_input(bool signal) {
-    // CB2 is only an input if PCR Bits 7-5 are 0xx (000, 001, 010, 011)
-    if (m_regs[PCR] & 0x80) return; // Exit if in Output mode
-
+    // The SR samples CB2 in modes 1-3 whatever the PCR says
     bool old_signal = m_cb2_in_state;
     m_cb2_in_state = signal;
+
+    // CB2 is only an interrupt input if PCR Bits 7-5 are 0xx (000, 001, 010, 011)
+    if (m_regs[PCR] & 0x80) return; // Exit if in Output mode
     
     // PCR Bit 6 controls CB2 Active Edge (when in input mode)
     bool active_edge = (m_regs[PCR] & 0x40) ? (!old_signal && signal) : (old_signal && !signal);
@@ -324,13 +364,19 @@ u8 w65c22::read(u16 addr) {
             [[fallthrough]];
         }
         case ORA_NH:{
-            val = (m_regs[ACR] & 0x01) ? m_latch_a : (m_in_a & ~m_regs[DDRA]) | (m_regs[ORA] & m_regs[DDRA]);
+            if (m_regs[ACR] & 0x01) {
+                val = m_latch_a;
+            } else {
+                u8 pins = m_port_a_read_cb ? m_port_a_read_cb(m_in_a) : m_in_a;
+                val = (pins & ~m_regs[DDRA]) | (m_regs[ORA] & m_regs[DDRA]);
+            }
             break;
         }
         case ORB: {// Read Port B
             m_regs[IFR] &= ~0x18; // Clear CB1/CB2 flags
             update_irq();
-            val = (m_regs[ORB] & m_regs[DDRB]) | (m_in_b & ~m_regs[DDRB]);
+            u8 pins = m_port_b_read_cb ? m_port_b_read_cb(m_in_b) : m_in_b;
+            val = (m_regs[ORB] & m_regs[DDRB]) | (pins & ~m_regs[DDRB]);
             break;
         }
         // Timer 1   
@@ -361,11 +407,7 @@ u8 w65c22::read(u16 addr) {
         // Shift Register
         case SR: {
             val = m_regs[SR];
-            m_regs[IFR] &= ~INT_SR;     // Clear SR Interrupt
-            // Reading SR triggers shifting if in appropriate mode
-            m_sr_running = true; 
-            m_sr_count = 0;
-            update_irq();
+            sr_start();                 // Clears IFR2; shift-in modes fetch the next byte
             break;
         }
 
@@ -406,8 +448,8 @@ void w65c22::write(u16 addr, u8 data) {
             update_outputs();
             m_regs[IFR] &= ~(INT_CB1 | INT_CB2);
             
-            // Write Handshake Logic (CB2)
-            u8 cb2_mode = (m_regs[PCR] >> 5) & 0x07;
+            // Write Handshake Logic (CB2; the SR owns it in shift-out modes)
+            u8 cb2_mode = (sr_mode() & 0x04) ? 0 : (m_regs[PCR] >> 5) & 0x07;
             if (cb2_mode == 4) { // Handshake
                 m_cb2_out = false;    
             } else if (cb2_mode == 5) { // Pulse
@@ -468,11 +510,12 @@ void w65c22::write(u16 addr, u8 data) {
         // Shift Register
         case SR: {
             m_regs[SR] = data;
-            m_regs[IFR] &= ~INT_SR;     // Clear the Interrupt
-            update_irq();
-            // Start shifting 
-            m_sr_running = true;
-            m_sr_count = 0;
+            sr_start();                 // Clears IFR2; shift-out modes send it
+            break;
+        }
+        case ACR: {
+            m_regs[ACR] = data;
+            sr_mode_changed();
             break;
         }
         case IFR: {
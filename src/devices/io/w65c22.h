@@ -1,5 +1,6 @@
 #pragma once
 #include "../../emu/di_memory.h"
+#include "../../emu/signal.h"
 #include <string>
 #include <functional>
 
@@ -25,8 +26,7 @@ public:
 
     // ----- CALLBACKS -----
     using irq_callback = std::function<void(bool)>;     // State: 1 = High/Clear, 0 = Low/Assert
-    using port_callback = std::function<void(u8)>;      // Sends a byte to external device
-    using line_callback = std::function<void(bool)>;    // Control line update (CA2/CB2)
+    using port_read_callback = std::function<u8(u8)>;   // Pin levels at read time (gets the input latch)
 
     // --- HARDWARE INTERFACE ---
     // The CPU calls these to read/write the VIA's internal registers.
@@ -42,20 +42,32 @@ public:
 
     // Function to handle external signal changes on the control lines
     void set_ca1(bool signal);              // CA1 is always input
-    void set_cb1(bool signal);              // CB1 is input (or SR Clock)
-    void set_cb2_input(bool signal);        // CB2 is input only in specific PCR modes
+    void set_cb1(bool signal);              // CB1 is input (or SR Clock in mode 3/7)
+    void set_cb2_input(bool signal);        // CB2 is input in PCR input modes and SR modes 1-3
     void set_pb6_input(bool signal);        // PB6 input for Timer 2 Pulse Counting
 
     // Get Output States
-    u8 get_port_a_output() { return m_out_a; }
-    u8 get_port_b_output() { return m_out_b; }
+    u8 get_port_a_output() { return m_port_a.value(); }
+    u8 get_port_b_output() { return m_port_b.value(); }
+
+    // --- OUTPUT PINS ---
+    // The board connects listeners to these; they run only when a pin
+    // actually changes (see emu/signal.h).
+    output_port& port_a() { return m_port_a; }     // PA0-PA7 (ORA & DDRA)
+    output_port& port_b() { return m_port_b; }     // PB0-PB7 (ORB & DDRB, PB7 from T1)
+    output_line& ca2()    { return m_ca2; }
+    output_line& cb1()    { return m_cb1; }     // SR shift clock in modes 1, 2, 4, 5, 6 (else high)
+    output_line& cb2()    { return m_cb2; }     // PCR output modes, or SR data in modes 4-7
 
     // Setter for the callback
     void set_irq_callback(irq_callback cb) { m_irq_cb = cb;}
-    void set_ca2_callback(line_callback cb) { m_ca2_cb = cb; }
-    void set_cb2_callback(line_callback cb) { m_cb2_cb = cb; }
-    void set_port_a_callback(port_callback cb) { m_port_a_cb = cb; }
-    void set_port_b_callback(port_callback cb) { m_port_b_cb = cb; }
+
+    // WHAT: Asked for the PB pin levels whenever the CPU reads ORB.
+    // WHY:  For devices that drive the bus only while selected (the LCD
+    //       during a read cycle) and whose value depends on the read time.
+    void set_port_b_read_callback(port_read_callback cb) { m_port_b_read_cb = cb; }
+    // Same for PA on unlatched ORA reads (an SPI device's MISO).
+    void set_port_a_read_callback(port_read_callback cb) { m_port_a_read_cb = cb; }
 
     // Required by device interface
     void memory_map(address_map& map) override;
@@ -63,6 +75,26 @@ public:
     // Debugger Helper: Read without side effects
     u8 peek(u16 addr) const { return m_regs[addr & 0x0F]; }
 
+    // ========================================================================
+    //  Shift Register Modes (ACR bits 4-2)
+    // ========================================================================
+    //  0 Disabled              4 Shift out, free-running at T2 rate
+    //  1 Shift in,  T2 rate    5 Shift out, T2 rate
+    //  2 Shift in,  PHI2 rate  6 Shift out, PHI2 rate
+    //  3 Shift in,  CB1 clock  7 Shift out, CB1 clock
+    //
+    //  Internal clocks (1, 2, 4, 5, 6) drive CB1 as the shift clock: it
+    //  idles high, CB2 changes after the falling edge (out, MSB first) and
+    //  is sampled on the rising edge (in, into bit 0). One half period is
+    //  one PHI2 cycle, or T2's low latch + 2 cycles. Modes 1, 2, 5 and 6
+    //  stop with IFR2 set after 8 bits; mode 4 rotates until the mode
+    //  changes. Modes 3 and 7 shift on external CB1 edges and set IFR2 on
+    //  every 8th without stopping. Reading or writing SR (re)starts the
+    //  count in all modes.
+    u8 sr_mode() const { return (m_regs[ACR] >> 2) & 0x07; }
+    u8 sr_bits() const { return m_sr_count; }           // Bits shifted in this byte
+    bool sr_busy() const { return m_sr_clocked; }       // Internal clock running
+
 private:
     // ========================================================================
     //  Internal Registers (The "Memory" of the VIA)
@@ -83,7 +115,7 @@ private:
     // ========================================================================
     //  Port Latches
     // ========================================================================
-    u8 m_in_a, m_in_b, m_out_a, m_out_b;
+    u8 m_in_a, m_in_b;
     u8 m_latch_a, m_latch_b;
 
     // Control Line States
@@ -100,17 +132,35 @@ private:
     bool m_t1_pb7_state;  // Logic state of the PB7 override
 
     // Shift Register State
+    // WHAT: m_sr_timer counts down to the next internal CB1 edge; it is
+    //       only armed (m_sr_clocked) while an internally clocked byte is
+    //       in progress, so an idle or externally clocked SR costs clock()
+    //       a single flag test.
     u8 m_sr_count;          // Bits shifted so far
-    bool m_sr_running;      // Is shifting active?
-    u8 m_cb2_lvl;           // Simulated CB2 output level
+    bool m_sr_running;      // Started by an SR access (internal modes)
+    bool m_sr_clocked;      // Internal shift clock armed
+    u16 m_sr_timer;         // Cycles to the next CB1 edge
+    bool m_cb1_out;         // CB1 level we drive (internal clock modes)
+
+    // Output Pins
+    output_port m_port_a, m_port_b;
+    output_line m_ca2, m_cb1, m_cb2;
 
     // Callbacks
     irq_callback m_irq_cb;
-    line_callback m_ca2_cb, m_cb2_cb;
-    port_callback m_port_a_cb, m_port_b_cb;
+    port_read_callback m_port_a_read_cb;
+    port_read_callback m_port_b_read_cb;
 
     // Helpers
     void update_outputs();          // Update PA/PB pins
     void update_control_outputs();  // Update CA2/CB2 pins
     void update_irq();              // Update IRQ line based on IFR & IER
+
+    // Shift register
+    static bool sr_internal(u8 mode) { return mode == 1 || mode == 2 || mode == 4 || mode == 5 || mode == 6; }
+    u16  sr_half_period() const;    // CB1 half period in PHI2 cycles
+    void sr_start();                // SR read/write
+    void sr_mode_changed();         // ACR write
+    void sr_tick();                 // Internal clock: next CB1 edge
+    void sr_edge(bool rising);      // A CB1 edge (internal or external)
 };
\ No newline at end of file
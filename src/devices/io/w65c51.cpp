@@ -5,7 +5,10 @@
 enum { DATA = 0, STATUS = 1, COMMAND = 2, CONTROL = 3 };
 
 w65c51::w65c51() {
-    m_status_reg = 0x10; // Default: Tx Empty (Bit 4 is Rx Full, 0 initially)
+    m_data_reg = 0x00;
+    m_status_reg = 0x10; // Default: Tx Empty (Bit 3 is Rx Full, 0 initially)
+    m_command_reg = 0x00;
+    m_control_reg = 0x00;
 }
 
 void w65c51::memory_map(address_map& map) {
@@ -18,11 +21,12 @@ void w65c51::memory_map(address_map& map) {
 u8 w65c51::read(u16 addr) {
     switch (addr & 0x03) {
         case DATA:
-            // Reading Data clears Rx Full flag
-            m_status_reg &= ~0x08; // Clear Bit 3 (Rx Full) - W65C51 specific bit pos
+            // Reading Data clears Rx Full flag (and a pending Overrun)
+            m_status_reg &= ~0x0C; // Clear Bit 3 (Rx Full) - W65C51 specific bit pos
             // Note: Older 6551 used Bit 3 for Rx Full, W65C51 might vary. 
             // Standard 6551: Bit 3 = Rx Full, Bit 4 = Tx Empty.
             update_irq();
+            if (m_rx_cb) m_rx_cb();
             return m_rx_buffer;
         
         case STATUS:
@@ -40,14 +44,25 @@ u8 w65c51::read(u16 addr) {
     return 0;
 }
 
+u8 w65c51::peek(u16 addr) const {
+    switch (addr & 0x03) {
+        case DATA:    return m_rx_buffer;
+        case STATUS:  return m_status_reg;
+        case COMMAND: return m_command_reg;
+        case CONTROL: return m_control_reg;
+    }
+    return 0;
+}
+
 void w65c51::write(u16 addr, u8 data) {
     switch (addr & 0x03) {
         case DATA:
             // Writing Data transmits it
-            m_tx_buffer.push(data);
-            // In emulation, Tx is instant. 
-            // Real hardware would clear TxEmpty, wait, then set it.
-            // We just leave TxEmpty (Bit 4) set to 1 (Ready).
+            // TxEmpty (Bit 4) stays clear until the board has sent the byte
+            // on (pop_tx_data).
+            m_tx_data = data;
+            m_status_reg &= ~0x10;
+            if (m_tx_cb) m_tx_cb();
             break;
 
         case STATUS: 
@@ -61,12 +76,43 @@ void w65c51::write(u16 addr, u8 data) {
 }
 
 void w65c51::rx_char(u8 c) {
+    if (m_status_reg & 0x08) {
+        // Previous byte not read yet: Overrun (Bit 2), new byte is lost
+        m_status_reg |= 0x04;
+        return;
+    }
     m_rx_buffer = c;
     m_status_reg |= 0x08; // Set Rx Full (Bit 3)
     m_status_reg |= 0x80; // Set IRQ Flag (Bit 7)
     update_irq();
 }
 
+u8 w65c51::pop_tx_data() {
+    m_status_reg |= 0x10; // Tx Empty again
+
+    // Command Bits 2-3 = 01: Transmit interrupt enabled
+    if ((m_command_reg & 0x0C) == 0x04) {
+        m_status_reg |= 0x80;
+        update_irq();
+    }
+    return m_tx_data;
+}
+
+u32 w65c51::char_cycles(u32 cpu_hz) const {
+    // Baud divisors (x16) of the 1.8432 MHz crystal, by Control bits 0-3:
+    // ext, 50, 75, 109.92, 134.58, 150, 300, 600, 1200, 1800, 2400, 3600,
+    // 4800, 7200, 9600, 19200
+    static const u16 divisors[16] = {
+        1, 2304, 1536, 1047, 856, 768, 384, 192, 96, 64, 48, 32, 24, 16, 12, 6
+    };
+    u32 bits = 1;                                   // Start
+    bits += 8 - ((m_control_reg >> 5) & 0x03);      // Word length
+    bits += (m_command_reg & 0x20) ? 1 : 0;         // Parity
+    bits += (m_control_reg & 0x80) ? 2 : 1;         // Stop bit(s)
+
+    return (u32)((u64)cpu_hz * bits * 16 * divisors[m_control_reg & 0x0F] / 1843200);
+}
+
 void w65c51::update_irq() {
     // If IRQ Flag (Bit 7) is Set AND Command Reg Bit 1 is LOW (IRQ Enabled)
     bool irq_active = (m_status_reg & 0x80) && !(m_command_reg & 0x02);
@@ -1,7 +1,6 @@
 #pragma once
 #include "../../emu/di_memory.h"
 #include <functional>
-#include <queue>
 
 // ============================================================================
 //  Device: W65C51N (ACIA)
@@ -15,28 +14,52 @@ public:
     void write(u16 addr, u8 data);
     void memory_map(address_map& map) override;
 
+    // WHAT: Register value without the read side effects (debugger)
+    u8 peek(u16 addr) const;
+
     // --- Serial Interface (The "MAX232" side) ---
-    // Call this from Main/UI to send keyboard input to the 6502
+    // Call this from Main/UI to send keyboard input to the 6502.
+    // If the previous byte hasn't been read yet, the new one is lost
+    // (Overrun), as on the chip: check rx_full() first.
     void rx_char(u8 c);
-    
-    // Read what the 6502 has transmitted (for the UI console)
-    bool has_tx_data();
+    bool rx_full() const { return m_status_reg & 0x08; }
+
+    // Read what the 6502 has transmitted. The byte stays in the transmit
+    // register (Tx Empty clear) until the board takes it with pop_tx_data(),
+    // so a slow receiver holds the firmware off like a real line would.
+    bool has_tx_data() const { return !(m_status_reg & 0x10); }
     u8 pop_tx_data();
 
+    // WHAT: CPU cycles one character occupies on the line, from the
+    //       programmed baud rate (Control bits 0-3, 1.8432 MHz crystal) and
+    //       frame: start + 5-8 data bits + parity (Command bit 5) + 1-2 stop.
+    //       8N1 at 19200 baud is 10 bit times = 520 cycles at 1 MHz.
+    // NOTE: Rate 0 (16x external clock) has no clock on this board; it is
+    //       treated as 115200 baud.
+    u32 char_cycles(u32 cpu_hz) const;
+
+    // WHAT: Called when the CPU writes the transmit register / reads the
+    //       receive register, so the board can schedule the line.
+    using data_callback = std::function<void()>;
+    void set_tx_callback(data_callback cb) { m_tx_cb = cb; }
+    void set_rx_callback(data_callback cb) { m_rx_cb = cb; }
+
     // --- Interrupts ---
-    using irq_callback = std::function<void(bool state)>;
+    using irq_callback = std::function<void(bool state)>;   // State: true = Assert (/IRQ pulled low)
     void set_irq_callback(irq_callback cb) { m_irq_cb = cb; }
 
 private:
     // Registers
     u8 m_data_reg;
-    u8 m_status_reg;  // Bits: 7=IRQ, 4=RxFull, 1=TxEmpty
+    u8 m_status_reg;  // Bits: 7=IRQ, 4=TxEmpty, 3=RxFull, 2=Overrun
     u8 m_command_reg; // Controls IRQ enables
-    u8 m_control_reg; // Baud rate (ignored in emulation)
+    u8 m_control_reg; // Baud rate & frame format (see char_cycles)
 
-    std::queue<u8> m_tx_buffer; // Outgoing (to PC)
-    u8 m_rx_buffer;             // Incoming (from PC)
+    u8 m_tx_data = 0;           // Outgoing (to PC), valid while Tx Empty is clear
+    u8 m_rx_buffer = 0;         // Incoming (from PC)
 
     irq_callback m_irq_cb;
+    data_callback m_tx_cb;
+    data_callback m_rx_cb;
     void update_irq();
 };
\ No newline at end of file
@@ -10,6 +10,8 @@
 // ============================================================================
 class logic_74hc00 {
 public:
+    static constexpr int GATE_COUNT = 4;    // Gates per package
+
     // ========================================================================
     //  Gate Logic
     // ========================================================================
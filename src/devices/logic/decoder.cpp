@@ -0,0 +1,114 @@
+#include "decoder.h"
+#include <iomanip>
+#include <iostream>
+
+// ============================================================================
+//  Netlist
+// ============================================================================
+int address_decoder::add_package(const std::string& ref) {
+    m_packages.push_back({ ref, 0 });
+    return (int)m_packages.size() - 1;
+}
+
+address_decoder::net address_decoder::nand(int package, net a, net b) {
+    if (package < 0 || package >= (int)m_packages.size()) {
+        std::cerr << "[Decoder] No package " << package << std::endl;
+        m_ok = false;
+        return GND;
+    }
+    if (m_packages[package].used == logic_74hc00::GATE_COUNT) {
+        std::cerr << "[Decoder] " << m_packages[package].ref << " has no free gate." << std::endl;
+        m_ok = false;
+        return GND;
+    }
+    if (!valid(a) || !valid(b)) {
+        std::cerr << "[Decoder] " << m_packages[package].ref << ": input net doesn't exist yet." << std::endl;
+        m_ok = false;
+        return GND;
+    }
+    m_packages[package].used++;
+    m_gates.push_back({ a, b });
+    return FIRST_GATE + (net)m_gates.size() - 1;
+}
+
+void address_decoder::select(int device, const std::string& name, const std::vector<pin>& pins) {
+    for (const pin& p : pins) {
+        if (!valid(p.n)) {
+            std::cerr << "[Decoder] " << name << ": select net doesn't exist." << std::endl;
+            m_ok = false;
+            return;
+        }
+    }
+    m_selects.push_back({ device, name, pins });
+}
+
+// ============================================================================
+//  Compilation
+// ============================================================================
+//  Only the address lines the netlist actually reads matter: below the
+//  lowest one, every address decodes the same, so one evaluation covers
+//  the whole step (on Ben's board, A13-A15: eight evaluations in all).
+// ============================================================================
+u32 address_decoder::address_step() const {
+    u32 used = 0;
+    for (const gate& g : m_gates) {
+        if (g.a < 16) used |= 1u << g.a;
+        if (g.b < 16) used |= 1u << g.b;
+    }
+    for (const chip_select& cs : m_selects) {
+        for (const pin& p : cs.pins) if (p.n < 16) used |= 1u << p.n;
+    }
+    return used ? (used & (0u - used)) : 0x10000;     // Lowest line read
+}
+
+bool address_decoder::compile() {
+    m_ranges.clear();
+    if (!m_ok) {
+        std::cerr << "[Decoder] Netlist has errors; nothing is mapped." << std::endl;
+        return false;
+    }
+
+    std::vector<u8> level(FIRST_GATE + m_gates.size(), 0);
+    level[GND]  = 0;
+    level[VCC]  = 1;
+    level[PHI2] = 1;
+
+    const u32 step = address_step();
+    bool contention = false;
+    int  current = NONE;
+    u32  run_start = 0;
+
+    for (u32 addr = 0; addr <= 0x10000; addr += step) {
+        int owner = NONE;
+        if (addr < 0x10000) {
+            for (int b = 0; b < 16; b++) level[b] = (addr >> b) & 1;
+            for (size_t g = 0; g < m_gates.size(); g++) {
+                level[FIRST_GATE + g] = logic_74hc00::nand(level[m_gates[g].a], level[m_gates[g].b]);
+            }
+
+            const chip_select* first = nullptr;
+            for (const chip_select& cs : m_selects) {
+                bool active = true;
+                for (const pin& p : cs.pins) {
+                    if ((level[p.n] != 0) != p.active_high) { active = false; break; }
+                }
+                if (!active) continue;
+                if (!first) {
+                    first = &cs;
+                    owner = cs.device;
+                } else if (!contention) {
+                    std::cerr << "[Decoder] Bus contention at $" << std::hex << std::uppercase << std::setw(4)
+                              << std::setfill('0') << addr << std::dec << ": " << first->name << " and "
+                              << cs.name << " are both selected." << std::endl;
+                    contention = true;
+                }
+            }
+        }
+        if (addr == 0x10000 || owner != current) {
+            if (addr > 0) m_ranges.push_back({ (u16)run_start, (u16)(addr - 1), current });
+            current = owner;
+            run_start = addr;
+        }
+    }
+    return true;
+}
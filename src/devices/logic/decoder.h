@@ -0,0 +1,69 @@
+#pragma once
+#include "74hc00.h"
+#include <string>
+#include <vector>
+
+// ============================================================================
+//  Address Decoder (74HC00 Netlist -> Flat Table)
+// ============================================================================
+//  WHO:  mb_driver::map_setup describes each schematic's glue logic with it
+//        and installs the result into that schematic's address_map.
+//  WHAT: A netlist of 74HC00 NAND gates fed by the address lines, and the
+//        chip-select pins of each device. compile() evaluates it across the
+//        address space and lists which device answers each range.
+//  WHY:  The decode is the schematic's wiring instead of hand-written
+//        address compares. Another gate arrangement or an extra chip is a
+//        few more lines of netlist, and still costs nothing per access.
+//  HOW:  A gate can only take nets that already exist, so the order gates
+//        were added in is an evaluation order. PHI2 is held high: the table
+//        describes the data phase of a cycle.
+// ============================================================================
+class address_decoder {
+public:
+    using net = int;
+
+    // Fixed nets: A0-A15 are 0-15
+    static constexpr net A(int bit) { return bit; }
+    static constexpr net GND  = 16;
+    static constexpr net VCC  = 17;
+    static constexpr net PHI2 = 18;
+
+    static constexpr int NONE = -1;     // No device selected (open bus)
+
+    // A chip-select pin: the device needs net 'n' at this level.
+    struct pin { net n; bool active_high; };
+    // A run of addresses answered by one device (or NONE).
+    struct range { u16 start, end; int device; };
+
+    // WHAT: Adds a 74HC00 package ('ref' is its schematic label, e.g. "U4").
+    int add_package(const std::string& ref);
+
+    // WHAT: Wires the next free gate of 'package'; returns its output net.
+    //       A bad net or a full package is reported and fails compile().
+    net nand(int package, net a, net b);
+
+    // WHAT: 'device' is selected while every pin is at its active level.
+    void select(int device, const std::string& name, const std::vector<pin>& pins);
+
+    // WHAT: Evaluates the netlist and builds ranges(). False (with a console
+    //       message) if the netlist is broken. Two devices selected at once
+    //       is reported; the one whose select() came first gets the bus.
+    bool compile();
+    const std::vector<range>& ranges() const { return m_ranges; }
+
+private:
+    static constexpr net FIRST_GATE = 19;   // Gate i drives net FIRST_GATE + i
+
+    struct gate { net a, b; };
+    struct package { std::string ref; int used = 0; };
+    struct chip_select { int device; std::string name; std::vector<pin> pins; };
+
+    std::vector<package> m_packages;
+    std::vector<gate> m_gates;
+    std::vector<chip_select> m_selects;
+    std::vector<range> m_ranges;
+    bool m_ok = true;
+
+    bool valid(net n) const { return n >= 0 && n < FIRST_GATE + (net)m_gates.size(); }
+    u32  address_step() const;
+};
@@ -24,6 +24,7 @@ void eeprom_28c256::reset_memory() {
     // Fill the array with 0xFF.
     // WHY: In an electrically erased state, all bits are 1.
     memset(m_data, 0xFF, sizeof(m_data));
+    touch_all();
 }
 
 // ============================================================================
@@ -64,6 +65,7 @@ bool eeprom_28c256::load_from_file(const std::string& filename) {
         size = 32768;
     }
 
+    touch_all(); // Even a short read may have changed the array
     if (file.read((char*)m_data, size)) {
         std::cout << "[ROM] Successfully loaded " << size << " bytes." << std::endl;
         return true;
@@ -73,6 +75,18 @@ bool eeprom_28c256::load_from_file(const std::string& filename) {
     return false;
 }
 
+// ============================================================================
+//  Load Image
+// ============================================================================
+//  WHAT: Copies a ROM image from memory into the array (truncated to 32KB).
+// ============================================================================
+void eeprom_28c256::load_image(const u8* data, size_t len) {
+    if (!data) return;
+    if (len > sizeof(m_data)) len = sizeof(m_data);
+    memcpy(m_data, data, len);
+    touch_all();
+}
+
 // ============================================================================
 //  Read Byte
 // ============================================================================
@@ -95,7 +109,11 @@ u8 eeprom_28c256::read(u16 addr) {
 // ============================================================================
 void eeprom_28c256::write(u16 addr, u8 data) {
     // Mask to 15 bits and write.
-    m_data[addr & 0x7FFF] = data;
+    u8& cell = m_data[addr & 0x7FFF];
+    if (cell != data) {
+        cell = data;
+        m_page_gen[(addr & 0x7FFF) >> 8]++;
+    }
 }
 
 // ============================================================================
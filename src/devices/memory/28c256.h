@@ -18,10 +18,17 @@ class eeprom_28c256 : public device_memory_interface {
         // --- INTERFACE ---
         // Load a binary file from disk into the chip's memory array
         bool load_from_file(const std::string& filename);
+
+        // Load an image already in memory (e.g. carried by the input journal)
+        void load_image(const u8* data, size_t len);
         
         // Direct pointer access (useful for debuggers/visualizers)
         u8* get_data_ptr() { return m_data; }
 
+        // WHAT: Change counter for one 256-byte page (0-127).
+        // WHY:  Bumped by loads and writes so debugger caches can invalidate.
+        u32 page_generation(u8 page) const { return m_page_gen[page & 0x7F]; }
+
         // --- HARDWARE SIGNALS ---
         // Standard Read/Write interface required by the memory map
         u8 read(u16 addr);
@@ -36,5 +43,7 @@ class eeprom_28c256 : public device_memory_interface {
         // WHY:  Avoids std::vector dynamic allocation. Matches physical capacity exactly.
         u8 m_data[32768];
 
-        
+        // WHAT: One change counter per 256-byte page.
+        u32 m_page_gen[128] = {};
+        void touch_all() { for (auto& g : m_page_gen) g++; }
 };
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "62256.h"
 #include "../../emu/map.h"
+#include <algorithm>
 
 // ============================================================================
 //  Constructor
@@ -18,6 +19,9 @@ void ram_62256::reset_memory() {
     // Fill with 0 (Clean state)
     // Optional: Fill with 0xCC or random data to detect uninitialized variable bugs.
     memset(m_data, 0x00, sizeof(m_data));
+    for (auto& g : m_page_gen) g++;
+    m_dirty[0] = m_dirty[1] = ~0ull;
+    if (!m_write_cycle.empty()) std::fill(m_write_cycle.begin(), m_write_cycle.end(), 0);
 }
 
 // ============================================================================
@@ -32,8 +36,35 @@ u8 ram_62256::read(u16 addr) {
 //  Write Byte
 // ============================================================================
 void ram_62256::write(u16 addr, u8 data) {
-    // Write to array
-    m_data[addr & 0x7FFF] = data;
+    // Write to array (and note the change for the debugger's caches)
+    addr &= 0x7FFF;
+    u8& cell = m_data[addr];
+    if (cell != data) {
+        cell = data;
+        const u8 page = (u8)(addr >> 8);
+        m_page_gen[page]++;
+        m_generation++;
+        m_dirty[page >> 6] |= 1ull << (page & 63);
+        if (m_observed[page]) m_write_cycle[addr] = m_cycle_source ? m_cycle_source() : 1;
+    }
+}
+
+// ============================================================================
+//  Observed Pages
+// ============================================================================
+void ram_62256::observe_page(u8 page, bool on) {
+    page &= 0x7F;
+    if (on && m_write_cycle.empty()) m_write_cycle.assign(sizeof(m_data), 0);
+
+    // Start from "unchanged" each time a page comes into view
+    if (on && !m_observed[page]) {
+        std::fill(m_write_cycle.begin() + (page << 8), m_write_cycle.begin() + ((page + 1) << 8), 0);
+    }
+    m_observed[page] = on;
+}
+
+void ram_62256::unobserve_all() {
+    for (auto& o : m_observed) o = false;
 }
 
 // ============================================================================
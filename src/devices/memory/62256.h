@@ -1,6 +1,8 @@
 #pragma once
 #include "../../emu/di_memory.h"
 #include <cstring> // For memset
+#include <functional>
+#include <vector>
 
 // ============================================================================
 //  Device: 62256 (32K Static RAM)
@@ -26,6 +28,39 @@ public:
     // Direct pointer access (for Debug UI)
     u8* get_data_ptr() { return m_data; }
 
+    // WHAT: Change counter for one 256-byte page (0-127).
+    // WHY:  Lets viewers (e.g. the disassembly cache) notice that a page's
+    //       bytes changed without re-reading it. Only bumped when a write
+    //       actually changes a byte.
+    u32 page_generation(u8 page) const { return m_page_gen[page & 0x7F]; }
+
+    // WHAT: Change counter for the whole chip (any byte changed).
+    u32 generation() const { return m_generation; }
+
+    // ========================================================================
+    //  Change Tracking (Debugger / Snapshots)
+    // ========================================================================
+    // WHAT: One dirty bit per page, set when a write changes a byte.
+    // WHY:  The debugger's memory snapshot re-copies only the pages written
+    //       since its last frame. It owns the bits: take_dirty() clears them.
+    void take_dirty(u64 out[2]) { out[0] = m_dirty[0]; out[1] = m_dirty[1]; m_dirty[0] = m_dirty[1] = 0; }
+
+    // WHAT: Per-byte "last changed" cycle for pages being watched.
+    // WHEN: The memory window observes the pages it shows.
+    // WHY:  Costs one flag test per write everywhere else; the cycle
+    //       table (256 KB) is only allocated once something is observed.
+    using cycle_func = std::function<u64()>;
+    void set_cycle_source(cycle_func source) { m_cycle_source = std::move(source); }
+    void observe_page(u8 page, bool on);
+    void unobserve_all();
+
+    // WHAT: CPU cycle of the last write that changed 'addr' (0 = not since
+    //       the page was observed).
+    u64 last_write_cycle(u16 addr) const {
+        addr &= 0x7FFF;
+        return m_observed[addr >> 8] ? m_write_cycle[addr] : 0;
+    }
+
     // Required by device interface
     void memory_map(address_map& map) override;
 
@@ -35,4 +70,16 @@ private:
     // NOTE: Even if we only map 16K in the 6502 address space, 
     //       the physical chip usually has 32K capacity.
     u8 m_data[32768];
+
+    // WHAT: One change counter per 256-byte page.
+    u32 m_page_gen[128] = {};
+    u32 m_generation = 0;
+
+    // WHAT: Dirty bits (pages 0-63, 64-127) since the last take_dirty().
+    u64 m_dirty[2] = { ~0ull, ~0ull };
+
+    // WHAT: Observed pages and their per-byte change cycles.
+    bool m_observed[128] = {};
+    std::vector<u64> m_write_cycle;     // 32768 entries once used
+    cycle_func m_cycle_source;
 };
\ No newline at end of file
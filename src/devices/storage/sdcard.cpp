@@ -0,0 +1,398 @@
+#include "sdcard.h"
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// R1 response bits
+static constexpr u8 R1_IDLE    = 0x01;
+static constexpr u8 R1_ILLEGAL = 0x04;
+static constexpr u8 R1_PARAM   = 0x40;
+
+// Data tokens / responses
+static constexpr u8 TOKEN_START       = 0xFE;  // Single block (and every read block)
+static constexpr u8 TOKEN_MULTI_WRITE = 0xFC;
+static constexpr u8 TOKEN_STOP_TRAN   = 0xFD;
+static constexpr u8 ERROR_OUT_OF_RANGE = 0x08; // Data error token
+static constexpr u8 DATA_ACCEPTED     = 0x05;
+static constexpr u8 DATA_WRITE_ERROR  = 0x0D;
+static constexpr int WRITE_BUSY_BYTES = 4;     // Programming time, in bytes of 0x00
+
+sd_card::~sd_card() {
+    close();
+}
+
+// ============================================================================
+//  Image Mapping
+// ============================================================================
+bool sd_card::open(const std::string& path) {
+    close();
+    u64 size = 0;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    m_read_only = (file == INVALID_HANDLE_VALUE);
+    if (m_read_only) {
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL, nullptr);
+    }
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "[SD] Cannot open " << path << std::endl;
+        return false;
+    }
+    LARGE_INTEGER li;
+    if (GetFileSizeEx(file, &li)) size = (u64)li.QuadPart;
+    if (size < BLOCK_SIZE) {
+        std::cerr << "[SD] " << path << " is smaller than one block." << std::endl;
+        CloseHandle(file);
+        return false;
+    }
+    m_blocks = size / BLOCK_SIZE;
+    m_size = m_blocks * BLOCK_SIZE;
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, m_read_only ? PAGE_READONLY : PAGE_READWRITE, 0, 0, nullptr);
+    void* view = mapping ? MapViewOfFile(mapping, m_read_only ? FILE_MAP_READ : FILE_MAP_WRITE, 0, 0, (SIZE_T)m_size)
+                         : nullptr;
+    if (!view) {
+        std::cerr << "[SD] Cannot map " << path << std::endl;
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    m_file = file;
+    m_mapping = mapping;
+    m_data = (u8*)view;
+#else
+    int fd = ::open(path.c_str(), O_RDWR);
+    m_read_only = (fd < 0);
+    if (m_read_only) fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "[SD] Cannot open " << path << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == 0) size = (u64)st.st_size;
+    if (size < BLOCK_SIZE) {
+        std::cerr << "[SD] " << path << " is smaller than one block." << std::endl;
+        ::close(fd);
+        return false;
+    }
+    m_blocks = size / BLOCK_SIZE;
+    m_size = m_blocks * BLOCK_SIZE;
+
+    void* view = mmap(nullptr, m_size, m_read_only ? PROT_READ : (PROT_READ | PROT_WRITE), MAP_SHARED, fd, 0);
+    if (view == MAP_FAILED) {
+        std::cerr << "[SD] Cannot map " << path << std::endl;
+        ::close(fd);
+        return false;
+    }
+    m_fd = fd;
+    m_data = (u8*)view;
+#endif
+
+    m_name = path;
+    m_idle = true;
+    m_app = false;
+    m_cmd_len = 0;
+    m_wr = wr_state::NONE;
+    reset_transfer();
+    std::cout << "[SD] " << path << ": " << m_blocks << " blocks" << (m_read_only ? " (read-only)" : "") << std::endl;
+    return true;
+}
+
+void sd_card::close() {
+    if (!m_data) return;
+#ifdef _WIN32
+    if (!m_read_only) FlushViewOfFile(m_data, 0);
+    UnmapViewOfFile(m_data);
+    CloseHandle((HANDLE)m_mapping);
+    CloseHandle((HANDLE)m_file);
+    m_mapping = m_file = nullptr;
+#else
+    if (!m_read_only) msync(m_data, m_size, MS_SYNC);
+    munmap(m_data, m_size);
+    ::close(m_fd);
+    m_fd = -1;
+#endif
+    m_data = nullptr;
+    m_size = m_blocks = 0;
+    m_block = nullptr;
+    m_wr_ptr = nullptr;
+}
+
+// ============================================================================
+//  SPI Side
+// ============================================================================
+void sd_card::select(bool selected) {
+    // Deselecting abandons a half-sent command (the transfer state stays)
+    if (!selected) m_cmd_len = 0;
+}
+
+u8 sd_card::transfer(u8 in) {
+    // A command start while waiting for a write token ends the wait
+    if (m_wr == wr_state::TOKEN && (in & 0xC0) == 0x40) m_wr = wr_state::NONE;
+
+    if (m_wr != wr_state::NONE) {
+        receive_data(in);
+    } else if (m_cmd_len > 0 || (in & 0xC0) == 0x40) {
+        // Commands are also watched for during a read stream (CMD12)
+        m_cmd[m_cmd_len++] = in;
+        if (m_cmd_len == 6) {
+            m_cmd_len = 0;
+            const u32 arg = ((u32)m_cmd[1] << 24) | ((u32)m_cmd[2] << 16) | ((u32)m_cmd[3] << 8) | m_cmd[4];
+            command(m_cmd[0] & 0x3F, arg);
+        }
+    }
+    return next_out();
+}
+
+// ============================================================================
+//  Commands
+// ============================================================================
+void sd_card::command(u8 cmd, u32 arg) {
+    reset_transfer();
+    const bool app = m_app;
+    m_app = false;
+    const u8 idle = m_idle ? R1_IDLE : 0x00;
+
+    if (!is_open()) {
+        // No medium: nothing answers (MISO stays high)
+        return;
+    }
+
+    if (app) {
+        switch (cmd) {
+            case 41: m_idle = false; respond_r1(0x00); break;   // SD_SEND_OP_COND: ready at once
+            default: respond_r1(idle | R1_ILLEGAL); break;
+        }
+        return;
+    }
+
+    switch (cmd) {
+        case 0:                                                 // GO_IDLE_STATE
+            m_idle = true;
+            respond_r1(R1_IDLE);
+            break;
+        case 8: {                                               // SEND_IF_COND: echo voltage + pattern
+            const u8 r7[5] = { idle, 0x00, 0x00, (u8)((arg >> 8) & 0x0F), (u8)arg };
+            respond(r7, 5);
+            break;
+        }
+        case 55:                                                // APP_CMD
+            m_app = true;
+            respond_r1(idle);
+            break;
+        case 58: {                                              // READ_OCR: 3.2-3.4 V, CCS (SDHC)
+            const u8 r3[5] = { idle, (u8)(m_idle ? 0x40 : 0xC0), 0xFF, 0x80, 0x00 };
+            respond(r3, 5);
+            break;
+        }
+        case 59:                                                // CRC_ON_OFF (CRCs aren't checked)
+            respond_r1(idle);
+            break;
+        case 9: {                                               // SEND_CSD (version 2.0)
+            u32 c_size = (u32)(m_blocks / 1024);
+            c_size = c_size ? c_size - 1 : 0;
+            u8 csd[16] = { 0x40, 0x0E, 0x00, 0x32, 0x5B, 0x59, 0x00,
+                           (u8)((c_size >> 16) & 0x3F), (u8)(c_size >> 8), (u8)c_size,
+                           0x7F, 0x80, 0x0A, 0x40, 0x00, 0x00 };
+            csd[15] = (u8)((crc7(csd, 15) << 1) | 1);
+            respond_data(idle, csd, 16);
+            break;
+        }
+        case 10: {                                              // SEND_CID
+            u8 cid[16] = { 0x00, 'E', '6', 'E', 'M', 'U', 'S', 'D', 0x10,
+                           0x00, 0x00, 0x65, 0x02, 0x01, 0x9A, 0x00 };
+            cid[15] = (u8)((crc7(cid, 15) << 1) | 1);
+            respond_data(idle, cid, 16);
+            break;
+        }
+        case 13: {                                              // SEND_STATUS (R2)
+            const u8 r2[2] = { idle, 0x00 };
+            respond(r2, 2);
+            break;
+        }
+        case 16:                                                // SET_BLOCKLEN: 512 only
+            respond_r1(idle | (arg == BLOCK_SIZE ? 0x00 : R1_PARAM));
+            break;
+        case 12:                                                // STOP_TRANSMISSION (stream already stopped)
+            respond_r1(idle);
+            break;
+        case 17:                                                // READ_SINGLE_BLOCK
+        case 18: {                                              // READ_MULTIPLE_BLOCK
+            if (m_idle) { respond_r1(idle | R1_ILLEGAL); break; }
+            if (arg >= m_blocks) { respond_r1(R1_PARAM); break; }
+            // R1, one byte of access time, then the start token; the block follows
+            const u8 r[3] = { 0x00, 0xFF, TOKEN_START };
+            respond(r, 3);
+            start_block(arg);
+            m_multi_read = (cmd == 18);
+            break;
+        }
+        case 24:                                                // WRITE_BLOCK
+        case 25:                                                // WRITE_MULTIPLE_BLOCK
+            if (m_idle) { respond_r1(idle | R1_ILLEGAL); break; }
+            if (arg >= m_blocks) { respond_r1(R1_PARAM); break; }
+            respond_r1(0x00);
+            m_wr = wr_state::TOKEN;
+            m_wr_block = arg;
+            m_multi_write = (cmd == 25);
+            break;
+        default:
+            respond_r1(idle | R1_ILLEGAL);
+            break;
+    }
+}
+
+void sd_card::reset_transfer() {
+    m_out_len = m_out_pos = 0;
+    m_block = nullptr;
+    m_block_left = 0;
+    m_crc_left = 0;
+    m_multi_read = false;
+    m_busy_left = 0;
+}
+
+void sd_card::respond(const u8* bytes, int n) {
+    // Ncr: one byte of 0xFF before the response
+    m_out[0] = 0xFF;
+    std::memcpy(m_out + 1, bytes, n);
+    m_out_len = n + 1;
+    m_out_pos = 0;
+}
+
+void sd_card::respond_data(u8 r1, const u8* data, int n) {
+    const u8 head[3] = { r1, 0xFF, TOKEN_START };
+    respond(head, 3);
+    std::memcpy(m_out + m_out_len, data, n);
+    m_out_len += n;
+    const u16 crc = crc16(data, (u32)n);
+    m_out[m_out_len++] = (u8)(crc >> 8);
+    m_out[m_out_len++] = (u8)crc;
+}
+
+// ============================================================================
+//  Data Blocks
+// ============================================================================
+//  Reads point m_block into the mapping and hand it out a byte at a time;
+//  writes store each byte straight into the mapping as it arrives.
+// ============================================================================
+bool sd_card::start_block(u64 block) {
+    if (block >= m_blocks) return false;
+    m_block = m_data + block * BLOCK_SIZE;
+    m_block_left = BLOCK_SIZE;
+    const u16 crc = crc16(m_block, BLOCK_SIZE);
+    m_crc[0] = (u8)(crc >> 8);
+    m_crc[1] = (u8)crc;
+    m_crc_left = 2;
+    m_next_block = block + 1;
+    m_blocks_read++;
+    return true;
+}
+
+u8 sd_card::next_out() {
+    if (m_out_pos < m_out_len) return m_out[m_out_pos++];
+    if (m_block_left) {
+        m_block_left--;
+        return *m_block++;
+    }
+    if (m_crc_left) return m_crc[2 - m_crc_left--];
+    if (m_multi_read) {
+        // CMD18: the next block follows its own token, until CMD12
+        m_out_len = m_out_pos = 0;
+        if (start_block(m_next_block)) {
+            m_out[m_out_len++] = 0xFF;
+            m_out[m_out_len++] = TOKEN_START;
+        } else {
+            m_multi_read = false;
+            m_out[m_out_len++] = ERROR_OUT_OF_RANGE;
+        }
+        return next_out();
+    }
+    if (m_busy_left) {
+        m_busy_left--;
+        return 0x00;
+    }
+    return 0xFF;
+}
+
+void sd_card::receive_data(u8 in) {
+    switch (m_wr) {
+        case wr_state::TOKEN:
+            if (in == (m_multi_write ? TOKEN_MULTI_WRITE : TOKEN_START)) {
+                m_wr_ok = !m_read_only && m_wr_block < m_blocks;
+                m_wr_ptr = m_wr_ok ? m_data + m_wr_block * BLOCK_SIZE : nullptr;
+                m_wr_pos = 0;
+                m_wr = wr_state::DATA;
+            } else if (m_multi_write && in == TOKEN_STOP_TRAN) {
+                m_wr = wr_state::NONE;
+                m_busy_left = WRITE_BUSY_BYTES;
+            }
+            break;
+
+        case wr_state::DATA:
+            if (m_wr_ptr) m_wr_ptr[m_wr_pos] = in;
+            if (++m_wr_pos == BLOCK_SIZE) {
+                m_wr_pos = 0;
+                m_wr = wr_state::CRC;
+            }
+            break;
+
+        case wr_state::CRC:
+            if (++m_wr_pos < 2) break;
+            // Data response right away, then busy while "programming"
+            m_out[0] = m_wr_ok ? DATA_ACCEPTED : DATA_WRITE_ERROR;
+            m_out_len = 1;
+            m_out_pos = 0;
+            m_busy_left = WRITE_BUSY_BYTES;
+            if (m_wr_ok) m_blocks_written++;
+            m_wr_block++;
+            m_wr = m_multi_write ? wr_state::TOKEN : wr_state::NONE;
+            break;
+
+        case wr_state::NONE:
+            break;
+    }
+}
+
+// ============================================================================
+//  CRCs
+// ============================================================================
+u16 sd_card::crc16(const u8* data, u32 n) {
+    // CRC-16/XMODEM (x^16 + x^12 + x^5 + 1), as used for data blocks
+    static u16 table[256];
+    static bool ready = false;
+    if (!ready) {
+        for (u32 i = 0; i < 256; i++) {
+            u16 c = (u16)(i << 8);
+            for (int b = 0; b < 8; b++) c = (c & 0x8000) ? (u16)((c << 1) ^ 0x1021) : (u16)(c << 1);
+            table[i] = c;
+        }
+        ready = true;
+    }
+    u16 crc = 0;
+    for (u32 i = 0; i < n; i++) crc = (u16)((crc << 8) ^ table[(u8)((crc >> 8) ^ data[i])]);
+    return crc;
+}
+
+u8 sd_card::crc7(const u8* data, int n) {
+    // x^7 + x^3 + 1, as used for commands and the CSD/CID registers
+    u8 crc = 0;
+    for (int i = 0; i < n; i++) {
+        u8 d = data[i];
+        for (int b = 0; b < 8; b++) {
+            crc <<= 1;
+            if ((d ^ crc) & 0x80) crc ^= 0x09;
+            d <<= 1;
+        }
+    }
+    return crc & 0x7F;
+}
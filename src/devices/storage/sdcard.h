@@ -0,0 +1,103 @@
+#pragma once
+#include "../io/spi.h"
+#include <string>
+
+// ============================================================================
+//  Device: SD Card (SPI Mode)
+// ============================================================================
+//  WHO:  Sits on the board's spi_bus (see mb_driver::attach_sdcard); main()
+//        opens it for --sdcard.
+//  WHAT: An SDHC card whose blocks are a disk image file: CMD0/8/55/ACMD41/
+//        58 initialisation, CSD/CID/status, single and multiple block reads
+//        and writes (512 bytes, block addressed).
+//  WHY:  Filesystem firmware (FAT on a card module wired to the VIA) needs
+//        real protocol behaviour, and a whole image can be too large to
+//        load up front.
+//  HOW:  The image is memory-mapped. Reads stream straight out of the
+//        mapping and writes land straight in it, so no block is ever
+//        copied; the OS writes dirty pages back (flushed on close).
+//        Responses follow one 0xFF byte (Ncr = 1), data tokens one more.
+//        Command CRCs are not checked; data blocks carry a real CRC16.
+// ============================================================================
+class sd_card : public spi_device {
+public:
+    static constexpr u32 BLOCK_SIZE = 512;
+
+    sd_card() = default;
+    ~sd_card() override;
+
+    // WHAT: Maps 'path' (read-only if it can't be opened for writing).
+    //       Returns false (with a console message) if it can't be mapped.
+    //       A partial last block is ignored.
+    bool open(const std::string& path);
+    void close();
+    bool is_open() const { return m_data != nullptr; }
+    bool read_only() const { return m_read_only; }
+
+    // --- spi_device ---
+    void select(bool selected) override;
+    u8   transfer(u8 mosi) override;
+
+    u64 blocks() const { return m_blocks; }
+    u64 blocks_read() const { return m_blocks_read; }
+    u64 blocks_written() const { return m_blocks_written; }
+    const std::string& name() const { return m_name; }
+
+private:
+    // --- Image Mapping ---
+    u8*  m_data = nullptr;
+    u64  m_size = 0;            // Mapped bytes
+    u64  m_blocks = 0;
+    bool m_read_only = false;
+    std::string m_name;
+#ifdef _WIN32
+    void* m_file = nullptr;     // HANDLEs
+    void* m_mapping = nullptr;
+#else
+    int  m_fd = -1;
+#endif
+
+    // --- Card State ---
+    bool m_idle = true;         // Until ACMD41 completes
+    bool m_app = false;         // Last command was CMD55
+
+    // Incoming command (6 bytes: 01cccccc, 32-bit argument, CRC)
+    u8   m_cmd[6] = {};
+    int  m_cmd_len = 0;
+
+    // Outgoing: short responses queue up here, then a data block follows
+    u8   m_out[32] = {};
+    int  m_out_len = 0, m_out_pos = 0;
+    const u8* m_block = nullptr;    // Block being read (inside the mapping)
+    u32  m_block_left = 0;
+    u8   m_crc[2] = {};
+    int  m_crc_left = 0;
+    u64  m_next_block = 0;      // CMD18: next block to stream
+    bool m_multi_read = false;
+    int  m_busy_left = 0;       // 0x00 bytes after a write
+
+    // Incoming data (CMD24/25)
+    enum class wr_state { NONE, TOKEN, DATA, CRC };
+    wr_state m_wr = wr_state::NONE;
+    bool m_multi_write = false;
+    u8*  m_wr_ptr = nullptr;    // Block being written (inside the mapping)
+    u64  m_wr_block = 0;
+    u32  m_wr_pos = 0;
+    bool m_wr_ok = false;       // Block in range and writable
+
+    // Stats
+    u64 m_blocks_read = 0;
+    u64 m_blocks_written = 0;
+
+    void command(u8 cmd, u32 arg);
+    void respond(const u8* bytes, int n);
+    void respond_r1(u8 r1) { respond(&r1, 1); }
+    void respond_data(u8 r1, const u8* data, int n);     // R1 + token + small register block
+    bool start_block(u64 block);
+    void receive_data(u8 in);
+    u8   next_out();
+    void reset_transfer();
+
+    static u16 crc16(const u8* data, u32 n);
+    static u8  crc7(const u8* data, int n);
+};
@@ -318,7 +318,12 @@ void nhd_0216k1z::write_4bit(u8 data_lines, bool rs, bool rw, bool e) {
         }
         else {
             // --- NORMAL 4-BIT OPERATION ---
-            if (!m_nibble_flip) {
+            if (rw) {
+                // Read cycle: the LCD drove the bus (the board fetched the
+                // nibble while E was high); only the half tracker moves.
+                m_nibble_flip = !m_nibble_flip;
+            }
+            else if (!m_nibble_flip) {
                 // First Nibble (High)
                 m_high_nibble = nibble;
                 m_nibble_flip = true;
@@ -357,12 +362,14 @@ void nhd_0216k1z::write_8bit(u8 byte, bool rs, [[maybe_unused]] bool rw) {
 //  INSTRUCTION PROCESSOR (HD44780 Standard)
 // ============================================================================
 void nhd_0216k1z::process_instruction(u8 cmd) {
+    start_busy((cmd >= 0x01 && cmd <= 0x03) ? EXEC_NS_HOME : EXEC_NS_OTHER);
     
     // 1. CLEAR DISPLAY (0x01)
     if (cmd == 0x01) {
         std::memset(m_ddram, 0x20, sizeof(m_ddram));
         m_ac = 0;
         m_increment = true; 
+        m_display_dirty = true;
     }
     
     // 2. RETURN HOME (0x02 - 0x03)
@@ -413,94 +420,140 @@ void nhd_0216k1z::process_instruction(u8 cmd) {
     else if (cmd & 0x80) {
         m_ac = (cmd & 0x7F);
     }
-    
-    update_visuals();
 }
 
 // ============================================================================
 //  DATA WRITE
 // ============================================================================
 void nhd_0216k1z::write_data(u8 data) {
+    start_busy(EXEC_NS_OTHER);
+
     // Safety Wrap (80 bytes of RAM)
     if (m_ac >= 0x80) m_ac = 0; 
     
-    m_ddram[m_ac] = data;
+    if (m_ddram[m_ac] != data) {
+        m_ddram[m_ac] = data;
+        m_display_dirty = true;
+    }
     
     // Increment / Decrement Cursor
     if (m_increment) m_ac++;
     else             m_ac--;
-    
-    update_visuals();
 }
 
 // ============================================================================
-//  VISUAL UPDATE (Translation Layer)
+//  DATA READ
 // ============================================================================
-void nhd_0216k1z::update_visuals() {
-    // Rebuild the strings entirely because UTF-8 chars vary in byte length.
-    
-    // --- Line 1 (0x00 - 0x0F) ---
-    m_display_cache[0].clear();
-    for (int i = 0; i < 16; i++) {
-        m_display_cache[0] += map_rom_code_to_utf8(m_ddram[0x00 + i]);
-    }
-    
-    // --- Line 2 (0x40 - 0x4F) ---
-    m_display_cache[1].clear();
-    for (int i = 0; i < 16; i++) {
-        m_display_cache[1] += map_rom_code_to_utf8(m_ddram[0x40 + i]);
-    }
+u8 nhd_0216k1z::read_data() {
+    start_busy(EXEC_NS_OTHER);
+
+    if (m_ac >= 0x80) m_ac = 0;
+    u8 data = m_ddram[m_ac];
+
+    if (m_increment) m_ac++;
+    else             m_ac--;
+    return data;
+}
+
+// ============================================================================
+//  BUSY TIMING
+// ============================================================================
+void nhd_0216k1z::start_busy(u32 ns) {
+    m_access_count++;
+    if (!m_clock) return;
+    u64 cycles = ((u64)ns * m_clock_hz + 999999999ull) / 1000000000ull;
+    m_busy_until = m_clock() + cycles;
 }
 
 // ============================================================================
 //  ROM CODE A00 MAPPING (From Table 4)
 // ============================================================================
-std::string nhd_0216k1z::map_rom_code_to_utf8(u8 b) {
-    // 1. Standard ASCII (0x20 - 0x7D)
-    // Note: 0x5C is Yen (¥) in A00 ROM, but Backslash (\) in ASCII.
-    // We will use Yen to match the table provided.
-    if (b >= 0x20 && b <= 0x7D) {
-        if (b == 0x5C) return "¥"; 
-        return std::string(1, (char)b);
+//  WHAT: Character code -> UTF-8 text, one entry per code.
+//  HOW:  Built at compile time; a lookup is an index plus a short append.
+// ============================================================================
+namespace {
+
+struct lcd_utf8 {
+    char text[4];       // Not terminated
+    u8   length;
+};
+
+constexpr lcd_utf8 utf8(const char* s) {
+    lcd_utf8 g = {};
+    while (g.length < 4 && s[g.length]) {
+        g.text[g.length] = s[g.length];
+        g.length++;
     }
+    return g;
+}
+
+struct lcd_utf8_table {
+    lcd_utf8 code[256] = {};
+
+    constexpr lcd_utf8_table() {
+        // Unmapped characters show as dot
+        for (int b = 0; b < 256; b++) code[b] = utf8(".");
+
+        // 1. Standard ASCII (0x20 - 0x7D)
+        // Note: 0x5C is Yen (¥) in A00 ROM, but Backslash (\) in ASCII.
+        // We will use Yen to match the table provided.
+        for (int b = 0x20; b <= 0x7D; b++) {
+            code[b].text[0] = (char)b;
+            code[b].length = 1;
+        }
+        code[0x5C] = utf8("¥");
+
+        // 2. Specific Symbols from Table 4
+        code[0x7E] = utf8("→");   // Right Arrow
+        code[0x7F] = utf8("←");   // Left Arrow
 
-    // 2. Specific Symbols from Table 4
-    switch (b) {
-        // --- Special Symbols ---
-        case 0x7E: return "→"; // Right Arrow
-        case 0x7F: return "←"; // Left Arrow
-        
         // --- Upper Symbols (Katakana / Greek / Math) ---
-        case 0xA0: return " "; // Nbsp
-        case 0xA1: return "｡";
-        case 0xA2: return "｢";
-        case 0xA3: return "｣";
-        case 0xA4: return "､";
-        case 0xA5: return "･";
-        
+        code[0xA0] = utf8(" ");   // Nbsp
+        code[0xA1] = utf8("｡");
+        code[0xA2] = utf8("｢");
+        code[0xA3] = utf8("｣");
+        code[0xA4] = utf8("､");
+        code[0xA5] = utf8("･");
+
         // Selected Greek/Math from bottom right of table
-        case 0xDF: return "°"; // Degree
-        case 0xE0: return "α"; // Alpha
-        case 0xE2: return "β"; // Beta
-        case 0xE3: return "ε"; // Epsilon
-        case 0xE4: return "μ"; // Mu
-        case 0xE5: return "σ"; // Sigma
-        case 0xF2: return "θ"; // Theta
-        case 0xF3: return "∞"; // Infinity
-        case 0xF4: return "Ω"; // Omega
-        case 0xF6: return "Σ"; // Sigma
-        case 0xF7: return "π"; // Pi
-        
-        case 0xFD: return "÷"; // Divide
-        case 0xFF: return "█"; // Black Block
+        code[0xDF] = utf8("°");   // Degree
+        code[0xE0] = utf8("α");   // Alpha
+        code[0xE2] = utf8("β");   // Beta
+        code[0xE3] = utf8("ε");   // Epsilon
+        code[0xE4] = utf8("μ");   // Mu
+        code[0xE5] = utf8("σ");   // Sigma
+        code[0xF2] = utf8("θ");   // Theta
+        code[0xF3] = utf8("∞");   // Infinity
+        code[0xF4] = utf8("Ω");   // Omega
+        code[0xF6] = utf8("Σ");   // Sigma
+        code[0xF7] = utf8("π");   // Pi
+
+        code[0xFD] = utf8("÷");   // Divide
+        code[0xFF] = utf8("█");   // Black Block
 
         // 3. CGRAM (0x00 - 0x07) placeholder
-        case 0x00: case 0x08: return " "; 
-        
-        default: return "."; // Unmapped characters show as dot
+        code[0x00] = utf8(" ");
+        code[0x08] = utf8(" ");
     }
-}
+};
+
+constexpr lcd_utf8_table s_utf8;
+
+} // namespace
 
 const std::vector<std::string>& nhd_0216k1z::get_display_lines() {
+    if (m_display_dirty) {
+        // Line 1 is DDRAM 0x00 - 0x0F, line 2 is 0x40 - 0x4F.
+        // clear() keeps the capacity, so this does not allocate either.
+        for (int row = 0; row < 2; row++) {
+            std::string& line = m_display_cache[row];
+            line.clear();
+            for (int i = 0; i < 16; i++) {
+                const lcd_utf8& g = s_utf8.code[m_ddram[row * 0x40 + i]];
+                line.append(g.text, g.length);
+            }
+        }
+        m_display_dirty = false;
+    }
     return m_display_cache;
-}
\ No newline at end of file
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include "../../emu/types.h"
+#include <functional>
 #include <vector>
 #include <string>
 
@@ -16,10 +17,44 @@ public:
     // In 4-bit mode, we receive data on DB4-DB7 (upper nibble of byte).
     // The RS/RW/E lines are separate control bits.
     void write_4bit(u8 data_lines, bool rs, bool rw, bool e);
+    // WHAT: True when the next 4-bit transfer (read or write) is the low
+    //       nibble. Reads return the same halves in the same order.
+    bool next_nibble_low() const { return !m_8bit_mode && m_nibble_flip; }
 
     void write_8bit(u8 byte, bool rs, bool rw);
 
+    // --- Read Cycle (RW = 1) ---
+    // Status: BF (bit 7) | address counter. No side effects.
+    u8 read_status() const { return (busy() ? 0x80 : 0x00) | (m_ac & 0x7F); }
+    // Data: the RAM byte at the address counter, which then moves on.
+    u8 read_data();
+
+    // ========================================================================
+    //  Execution Time / Busy Flag
+    // ========================================================================
+    // WHAT: Every instruction and data access keeps the controller busy for
+    //       its datasheet execution time, measured on the CPU clock.
+    // WHY:  Firmware that polls BF instead of using fixed delays needs to
+    //       see it set. Commands are still applied immediately.
+    // NOTE: Without a clock source the LCD is never busy.
+    static constexpr u32 EXEC_NS_HOME  = 1520000;   // Clear Display, Return Home (1.52 ms)
+    static constexpr u32 EXEC_NS_OTHER = 37000;     // Everything else (37 us)
+
+    using cycle_func = std::function<u64()>;
+    void set_clock(cycle_func now, u32 hz) { m_clock = std::move(now); m_clock_hz = hz; }
+
+    bool busy() const { return m_clock && m_clock() < m_busy_until; }
+    u64  busy_until() const { return m_busy_until; }
+
+    // WHAT: Counts instructions and data accesses (not status reads).
+    // WHY:  Lets the driver prove that nothing but BF polls happened
+    //       between two reads.
+    u32  access_count() const { return m_access_count; }
+
     // Visual Output
+    // WHAT: The two visible lines as UTF-8 text.
+    // HOW:  Rebuilt here, and only if DDRAM changed since the last call, so
+    //       character writes in the emulation loop never touch the allocator.
     const std::vector<std::string>& get_display_lines();
 
     u8   get_cursor_addr() const { return m_ac; }
@@ -51,6 +86,13 @@ private:
     bool m_increment = true;
     bool m_shift = false;
     
+    // Timing
+    cycle_func m_clock;
+    u32 m_clock_hz = 0;
+    u64 m_busy_until = 0;
+    u32 m_access_count = 0;
+    void start_busy(u32 ns);
+
     // 4-Bit State
     bool m_nibble_flip = false; 
     u8   m_high_nibble = 0;
@@ -59,11 +101,8 @@ private:
     // --- Helpers ---
     void process_instruction(u8 cmd);
     void write_data(u8 data);
-    void update_visuals(); 
-    
-    // [NEW] Maps LCD Byte -> UTF-8 String based on Table 4
-    std::string map_rom_code_to_utf8(u8 lcd_byte);
 
-    // Visual Buffer
+    // Visual Buffer (UTF-8, see get_display_lines)
     std::vector<std::string> m_display_cache;
+    bool m_display_dirty = true;
 };
\ No newline at end of file
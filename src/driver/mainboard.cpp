@@ -1,6 +1,9 @@
 #include "mainboard.h"
 #include "../emu/map.h"
+#include <chrono>
+#include <cstring>
 #include <iostream>
+#include <thread>
 
 
 // ============================================================================
@@ -19,11 +22,12 @@ class mb_driver::board_cpu : public m6502_p {
 
         // Redirect the map setup to the driver
         void memory_map(address_map& map) override {
-            driver->map_setup(map);
+            driver->map_setup(map, driver->m_current_type);
         }
         // helper to install the map pointer
         void install_map(address_map* map) {
             this->m_map = map;
+            debug().attach_map(map); // Carry watchpoints over to the new map
         }
 };
 
@@ -53,8 +57,26 @@ void mb_driver::init() {
         std::cerr << "[Board] Warning: rom.bin not found. ROM is empty." << std::endl;
     }
 
+    // RAM change tracking timestamps writes with the CPU's cycle count
+    m_ram.set_cycle_source([this]() { return m_cpu->total_cycles(); });
+
+    // LCD execution times run on the CPU clock
+    m_lcd.set_clock([this]() { return m_cpu->total_cycles(); }, m_cpu->clock());
+
+    // ACIA data register accesses schedule the serial line
+    m_acia.set_tx_callback([this]() { serial_wake(); });
+    m_acia.set_rx_callback([this]() { serial_wake(); });
+
+    // PS/2 frames are timed on the CPU clock
+    m_kbd.set_clock(m_cpu->clock());
+
+    m_spi.set_pins(SPI_SCK, SPI_MOSI, SPI_MISO);
+
+    // Decode every schematic's address map once
+    for (int t = 0; t < MACHINE_TYPE_COUNT; t++) map_setup(m_maps[t], (MachineType)t);
+
     // Default to Schematic 1
-    set_machine_type(MachineType::SCHEMATIC_1_BASIC);
+    configure_machine(MachineType::SCHEMATIC_1_BASIC);
 
     m_cpu->device_start();
 }
@@ -63,31 +85,55 @@ void mb_driver::init() {
 //  Hardware Configuration Switcher
 // ============================================================================
 void mb_driver::set_machine_type(MachineType type) {
+    submit_input(input_type::MACHINE_TYPE, (u8)type);
+}
+
+void mb_driver::configure_machine(MachineType type) {
+    if ((int)type < 0 || (int)type >= MACHINE_TYPE_COUNT) type = MachineType::SCHEMATIC_1_BASIC;
     m_current_type = type;
     
     // 1. Reset Internal State
-    m_last_e_state = false;
-    m_port_b_data = 0;
+    m_lcd_poll.valid = false;
+    m_lcd_spin_period = 0;
     
-    // 2. Re-Install Memory Map
-    // We create a new map and force the CPU to use it.
-    // (Note: In a real MAME system, the manager handles this rebuild.
-    //  Here, we just re-run the map setup logic).
-    static address_map active_map;
-    map_setup(active_map);
-    m_cpu->install_map(&active_map);
+    // 2. Swap in this schematic's Memory Map
+    // (Built once by init(); watchpoints move over with it).
+    m_cpu->install_map(&m_maps[(int)type]);
 
     // 3. Re-Wire Interrupts & I/O based on Schematic
     
     // --- COMMON INTERRUPT LOGIC ---
-    auto irq_handler = [this](bool state) {
-        m_cpu->set_input_line(m6502_p::IRQ_LINE, state ? 1 : 0);
-    };
-    m_via.set_irq_callback(irq_handler);
-    m_acia.set_irq_callback(irq_handler);
+    // Both chips share the open-drain /IRQ wire; the merger ORs them.
+    m_irq.output().disconnect_all();
+    m_irq.output().connect([this](signal_edge edge) {
+        m_cpu->set_input_line(m6502_p::IRQ_LINE, edge == signal_edge::RISING);
+    });
+    m_via.set_irq_callback([this](bool level) {
+        m_irq.set(IRQ_SRC_VIA, !level);         // VIA reports the pin level (Low = Assert)
+    });
+    m_acia.set_irq_callback(nullptr);           // Only fitted on Schematic 2
 
 
     // --- SCHEMATIC SPECIFIC WIRING ---
+    // Start from unconnected pins: this runs again on every machine switch
+    m_via.port_a().disconnect_all();
+    m_via.port_b().disconnect_all();
+    m_via.ca2().disconnect_all();
+    m_via.cb1().disconnect_all();
+    m_via.cb2().disconnect_all();
+    m_via.set_port_a_read_callback(nullptr);
+    m_via.set_port_b_read_callback(nullptr);
+    m_kbd.data().disconnect_all();
+    m_kbd.ready().disconnect_all();
+
+    // Sound pins (every schematic): a speaker on PB7 and on CB2
+    m_via.port_b().connect_bit(7, [this](signal_edge edge) {
+        if (m_audio) m_audio->set_level(audio_out::SRC_PB7, edge == signal_edge::RISING, via_time());
+    });
+    m_via.cb2().connect([this](signal_edge edge) {
+        if (m_audio) m_audio->set_level(audio_out::SRC_CB2, edge == signal_edge::RISING, via_time());
+    });
+
     if (m_current_type == MachineType::SCHEMATIC_1_BASIC) {
         std::cout << "[Board] Configured for Schematic 1 (Basic)" << std::endl;
         
@@ -95,43 +141,94 @@ void mb_driver::set_machine_type(MachineType type) {
         // PB0-7 = Data Bus
         // PA5=RS, PA6=RW, PA7=E
         
-        m_via.set_port_b_callback([this](u8 data) {
-            m_port_b_data = data;
-        });
-        
-        m_via.set_port_a_callback([this](u8 data) {
-            bool rs = (data & 0x20); // Bit 5
-            bool rw = (data & 0x40); // Bit 6
-            bool e  = (data & 0x80); // Bit 7
-            
-            if (m_last_e_state && !e) { // Falling Edge
+        m_via.port_a().connect_bit(LCD_E_BIT, [this](signal_edge edge) {
+            // RS/RW come from the same port write that moved E
+            u8 pa = m_via.port_a().value();
+            bool rs = (pa & LCD_RS);
+            bool rw = (pa & LCD_RW);
+
+            if (edge == signal_edge::RISING && rw && rs) {
+                // Data read: the LCD fetches the byte (and moves its address counter)
+                m_lcd_data = m_lcd.read_data();
+            }
+            if (edge == signal_edge::FALLING && !rw) {
                 // 8-bit write using Port B data
-                m_lcd.write_8bit(m_port_b_data, rs, rw);
+                m_lcd.write_8bit(m_via.port_b().value(), rs, rw);
             }
-            m_last_e_state = e;
+        });
+
+        // Read cycles: the LCD drives PB while E is high
+        m_via.set_port_b_read_callback([this](u8 pins) {
+            return lcd_bus_read(pins);
         });
     }
     else if (m_current_type == MachineType::SCHEMATIC_2_SERIAL) {
         std::cout << "[Board] Configured for Schematic 2 (Serial)" << std::endl;
         
-        // SCHEMATIC 2: 
-        // (You will implement the specific wiring here later based on the 2nd schematic image)
-        // For now, leave it blank or default to Basic behavior.
+        // SCHEMATIC 2: ACIA /IRQ, SD card on PA0-PA2/PA7
+
+        // ACIA /IRQ joins the VIA's on the shared wire
+        m_acia.set_irq_callback([this](bool asserted) {
+            m_irq.set(IRQ_SRC_ACIA, asserted);
+        });
+
+        // SD card module on Port A (bit-banged SPI)
+        // PA0=SCK, PA1=MOSI, PA2=/CS, PA7=MISO
+        m_via.port_a().connect([this](u8 value, u8) {
+            m_spi.port_write(value);
+        });
+        m_via.set_port_a_read_callback([this](u8 pins) {
+            return m_spi.read_pins(pins);
+        });
+        m_spi.port_write(m_via.port_a().value());
+    }
+    else if (m_current_type == MachineType::SCHEMATIC_3_KEYBOARD) {
+        std::cout << "[Board] Configured for Schematic 3 (Keyboard)" << std::endl;
+
+        // SCHEMATIC 3: LCD on Port B (4-bit), keyboard interface on Port A
+        // PB0-3 = DB4-DB7, PB4=RS, PB5=RW, PB6=E
+        // PA0-7 = Scancode (shift register outputs), CA1 = byte ready
+
+        m_via.port_b().connect_bit(LCD4_E_BIT, [this](signal_edge edge) {
+            u8 pb = m_via.port_b().value();
+            bool rs = (pb & LCD4_RS);
+            bool rw = (pb & LCD4_RW);
+
+            if (edge == signal_edge::RISING && rw && rs && !m_lcd.next_nibble_low()) {
+                // Data read: fetched whole on the first half, returned in two
+                m_lcd_data = m_lcd.read_data();
+            }
+            // The LCD acts on the falling edge (and counts read halves)
+            m_lcd.write_4bit((u8)(pb << 4), rs, rw, edge == signal_edge::RISING);
+        });
+
+        m_via.set_port_b_read_callback([this](u8 pins) {
+            return lcd_bus_read_4bit(pins);
+        });
+
+        connect_keyboard();
     }
 
     // 4. Clear Lines
+    m_irq.clear();
     m_cpu->set_input_line(m6502_p::IRQ_LINE, 0); 
     m_cpu->set_input_line(m6502_p::NMI_LINE, 0);
 }
 
 void mb_driver::reset() {
+    submit_input(input_type::RESET, 0);
+}
+
+void mb_driver::reset_board() {
     std::cout << "[Board] Reset Sequence..." << std::endl;
     //m_rom.reset_memory(); // Optional, usually ROM doesn't reset
     m_ram.reset_memory();
     m_via.reset();
+    if (m_current_type == MachineType::SCHEMATIC_3_KEYBOARD) connect_keyboard();   // PA/CA1 pins are still driven
 
     // 2. Clear Interrupt Lines (Crucial Fix for "Stuck at 8000")
     // If these are floating or 1, the CPU gets stuck in an interrupt loop.
+    m_irq.clear();
     m_cpu->set_input_line(m6502_p::IRQ_LINE, 0); 
     m_cpu->set_input_line(m6502_p::NMI_LINE, 0);
 
@@ -141,70 +238,557 @@ void mb_driver::reset() {
     //m_cpu->set_input_line(m6502_p::RESET_LINE, 0);
 }
 
+void mb_driver::reset_cpu() {
+    submit_input(input_type::CPU_RESET, 0);
+}
+
+bool mb_driver::load_rom(const char* filename) {
+    if (m_journal.is_replaying()) {
+        std::cerr << "[Journal] ROM load ignored during replay." << std::endl;
+        return false;
+    }
+    std::cout << "[Driver] Attempting to load ROM from: " << filename << std::endl;
+    bool result = m_rom.load_from_file(filename);
+    if (result) {
+        std::cout << "[Driver] Success! ROM loaded." << std::endl;
+        // The journal carries the image itself, so a replay does not depend
+        // on the file still existing (or being unchanged) on disk.
+        if (m_journal.is_recording()) {
+            m_journal.record(m_cpu->total_cycles(), input_type::ROM_LOAD, 0, m_rom.get_data_ptr(), 32768);
+        }
+    } else {
+        std::cerr << "[Driver] Failed to load ROM." << std::endl;
+    }
+    return result;
+}
+
+// ============================================================================
+//  Execution Slice
+// ============================================================================
+//  WHAT: Runs the CPU for (at least) 'cycles' cycles.
+//  HOW:  The budget is turned into an absolute target on the CPU cycle
+//        counter and executed in short slices. A slice ends at the target,
+//        at the next VIA sync mark, or at the next journal event, so replayed
+//        inputs land on exactly the cycle they were recorded at.
+// ============================================================================
 void mb_driver::run(int cycles) {
-    // Give the CPU a budget of cycles
-    m_cpu->icount_set(cycles);
+    u64 now = m_cpu->total_cycles();
+    const u64 target = now + (u64)cycles;
+
+    while (now < target) {
+        if (m_journal.is_replaying()) replay_due_inputs(now);
+        if (now >= m_serial_event) service_serial(now);
+        if (now >= m_kbd.next_event()) service_keyboard(now);
+
+        u64 slice_end = m_next_sync;
+        if (slice_end > target) slice_end = target;
+        if (m_journal.is_replaying() && m_journal.next_cycle() < slice_end) {
+            slice_end = m_journal.next_cycle();
+        }
+        if (m_serial_event < slice_end) slice_end = m_serial_event;
+        if (m_kbd.next_event() < slice_end) slice_end = m_kbd.next_event();
+
+        // Run the CPU
+        m_cpu->icount_set((int)(slice_end - now));
+        m_cpu->execute_run();
 
-    m_via.clock();
+        u64 after = m_cpu->total_cycles();
+        if (after == now) break; // CPU is held (RESET/RDY) or stopped on a breakpoint
 
-    // Run the CPU
-    m_cpu->execute_run();
+        // Catch the VIA up once we cross a sync mark
+        if (after >= m_next_sync) {
+            m_via_catchup = true;
+            for (; m_via_cycle < after; m_via_cycle++) m_via.clock();
+            m_via_catchup = false;
+            m_next_sync = (after / SLICE_CYCLES + 1) * SLICE_CYCLES;
+            service_serial(after);
+        }
+        now = after;
 
+        // Firmware spinning on the LCD busy flag: skip to where it clears
+        if (m_lcd_spin_period) {
+            u64 limit = target;
+            if (m_journal.is_replaying() && m_journal.next_cycle() < limit) limit = m_journal.next_cycle();
+            if (m_serial_event < limit) limit = m_serial_event;
+            if (m_kbd.next_event() < limit) limit = m_kbd.next_event();
+            now = skip_lcd_poll(now, limit);
+        }
+
+        // Debugger break: give control back to the UI
+        if (m_cpu->debug().break_pending()) break;
+    }
+
+    if (m_audio) m_audio->advance(m_via_cycle);
 }
 
 // ============================================================================
-//  The Memory Map (74HC00 Logic)
+//  LCD Read Cycles & Busy-Poll Elision
 // ============================================================================
-void mb_driver::map_setup(address_map& map) {
-    
-     auto read_logic = [this](u16 addr) -> u8 {
-        // Common ROM
-        if (addr >= 0x8000) return m_rom.read(addr - 0x8000);
-        
-        // I/O Mapping Changes based on Schematic!
-        if (m_current_type == MachineType::SCHEMATIC_1_BASIC) {
-            // Basic: VIA at $6000
-            if (addr >= 0x6000 && addr <= 0x7FFF) return m_via.read(addr - 0x6000);
+u8 mb_driver::lcd_bus_read(u8 pins) {
+    u8 pa = m_via.port_a().value();
+    if (!(pa & (1u << LCD_E_BIT)) || !(pa & LCD_RW)) return pins;   // LCD not driving (E low or write)
+    if (pa & LCD_RS) return m_lcd_data;
+
+    u8 status = m_lcd.read_status();
+    if (status & 0x80) note_lcd_busy_read();
+    else               m_lcd_poll.valid = false;
+    return status;
+}
+
+// WHAT: Schematic 3: the LCD drives DB4-DB7 (PB0-PB3) while E is high and
+//       RW = 1; high half first, then low. PB4-PB7 are the VIA's own pins.
+u8 mb_driver::lcd_bus_read_4bit(u8 pins) {
+    u8 pb = m_via.port_b().value();
+    if (!(pb & (1u << LCD4_E_BIT)) || !(pb & LCD4_RW)) return pins;
+    const bool low = m_lcd.next_nibble_low();
+
+    u8 value;
+    if (pb & LCD4_RS) {
+        value = m_lcd_data;
+    } else {
+        value = m_lcd.read_status();
+        if (!low) {
+            // The busy-wait loop tests BF from the high half
+            if (value & 0x80) note_lcd_busy_read();
+            else              m_lcd_poll.valid = false;
         }
-        else {
-            // Serial: ACIA usually at $5000, VIA at $6000
-            if (addr >= 0x6000 && addr <= 0x7FFF) return m_via.read(addr - 0x6000);
-            if (addr >= 0x4000 && addr <= 0x5FFF) return m_acia.read(addr - 0x4000); 
+    }
+    return (u8)((pins & 0xF0) | (low ? (value & 0x0F) : (value >> 4)));
+}
+
+void mb_driver::note_lcd_busy_read() {
+    lcd_poll cur;
+    cur.valid = true;
+    cur.pc = m_cpu->get_pc();
+    cur.a = m_cpu->get_a();
+    cur.x = m_cpu->get_x();
+    cur.y = m_cpu->get_y();
+    cur.s = m_cpu->get_sp();
+    cur.p = m_cpu->get_flags();
+    cur.cycle = m_cpu->total_cycles();
+    cur.lcd_accesses = m_lcd.access_count();
+    cur.ram_generation = m_ram.generation();
+
+    const lcd_poll& prev = m_lcd_poll;
+    bool same_state = prev.valid && prev.pc == cur.pc && prev.a == cur.a && prev.x == cur.x &&
+                      prev.y == cur.y && prev.s == cur.s && prev.p == cur.p &&
+                      prev.lcd_accesses == cur.lcd_accesses && prev.ram_generation == cur.ram_generation;
+
+    // Breakpoints / heatmap must see every iteration
+    if (same_state && cur.cycle > prev.cycle && !m_cpu->debug().active()) {
+        m_lcd_spin_period = cur.cycle - prev.cycle;
+        m_cpu->abort_timeslice();   // Return to run() right after this read
+    }
+    m_lcd_poll = cur;
+}
+
+// WHAT: Called at the end of the slice that detected a spin, i.e. just after
+//       the read instruction at m_lcd_poll.cycle. Returns the new 'now'.
+u64 mb_driver::skip_lcd_poll(u64 now, u64 limit) {
+    const u64 period = m_lcd_spin_period;
+    const u64 read = m_lcd_poll.cycle;
+    const u64 until = m_lcd.busy_until();
+    m_lcd_spin_period = 0;
+
+    // Reads at read + k * period still see BF set while they are < until
+    if (until <= read + period || limit <= now) return now;
+    u64 loops = (until - read - 1) / period;
+    if (loops > (limit - now) / period) loops = (limit - now) / period;
+    if (loops == 0) return now;
+    u64 end = now + loops * period;
+
+    // The VIA keeps running; an interrupt ends the skip at the first loop
+    // boundary at or after it (where the real CPU would be taking it).
+    m_via_catchup = true;
+    for (; m_via_cycle < end; m_via_cycle++) {
+        if (m_cpu->interrupt_pending()) {
+            u64 boundary = (m_via_cycle <= now) ? now : now + ((m_via_cycle - now + period - 1) / period) * period;
+            if (boundary < end) end = boundary;
+            if (m_via_cycle >= end) break;
         }
+        m_via.clock();
+    }
+    m_via_catchup = false;
+    if (end == now) return now;
 
-        // Common RAM
-        if (addr < 0x4000) return m_ram.read(addr);
-        
-        return 0xEA; // Open Bus
-    };
-
-    auto write_logic = [this](u16 addr, u8 data) {
-        if (addr >= 0x8000)      m_rom.write(addr - 0x8000, data);
-        else if (addr < 0x4000)  m_ram.write(addr, data);
-        else {
-            // I/O Write Logic
-            if (m_current_type == MachineType::SCHEMATIC_1_BASIC) {
-                if (addr >= 0x6000) m_via.write(addr - 0x6000, data);
-            }
-            else {
-                if (addr >= 0x6000) m_via.write(addr - 0x6000, data);
-                else if (addr >= 0x4000) m_acia.write(addr - 0x4000, data);
+    m_cpu->skip_cycles(end - now);
+    m_lcd_poll.cycle += end - now;
+    m_lcd_poll_skipped += end - now;
+    m_next_sync = (end / SLICE_CYCLES + 1) * SLICE_CYCLES;
+    return end;
+}
+
+// ============================================================================
+//  External Inputs
+// ============================================================================
+void mb_driver::serial_rx(u8 c)            { submit_input(input_type::SERIAL_RX, c); }
+void mb_driver::set_port_a_input(u8 data)  { submit_input(input_type::PORT_A, data); }
+void mb_driver::set_port_b_input(u8 data)  { submit_input(input_type::PORT_B, data); }
+void mb_driver::set_ca1(bool state)        { submit_input(input_type::CA1, state ? 1 : 0); }
+void mb_driver::set_cb1(bool state)        { submit_input(input_type::CB1, state ? 1 : 0); }
+void mb_driver::set_cb2(bool state)        { submit_input(input_type::CB2, state ? 1 : 0); }
+void mb_driver::set_pb6(bool state)        { submit_input(input_type::PB6, state ? 1 : 0); }
+
+// WHAT: Journals (if recording) and applies a live input.
+// WHY:  During a replay the journal owns the inputs; live ones would make the
+//       run diverge from the recording, so they are dropped.
+bool mb_driver::submit_input(input_type type, u8 data, const u8* payload, u32 payload_len) {
+    if (m_journal.is_replaying()) {
+        std::cerr << "[Journal] Live input ignored during replay." << std::endl;
+        return false;
+    }
+    m_journal.record(m_cpu->total_cycles(), type, data, payload, payload_len);
+    apply_input(type, data, payload, payload_len);
+    return true;
+}
+
+void mb_driver::apply_input(input_type type, u8 data, const u8* payload, u32 payload_len) {
+    switch (type) {
+        case input_type::SERIAL_RX:    m_acia.rx_char(data); break;
+        case input_type::PORT_A:       m_via.set_port_a_input(data); break;
+        case input_type::PORT_B:       m_via.set_port_b_input(data); break;
+        case input_type::CA1:          m_via.set_ca1(data != 0); break;
+        case input_type::CB1:          m_via.set_cb1(data != 0); break;
+        case input_type::CB2:          m_via.set_cb2_input(data != 0); break;
+        case input_type::PB6:          m_via.set_pb6_input(data != 0); break;
+        case input_type::RESET:        reset_board(); break;
+        case input_type::CPU_RESET:    m_cpu->device_reset(); break;
+        case input_type::MACHINE_TYPE: configure_machine((MachineType)data); break;
+        case input_type::ROM_LOAD:     m_rom.load_image(payload, payload_len); break;
+        case input_type::PS2_BYTE:     m_kbd.queue(data, m_cpu->total_cycles()); break;
+        case input_type::SERIAL_TURBO:
+            m_serial_turbo = (data != 0);
+            m_tx_line_free = m_rx_line_free = 0;    // A character in flight finishes now
+            m_serial_event = 0;
+            break;
+    }
+}
+
+void mb_driver::replay_due_inputs(u64 now) {
+    while (m_journal.is_replaying() && m_journal.next_cycle() <= now) {
+        const input_event& ev = m_journal.peek();
+        if (ev.cycle != now) {
+            std::cerr << "[Journal] Warning: input due at cycle " << ev.cycle
+                      << " applied at " << now << " (replay has diverged)." << std::endl;
+        }
+        apply_input(ev.type, ev.data, ev.payload.data(), (u32)ev.payload.size());
+        m_journal.pop();
+    }
+}
+
+// ============================================================================
+//  Serial Host Bridge
+// ============================================================================
+void mb_driver::attach_serial(serial_bridge* bridge) {
+    // The backlog only exists with a journal active; at a detach (shutdown)
+    // give the host up to a second to take it.
+    if (m_serial && m_serial != bridge) {
+        for (int ms = 0; !m_serial_tx_backlog.empty() && !m_serial->closed() && ms < 1000; ms++) {
+            size_t n = 0;
+            while (n < m_serial_tx_backlog.size() && m_serial->tx().push((u8)m_serial_tx_backlog[n])) n++;
+            m_serial_tx_backlog.erase(0, n);
+            m_serial->notify();
+            if (!m_serial_tx_backlog.empty()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    m_serial_tx_backlog.clear();
+    m_serial = bridge;
+}
+
+void mb_driver::attach_sdcard(sd_card* card) {
+    if (!m_spi.attach(card, SPI_SD_CS)) {
+        std::cerr << "[SPI] No free chip select for the SD card." << std::endl;
+    }
+}
+
+// ============================================================================
+//  PS/2 Keyboard
+// ============================================================================
+//  Every scancode byte is journaled as it enters the keyboard's buffer; the
+//  frame timing after that is deterministic, so a replay needs no host input.
+// ============================================================================
+void mb_driver::connect_keyboard() {
+    // The interface drives PA and CA1 whenever the board is powered
+    m_kbd.data().disconnect_all();
+    m_kbd.ready().disconnect_all();
+    m_kbd.data().connect([this](u8 value, u8) { m_via.set_port_a_input(value); });
+    m_kbd.ready().connect([this](signal_edge edge) { m_via.set_ca1(edge == signal_edge::RISING); });
+    m_via.set_port_a_input(m_kbd.data().value());
+    m_via.set_ca1(m_kbd.ready().state());
+}
+
+void mb_driver::keyboard_key(u16 key, bool down) {
+    u8 seq[3];
+    int n = ps2_keyboard::encode(key, down, seq);
+    if (m_kbd.space() < n) {
+        std::cerr << "[Keyboard] Buffer full, key dropped." << std::endl;
+        return;
+    }
+    for (int i = 0; i < n; i++) {
+        if (!submit_input(input_type::PS2_BYTE, seq[i])) return;
+    }
+}
+
+void mb_driver::keyboard_type(const std::string& text) {
+    m_kbd_typed += text;
+    service_keyboard(m_cpu->total_cycles());
+}
+
+void mb_driver::service_keyboard(u64 now) {
+    m_kbd.update(now);
+
+    // Next typed character once the buffer is empty (the byte in flight
+    // finishes first). During a replay the journal delivers the bytes.
+    while (!m_kbd_typed.empty() && m_kbd.space() == ps2_keyboard::QUEUE_SIZE && !m_journal.is_replaying()) {
+        char c = m_kbd_typed[0];
+        m_kbd_typed.erase(0, 1);
+
+        u16 key;
+        bool shift;
+        if (!ps2_keyboard::key_for_char(c, key, shift)) {
+            std::cerr << "[Keyboard] No key for character 0x" << std::hex << (int)(u8)c << std::dec << std::endl;
+            continue;
+        }
+        if (shift) keyboard_key(ps2_keyboard::KEY_LSHIFT, true);
+        keyboard_key(key, true);
+        keyboard_key(key, false);
+        if (shift) keyboard_key(ps2_keyboard::KEY_LSHIFT, false);
+    }
+    m_kbd.update(now);      // A frame due now starts now (run() needs the event ahead)
+}
+
+// ============================================================================
+//  Audio
+// ============================================================================
+void mb_driver::attach_audio(audio_out* out) {
+    if (m_audio && m_audio != out) m_audio->finish(m_cpu->total_cycles());
+    m_audio = out;
+    if (m_audio) m_audio->begin(m_via_cycle, m_cpu->clock(), audio_levels());
+}
+
+u64 mb_driver::via_time() const {
+    return m_via_catchup ? m_via_cycle : m_cpu->total_cycles();
+}
+
+u8 mb_driver::audio_levels() {
+    u8 levels = 0;
+    if (m_via.port_b().value() & 0x80) levels |= 1u << audio_out::SRC_PB7;
+    if (m_via.cb2().state())           levels |= 1u << audio_out::SRC_CB2;
+    return levels;
+}
+
+void mb_driver::serial_wake() {
+    // Called mid-instruction: service right after it
+    m_serial_event = 0;
+    m_cpu->abort_timeslice();
+}
+
+void mb_driver::service_serial(u64 now) {
+    const u64 char_time = m_serial_turbo ? 0 : m_acia.char_cycles(m_cpu->clock());
+
+    // TX backlog (journal active) goes out first, as the ring drains
+    if (m_serial && !m_serial_tx_backlog.empty()) {
+        size_t n = 0;
+        while (n < m_serial_tx_backlog.size() && m_serial->tx().push((u8)m_serial_tx_backlog[n])) n++;
+        m_serial_tx_backlog.erase(0, n);
+        if (n && m_serial->tx().size() <= n) m_serial->notify();     // Host side may be idle
+    }
+
+    // TX: ACIA -> host (and the UI terminal)
+    // With a journal active the transmitter must not wait on the host (that
+    // timing isn't recorded, so a replay would diverge): bytes the ring
+    // can't take wait in the backlog instead.
+    const bool journaled = m_journal.is_recording() || m_journal.is_replaying();
+    const bool tx_room = !m_serial || journaled ||
+                         (m_serial_tx_backlog.empty() && m_serial->tx().space() > 0);
+    if (m_acia.has_tx_data() && now >= m_tx_line_free && tx_room) {
+        m_tx_line_free = now + char_time;
+        u8 c = m_acia.pop_tx_data();
+        if (m_serial) {
+            // Wake the host side when this is the only byte queued: it goes
+            // idle only on an empty ring, so that's the one push it can miss.
+            // (Testing empty() before the push races with its last write.)
+            if (m_serial_tx_backlog.empty() && m_serial->tx().push(c)) {
+                if (m_serial->tx().size() == 1) m_serial->notify();
+            } else {
+                m_serial_tx_backlog += (char)c;
             }
         }
-    };
+        if (m_serial_console.size() >= SERIAL_CONSOLE_MAX) m_serial_console.erase(0, SERIAL_CONSOLE_MAX / 2);
+        m_serial_console += (char)c;
+    }
 
-    map.install(0x0000, 0xFFFF, read_logic, write_logic);
-    
-    // Debug Handler (Safe Access)
-    map.install_debug_handler(0x0000, 0xFFFF, [this](u16 addr) -> u8 {
-        if (addr >= 0x8000) return m_rom.read(addr - 0x8000);
-        if (addr < 0x4000)  return m_ram.read(addr);
-        
-        // I/O Debug
-        if (addr >= 0x6000 && addr <= 0x7FFF) return m_via.peek(addr - 0x6000);
-        if (m_current_type == MachineType::SCHEMATIC_2_SERIAL) {
-            if (addr >= 0x4000 && addr <= 0x5FFF) return m_acia.read(addr - 0x4000);
+    // RX: host -> ACIA. During a replay the journal delivers the bytes.
+    const bool rx_open = !m_acia.rx_full() && !m_journal.is_replaying();
+    if (rx_open && now >= m_rx_line_free) {
+        bool sent = false;
+        if (!m_serial_typed.empty()) {
+            serial_rx((u8)m_serial_typed[0]);
+            m_serial_typed.erase(0, 1);
+            sent = true;
+        } else if (m_serial) {
+            u8 c;
+            if (m_serial->rx().pop(c)) {
+                serial_rx(c);
+                sent = true;
+                // Same idea: the host side stops reading only on a full ring.
+                // Waking it once half of that has drained (each count is
+                // passed exactly once) lets it refill in one large read.
+                if (m_serial->rx().space() == m_serial->rx().capacity() / 2) m_serial->notify();
+            }
         }
-        return 0x00;
-    });
+        if (sent) m_rx_line_free = now + char_time;
+    }
+
+    // Next due: the end of a character something is waiting for. Bytes
+    // that arrive from the host later are picked up at a sync mark.
+    m_serial_event = SERIAL_IDLE;
+    if (m_acia.has_tx_data() && m_tx_line_free > now) m_serial_event = m_tx_line_free;
+    const bool rx_waiting = !m_serial_typed.empty() || (m_serial && !m_serial->rx().empty());
+    if (!m_acia.rx_full() && rx_waiting && m_rx_line_free > now && m_rx_line_free < m_serial_event) {
+        m_serial_event = m_rx_line_free;
+    }
+}
+
+// ============================================================================
+//  Input Journal Control
+// ============================================================================
+//  NOTE: Both modes assume the board has just been powered on (init + reset),
+//        which is the only state the journal can reproduce without a snapshot.
+// ============================================================================
+bool mb_driver::start_recording(const std::string& path) {
+    u32 crc = input_journal::crc32(m_rom.get_data_ptr(), 32768);
+    return m_journal.start_recording(path, (u8)m_current_type, crc, m_cpu->total_cycles());
+}
+
+bool mb_driver::start_replay(const std::string& path) {
+    if (!m_journal.start_replay(path)) return false;
+
+    if (m_journal.rom_crc() != input_journal::crc32(m_rom.get_data_ptr(), 32768)) {
+        std::cerr << "[Journal] Warning: ROM differs from the one the journal was recorded with." << std::endl;
+    }
+    configure_machine((MachineType)m_journal.machine_type());
+    return true;
+}
+
+// ============================================================================
+//  Page Generations (Debugger Cache Invalidation)
+// ============================================================================
+u32 mb_driver::page_generation(u8 page) const {
+    if (page >= 0x80) return m_rom.page_generation(page - 0x80);
+    if (page < 0x40)  return m_ram.page_generation(page);
+    return 0;
+}
+
+u64 mb_driver::take_ram_dirty() {
+    u64 dirty[2];
+    m_ram.take_dirty(dirty);
+    return dirty[0];    // Pages $40-$7F of the chip are never read back
+}
+
+// ============================================================================
+//  Snapshot (Diff Support)
+// ============================================================================
+void mb_driver::capture_snapshot(machine_snapshot& snap) {
+    snap.cycle = m_cpu->total_cycles();
+    snap.machine_type = (u8)m_current_type;
+
+    snap.cpu[machine_snapshot::CPU_A]   = m_cpu->get_a();
+    snap.cpu[machine_snapshot::CPU_X]   = m_cpu->get_x();
+    snap.cpu[machine_snapshot::CPU_Y]   = m_cpu->get_y();
+    snap.cpu[machine_snapshot::CPU_S]   = m_cpu->get_sp();
+    snap.cpu[machine_snapshot::CPU_P]   = m_cpu->get_flags();
+    snap.cpu[machine_snapshot::CPU_PCL] = (u8)(m_cpu->get_pc() & 0xFF);
+    snap.cpu[machine_snapshot::CPU_PCH] = (u8)(m_cpu->get_pc() >> 8);
+
+    std::memcpy(snap.ram, m_ram.get_data_ptr(), sizeof(snap.ram));
+    std::memcpy(snap.rom, m_rom.get_data_ptr(), sizeof(snap.rom));
+    for (int i = 0; i < 16; i++) snap.via[i]  = m_via.peek((u16)i);
+    for (int i = 0; i < 4; i++)  snap.acia[i] = m_acia.peek((u16)i);
+}
+
+// ============================================================================
+//  The Memory Map (74HC00 Logic)
+// ============================================================================
+//  The decode is U4 (one 74HC00) wired as on Ben's schematic, compiled once
+//  per schematic into address ranges; each range gets its device's
+//  handlers. Edit decoder_netlist() to model a different decoder.
+// ============================================================================
+void mb_driver::decoder_netlist(address_decoder& dec, MachineType type) {
+    using ad = address_decoder;
+    const ad::net A13 = ad::A(13), A14 = ad::A(14), A15 = ad::A(15);
+
+    const int u4 = dec.add_package("U4");
+    const ad::net not_a15 = dec.nand(u4, A15, A15);             // /A15
+    const ad::net ram_ce  = dec.nand(u4, ad::PHI2, not_a15);    // Low: PHI2 high, A15 low
+    const ad::net io_cs   = dec.nand(u4, not_a15, A14);         // Low: A15 low, A14 high
+
+    // ROM /CE = /A15
+    dec.select(BUS_ROM, "ROM", { { not_a15, false } });
+    // RAM /CE from the gate, /OE = A14. Its writes at $4000-$7FFF land
+    // where no read can reach, so RAM only answers where /OE lets it.
+    dec.select(BUS_RAM, "RAM", { { ram_ce, false }, { A14, false } });
+    // VIA CS1 = A13, /CS2B = the I/O select
+    dec.select(BUS_VIA, "VIA", { { A13, true }, { io_cs, false } });
+
+    if (type == MachineType::SCHEMATIC_2_SERIAL) {
+        // ACIA CS0 = /A13 (U4's last gate), /CS1 = the I/O select
+        const ad::net not_a13 = dec.nand(u4, A13, A13);
+        dec.select(BUS_ACIA, "ACIA", { { not_a13, true }, { io_cs, false } });
+    }
+}
+
+void mb_driver::map_setup(address_map& map, MachineType type) {
+    address_decoder dec;
+    decoder_netlist(dec, type);
+    if (!dec.compile()) return;
+
+    for (const address_decoder::range& r : dec.ranges()) {
+        install_bus_device(map, r.device, r.start, r.end);
+    }
+}
+
+void mb_driver::install_bus_device(address_map& map, int device, u16 start, u16 end) {
+    // Each chip sees only its own address pins
+    switch (device) {
+        case BUS_RAM:
+            map.install(start, end,
+                [this](u16 addr) { return m_ram.read(addr & RAM_LINES); },
+                [this](u16 addr, u8 data) { m_ram.write(addr & RAM_LINES, data); });
+            install_direct(map, start, end, m_ram.get_data_ptr(), RAM_LINES);
+            break;
+        case BUS_ROM:
+            map.install(start, end,
+                [this](u16 addr) { return m_rom.read(addr & ROM_LINES); },
+                [this](u16 addr, u8 data) { m_rom.write(addr & ROM_LINES, data); });
+            install_direct(map, start, end, m_rom.get_data_ptr(), ROM_LINES);
+            break;
+        case BUS_VIA:
+            map.install(start, end,
+                [this](u16 addr) { return m_via.read(addr & VIA_LINES); },
+                [this](u16 addr, u8 data) { m_via.write(addr & VIA_LINES, data); });
+            map.install_debug_handler(start, end, [this](u16 addr) { return m_via.peek(addr & VIA_LINES); });
+            break;
+        case BUS_ACIA:
+            map.install(start, end,
+                [this](u16 addr) { return m_acia.read(addr & ACIA_LINES); },
+                [this](u16 addr, u8 data) { m_acia.write(addr & ACIA_LINES, data); });
+            map.install_debug_handler(start, end, [this](u16 addr) { return m_acia.peek(addr & ACIA_LINES); });
+            break;
+        default:
+            // Nothing selected
+            map.install(start, end,
+                [](u16) -> u8 { return 0xEA; },     // Open Bus
+                [](u16, u8) {});
+            map.install_debug_handler(start, end, [](u16) -> u8 { return 0x00; });
+            break;
+    }
+}
+
+void mb_driver::install_direct(address_map& map, u16 start, u16 end, const u8* data, u16 lines) {
+    // Debugger dumps can memcpy a range that maps straight onto the array
+    const u16 first = start & lines;
+    if ((start & 0xFF) == 0 && (end & 0xFF) == 0xFF && (u32)first + (end - start) <= lines) {
+        map.install_debug_direct(start, end, data + first);
+    }
 }
@@ -1,20 +1,31 @@
 #pragma once
 #include "../emu/machine.h"
+#include "../emu/map.h"
 #include "../devices/cpu/m6502.h"
 #include "../devices/memory/28c256.h"
 #include "../devices/memory/62256.h"
 #include "../devices/io/w65c22.h"
 #include "../devices/io/w65c51.h"
+#include "../devices/io/ps2kbd.h"
+#include "../devices/io/spi.h"
+#include "../devices/storage/sdcard.h"
 #include "../devices/video/nhd_0216k1z.h"
-#include "../devices/logic/74hc00.h"
+#include "../devices/logic/decoder.h"
+#include "../emu/audio.h"
+#include "../emu/irq.h"
+#include "../emu/journal.h"
+#include "../emu/serial.h"
+#include "../emu/snapshot.h"
 
 // ============================================================================
 // Hardware variants
 // ============================================================================
 enum class MachineType {
-    SCHEMATIC_1_BASIC,  // LCD ON PORT B (8-BIT), NO Serial
-    SCHEMATIC_2_SERIAL  // LCD
+    SCHEMATIC_1_BASIC,      // LCD ON PORT B (8-BIT), NO Serial
+    SCHEMATIC_2_SERIAL,     // LCD
+    SCHEMATIC_3_KEYBOARD    // LCD ON PORT B (4-BIT), PS/2 keyboard on PORT A + CA1
 };
+static constexpr int MACHINE_TYPE_COUNT = 3;
 
 // ============================================================================
 //  Driver: Ben Eater 6502 Computer
@@ -32,22 +43,89 @@ public:
     void set_machine_type(MachineType type);
     MachineType get_machine_type() const { return m_current_type; }
 
+    // --- External Inputs ---
+    // Every stimulus from outside the board goes through these so that the
+    // input journal can stamp it with the CPU cycle (and replay it later).
+    void serial_rx(u8 c);                   // Byte arriving on the ACIA RxD line
+    void set_port_a_input(u8 data);         // VIA PA0-PA7 pin levels
+    void set_port_b_input(u8 data);         // VIA PB0-PB7 pin levels
+    void set_ca1(bool state);
+    void set_cb1(bool state);
+    void set_cb2(bool state);
+    void set_pb6(bool state);
+    void reset_cpu();                       // Debugger "Reset CPU" (CPU only)
+
+    // --- Serial Host Bridge ---
+    // WHAT: Routes the ACIA to/from a host bridge (nullptr = UI console only).
+    //       The bridge must outlive the board or be detached first.
+    //       Detaching hands any TX backlog to the old bridge first.
+    void attach_serial(serial_bridge* bridge);
+    // WHAT: Text typed into the UI terminal; fed to the ACIA like host bytes.
+    void serial_type(const std::string& text) { m_serial_typed += text; }
+    // WHAT: The most recent ACIA output (up to SERIAL_CONSOLE_MAX bytes).
+    const std::string& serial_console() const { return m_serial_console; }
+    // WHAT: Line timing. Off (default): every character takes its frame
+    //       time at the programmed baud rate. On: Tx Empty is ready again
+    //       right after each write and RX bytes arrive as fast as the
+    //       firmware reads them. Journaled, like any other input.
+    void set_serial_turbo(bool on) { submit_input(input_type::SERIAL_TURBO, on ? 1 : 0); }
+    bool serial_turbo() const { return m_serial_turbo; }
+
+    // --- PS/2 Keyboard (Schematic 3) ---
+    // WHAT: A host key went down or up ('key' is a set 2 code, see
+    //       ps2_keyboard). The whole make/break sequence is queued, or
+    //       dropped if the keyboard's buffer can't take all of it.
+    void keyboard_key(u16 key, bool down);
+    // WHAT: Text typed as key presses (Shift added where needed), one
+    //       character at a time as the keyboard's buffer drains.
+    void keyboard_type(const std::string& text);
+    // WHAT: True once everything typed has reached the VIA.
+    bool keyboard_idle() const { return m_kbd_typed.empty() && m_kbd.idle(); }
+    const ps2_keyboard& get_keyboard() const { return m_kbd; }
+
+    // --- SD Card (Schematic 2) ---
+    // WHAT: Puts 'card' on the SPI bus bit-banged on port A (nullptr =
+    //       remove it). The card must outlive the board or be detached.
+    //       PA0 = SCK, PA1 = MOSI, PA2 = /CS, PA7 = MISO.
+    void attach_sdcard(sd_card* card);
+    const spi_bus& get_spi() const { return m_spi; }
+
+    // --- Audio ---
+    // WHAT: Streams the sound pins (VIA PB7 and CB2) to 'out' (nullptr =
+    //       off). Detaching lets the last edge ring out first.
+    void attach_audio(audio_out* out);
+
+    // --- Input Journal (Record / Replay) ---
+    bool start_recording(const std::string& path);
+    bool start_replay(const std::string& path);
+    void stop_journal() { m_journal.stop(); }
+    const input_journal& get_journal() const { return m_journal; }
+
     // Expose components for UI
     m6502_p* get_cpu() override;
     w65c22* get_via() override { return &m_via; }
     w65c51* get_acia() override { return &m_acia; }
     nhd_0216k1z* get_lcd() { return &m_lcd; }
+    ram_62256* get_ram() { return &m_ram; }
 
-    bool load_rom(const char* filename) {
-        std::cout << "[Driver] Attempting to load ROM from: " << filename << std::endl;
-        bool result = m_rom.load_from_file(filename);
-        if (result) {
-            std::cout << "[Driver] Success! ROM loaded." << std::endl;
-        } else {
-            std::cerr << "[Driver] Failed to load ROM." << std::endl;
-        }
-        return result;
-    }
+    bool load_rom(const char* filename);
+
+    // WHAT: Change counter for the memory behind a CPU page ($xx00-$xxFF).
+    // WHY:  Debugger caches (disassembly) compare it to skip unchanged pages.
+    // NOTE: I/O pages report 0: registers are not code and are never cached
+    //       as stale.
+    u32 page_generation(u8 page) const;
+
+    // WHAT: RAM pages changed since the last call (bit n = page $n00;
+    //       RAM is $0000-$3FFF). Clears them: one owner, the memory snapshot.
+    u64 take_ram_dirty();
+
+    // WHAT: CPU cycles skipped while the firmware polled the LCD busy flag.
+    u64 lcd_poll_cycles_skipped() const { return m_lcd_poll_skipped; }
+
+    // WHAT: Copies CPU registers, RAM, ROM and I/O registers into 'snap'
+    //       (side-effect free) for diffing.
+    void capture_snapshot(machine_snapshot& snap);
 
 private:
     MachineType m_current_type = MachineType::SCHEMATIC_1_BASIC;
@@ -62,10 +140,141 @@ private:
     w65c22        m_via; // U5 
     w65c51        m_acia; // U7 (ACIA)
     nhd_0216k1z   m_lcd; // U3 (LCD)
+    ps2_keyboard  m_kbd; // PS/2 keyboard + interface (Schematic 3)
+    spi_bus       m_spi; // SD card module on port A (Schematic 2)
+
+    // /IRQ wire shared by the VIA and the ACIA
+    enum irq_source { IRQ_SRC_VIA, IRQ_SRC_ACIA };
+    irq_merger    m_irq;
+
+    u8   m_lcd_data = 0x00;         // Byte latched by a data read cycle
 
-    u8   m_port_b_data = 0x00;
-    bool m_last_e_state = false;    // To detect the edge of the Enable pin
+    // LCD control pins on VIA port A (Schematic 1)
+    static constexpr u8 LCD_RS = 0x20;  // PA5
+    static constexpr u8 LCD_RW = 0x40;  // PA6
+    static constexpr int LCD_E_BIT = 7; // PA7
+
+    // LCD pins on VIA port B (Schematic 3, 4-bit): PB0-PB3 = DB4-DB7
+    static constexpr u8 LCD4_RS = 0x10;     // PB4
+    static constexpr u8 LCD4_RW = 0x20;     // PB5
+    static constexpr int LCD4_E_BIT = 6;    // PB6
+
+    // SD card module on VIA port A (Schematic 2)
+    static constexpr u8 SPI_SCK  = 0x01;    // PA0
+    static constexpr u8 SPI_MOSI = 0x02;    // PA1
+    static constexpr u8 SPI_SD_CS = 0x04;   // PA2
+    static constexpr u8 SPI_MISO = 0x80;    // PA7
+
+    // WHAT: What the LCD puts on PB during a read cycle (E high, RW = 1).
+    u8 lcd_bus_read(u8 pins);
+    u8 lcd_bus_read_4bit(u8 pins);
+
+    // --- LCD Busy-Poll Elision ---
+    // WHAT: Detects firmware spinning on the busy flag and jumps straight
+    //       to the cycle where it clears.
+    // HOW:  Two busy reads at the same PC, with the same registers and no
+    //       LCD access or RAM change in between, prove the loop is idle and
+    //       periodic. The slice is cut after the read; run() then skips
+    //       whole loop periods (clocking the VIA through them) up to the
+    //       last read that would still see BF set.
+    struct lcd_poll {
+        bool valid = false;
+        u16  pc = 0;
+        u8   a = 0, x = 0, y = 0, s = 0, p = 0;
+        u64  cycle = 0;             // Cycle of the read instruction
+        u32  lcd_accesses = 0;
+        u32  ram_generation = 0;
+    };
+    lcd_poll m_lcd_poll;
+    u64  m_lcd_spin_period = 0;     // Set when a spin was detected (one shot)
+    u64  m_lcd_poll_skipped = 0;    // Total cycles skipped
+    void note_lcd_busy_read();
+    u64  skip_lcd_poll(u64 now, u64 limit);
+
+    // --- Serial ---
+    // WHAT: Moves one byte each way between the ACIA and the host side.
+    // WHEN: At instruction boundaries only (so RX bytes are journaled on a
+    //       cycle that depends only on the instruction stream): at every
+    //       VIA sync mark, and at m_serial_event, which run() treats as a
+    //       slice end like a journal event.
+    // HOW:  Each direction is a line that stays busy for one character time
+    //       (0 in turbo mode) after a byte starts. TX also needs room in the
+    //       bridge's ring; RX needs the ACIA's receive register to be empty.
+    //       The ACIA's data callbacks pull the next event to "now" and end
+    //       the timeslice, so a write/read is answered right after the
+    //       instruction that did it.
+    static constexpr size_t SERIAL_CONSOLE_MAX = 8192;
+    static constexpr u64 SERIAL_IDLE = ~0ull;
+    serial_bridge* m_serial = nullptr;
+    std::string m_serial_typed;     // UI input not yet delivered
+    std::string m_serial_console;   // ACIA output for the UI terminal
+    std::string m_serial_tx_backlog;    // TX the ring couldn't take (journal active)
+    bool m_serial_turbo = false;
+    u64  m_serial_event = SERIAL_IDLE;  // Cycle service_serial is next due
+    u64  m_tx_line_free = 0;        // Cycle the transmitter finishes its character
+    u64  m_rx_line_free = 0;        // Cycle the next RX character can complete
+    void service_serial(u64 now);
+    void serial_wake();
+
+    // --- Keyboard ---
+    // WHAT: Applies the keyboard's line changes due by 'now' and feeds it
+    //       the next typed character once its buffer is empty.
+    // WHEN: At instruction boundaries: run() treats m_kbd.next_event() as a
+    //       slice end (like m_serial_event), so CA1 rises on the cycle the
+    //       frame completes, plus at most one instruction.
+    std::string m_kbd_typed;        // Typed text not yet queued as scancodes
+    void service_keyboard(u64 now);
+    void connect_keyboard();
+
+    // --- Audio ---
+    // WHAT: Pin edges are stamped on the VIA's own time line: the cycle it
+    //       is being clocked through while catching up, otherwise the CPU
+    //       cycle of the register write that moved the pin.
+    // NOTE: A catch-up edge that falls before a write in the same slice is
+    //       heard at the write (audio_out keeps time monotonic); at most
+    //       SLICE_CYCLES late. Samples are emitted up to m_via_cycle, the
+    //       point no later edge can precede.
+    audio_out* m_audio = nullptr;
+    bool m_via_catchup = false;     // Inside a VIA catch-up loop
+    u64  via_time() const;
+    u8   audio_levels();
+
+    // --- Timing ---
+    // WHAT: The VIA is caught up on elapsed cycles at the first instruction
+    //       boundary past every SLICE_CYCLES mark.
+    // WHY:  Sync points then depend only on the instruction stream, not on how
+    //       the host chops run() calls into frames, which keeps replays exact.
+    static constexpr u64 SLICE_CYCLES = 64;
+    u64 m_via_cycle = 0;            // CPU cycle the VIA has been clocked up to
+    u64 m_next_sync = SLICE_CYCLES; // Next quantum mark
+
+    // --- Input Journal ---
+    input_journal m_journal;
+    bool submit_input(input_type type, u8 data, const u8* payload = nullptr, u32 payload_len = 0);
+    void apply_input(input_type type, u8 data, const u8* payload = nullptr, u32 payload_len = 0);
+    void replay_due_inputs(u64 now);
+    void reset_board();
 
     // --- Wiring Logic ---
-    void map_setup(class address_map& map);
+    void configure_machine(MachineType type);
+
+    // WHAT: One fully decoded address map per schematic, built by init().
+    // WHY:  Switching schematics swaps the CPU's map pointer; no access
+    //       ever asks which schematic is fitted.
+    address_map m_maps[MACHINE_TYPE_COUNT];
+    void map_setup(address_map& map, MachineType type);
+
+    // --- Address Decoding ---
+    // Chips on the bus (address_decoder device numbers)
+    enum bus_device { BUS_RAM, BUS_ROM, BUS_VIA, BUS_ACIA };
+    // Address pins wired to each chip
+    static constexpr u16 RAM_LINES  = 0x7FFF;   // A0-A14
+    static constexpr u16 ROM_LINES  = 0x7FFF;   // A0-A14
+    static constexpr u16 VIA_LINES  = 0x000F;   // RS0-RS3 = A0-A3
+    static constexpr u16 ACIA_LINES = 0x0003;   // RS0-RS1 = A0-A1
+
+    // WHAT: The glue logic of 'type' as a 74HC00 netlist.
+    void decoder_netlist(address_decoder& dec, MachineType type);
+    void install_bus_device(address_map& map, int device, u16 start, u16 end);
+    void install_direct(address_map& map, u16 start, u16 end, const u8* data, u16 lines);
 };
\ No newline at end of file
@@ -0,0 +1,376 @@
+#include "audio.h"
+#include "spsc.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#ifdef _WIN32
+#define popen  _popen
+#define pclose _pclose
+#endif
+
+// ============================================================================
+//  Tuning
+// ============================================================================
+static constexpr int    KERNEL_WIDTH = 16;          // Taps per edge (delay = half of it)
+static constexpr int    PHASES = 64;                // Sub-sample edge positions
+static constexpr int    DELTA_SIZE = 64;            // Pending-delta window (power of two > KERNEL_WIDTH)
+static constexpr double CUTOFF = 0.45;              // Pass band, fraction of the sample rate
+static constexpr double DC_POLE = 0.9995;           // Coupling capacitor (~4 Hz at 48 kHz)
+static constexpr double VOLUME = 24000.0;           // Full-scale step in sample units
+static constexpr float  PIN_STEP = 0.5f;            // Each pin is half of full scale
+static constexpr int    BLOCK = 256;                // Samples synthesized per push
+static constexpr size_t RING_SAMPLES = 1 << 16;     // ~1.4 s between emulation and disk
+static constexpr int    WRITER_PERIOD_MS = 20;      // Writer drains at least this often
+
+// ============================================================================
+//  BLEP Kernel
+// ============================================================================
+//  WHAT: A Blackman-windowed sinc impulse for each sub-sample position. An
+//        edge adds one (scaled by its height) to the delta buffer; the
+//        running sum of the deltas is then a band-limited step.
+//  HOW:  Each phase is normalized to sum to exactly 1, so the integrated
+//        level always lands on the pin level (no drift between edges).
+// ============================================================================
+struct blep_kernel {
+    float taps[PHASES][KERNEL_WIDTH];
+
+    blep_kernel() {
+        const double pi = 3.14159265358979323846;
+        for (int p = 0; p < PHASES; p++) {
+            const double frac = (double)p / PHASES;
+            double sum = 0;
+            for (int k = 0; k < KERNEL_WIDTH; k++) {
+                const double d = k - KERNEL_WIDTH / 2 - frac;      // Samples from the (delayed) edge
+                const double x = 2.0 * CUTOFF * d;
+                const double sinc = (x == 0.0) ? 1.0 : std::sin(pi * x) / (pi * x);
+                double n = (d + KERNEL_WIDTH / 2.0) / KERNEL_WIDTH;
+                if (n < 0) n = 0;
+                if (n > 1) n = 1;
+                const double window = 0.42 - 0.5 * std::cos(2 * pi * n) + 0.08 * std::cos(4 * pi * n);
+                taps[p][k] = (float)(sinc * window);
+                sum += taps[p][k];
+            }
+            for (int k = 0; k < KERNEL_WIDTH; k++) taps[p][k] = (float)(taps[p][k] / sum);
+        }
+    }
+};
+
+static const blep_kernel& kernel() {
+    static const blep_kernel k;
+    return k;
+}
+
+// ============================================================================
+//  WAV Header
+// ============================================================================
+//  16-bit PCM mono, little-endian (the host byte order on every target).
+//  Sizes start as 0xFFFFFFFF ("until end of stream", what readers expect
+//  from a pipe) and are patched on close when the output is a file.
+// ============================================================================
+static void put_u16(u8* p, u16 v) { p[0] = (u8)v; p[1] = (u8)(v >> 8); }
+static void put_u32(u8* p, u32 v) { put_u16(p, (u16)v); put_u16(p + 2, (u16)(v >> 16)); }
+
+static bool write_wav_header(FILE* f, u32 rate, u32 data_bytes) {
+    u8 h[44];
+    std::memcpy(h, "RIFF", 4);
+    put_u32(h + 4, data_bytes == 0xFFFFFFFF ? data_bytes : data_bytes + 36);
+    std::memcpy(h + 8, "WAVEfmt ", 8);
+    put_u32(h + 16, 16);            // fmt chunk size
+    put_u16(h + 20, 1);             // PCM
+    put_u16(h + 22, 1);             // Mono
+    put_u32(h + 24, rate);
+    put_u32(h + 28, rate * 2);      // Bytes per second
+    put_u16(h + 32, 2);             // Block align
+    put_u16(h + 34, 16);            // Bits per sample
+    std::memcpy(h + 36, "data", 4);
+    put_u32(h + 40, data_bytes);
+    return std::fwrite(h, 1, sizeof(h), f) == sizeof(h);
+}
+
+// ============================================================================
+//  State
+// ============================================================================
+struct audio_out::impl {
+    // --- Synthesis (emulation thread) ---
+    bool   started = false;
+    u64    origin = 0;                  // Cycle of sample 0
+    double samples_per_cycle = 0;
+    u64    last_cycle = 0;              // Latest time seen (clamps late edges)
+    u8     levels = 0;                  // Bit n = source n high
+    u64    next_sample = 0;             // First sample not yet emitted
+    u64    pending_end = 0;             // Deltas may exist below this sample
+    float  delta[DELTA_SIZE] = {};
+    double acc = 0, acc_prev = 0;       // Integrated level (previous sample)
+    double dc = 0;                      // DC blocker output
+
+    // --- Writer thread ---
+    spsc_fifo<s16> ring{RING_SAMPLES};
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> wake_pending{false};
+    std::atomic<u64> written{0};
+    FILE* file = nullptr;
+    bool is_pipe = false;
+    bool write_failed = false;
+
+    double time_of(u64 cycle) const { return (double)(cycle - origin) * samples_per_cycle; }
+
+    void emit(u64 until);
+    void push(const s16* samples, size_t n);
+    void push_zeros(u64 n);
+    void wake();
+    void writer_main();
+    void drain();
+};
+
+audio_out::audio_out() : m_impl(std::make_unique<impl>()) {}
+audio_out::~audio_out() { close(); }
+
+bool audio_out::is_open() const { return m_impl->file != nullptr; }
+u64 audio_out::samples_written() const { return m_impl->written.load(std::memory_order_relaxed); }
+
+// ============================================================================
+//  Open / Close
+// ============================================================================
+bool audio_out::open(const std::string& path) {
+    close();
+    impl& s = *m_impl;
+
+    s.is_pipe = (!path.empty() && path[0] == '|');
+    s.file = s.is_pipe ? popen(path.c_str() + 1, "w") : std::fopen(path.c_str(), "wb");
+    if (!s.file || !write_wav_header(s.file, SAMPLE_RATE, 0xFFFFFFFF)) {
+        std::cerr << "[Audio] Error: Could not open " << path << std::endl;
+        if (s.file) s.is_pipe ? pclose(s.file) : std::fclose(s.file);
+        s.file = nullptr;
+        return false;
+    }
+#ifndef _WIN32
+    // A player that exits should end the audio, not the emulator
+    if (s.is_pipe) std::signal(SIGPIPE, SIG_IGN);
+#endif
+
+    m_name = path;
+    s.stopping = false;
+    s.wake_pending = false;
+    s.write_failed = false;
+    s.written = 0;
+    s.thread = std::thread([&s] { s.writer_main(); });
+    std::cerr << "[Audio] Writing " << SAMPLE_RATE << " Hz mono to " << path << std::endl;
+    return true;
+}
+
+void audio_out::close() {
+    impl& s = *m_impl;
+    if (!s.file) return;
+
+    s.stopping.store(true, std::memory_order_release);
+    s.cv.notify_one();
+    s.thread.join();
+
+    const u64 samples = s.written.load();
+    const u64 bytes = samples * 2;
+    if (s.is_pipe) {
+        pclose(s.file);
+    } else {
+        // Patch the real sizes in (a file over 4 GB keeps "until end")
+        if (bytes < 0xFFFFFFFFull - 36 && std::fseek(s.file, 0, SEEK_SET) == 0) {
+            write_wav_header(s.file, SAMPLE_RATE, (u32)bytes);
+        }
+        std::fclose(s.file);
+    }
+    s.file = nullptr;
+    s.started = false;
+    std::cerr << "[Audio] Wrote " << samples << " samples (" << (double)samples / SAMPLE_RATE
+              << " s) to " << m_name << std::endl;
+}
+
+// ============================================================================
+//  Synthesis
+// ============================================================================
+void audio_out::begin(u64 cycle, u32 clock_hz, u8 levels) {
+    impl& s = *m_impl;
+    s.started = (clock_hz != 0);
+    s.origin = cycle;
+    s.samples_per_cycle = clock_hz ? (double)SAMPLE_RATE / clock_hz : 0.0;
+    s.last_cycle = cycle;
+    s.levels = levels;
+    s.next_sample = 0;
+    s.pending_end = 0;
+    for (float& d : s.delta) d = 0;
+    s.acc = s.acc_prev = s.dc = 0;
+}
+
+void audio_out::set_level(int src, bool high, u64 cycle) {
+    impl& s = *m_impl;
+    if (!s.started) return;
+    const u8 bit = (u8)(1u << src);
+    const u8 levels = high ? (s.levels | bit) : (s.levels & ~bit);
+    if (levels == s.levels) return;
+    s.levels = levels;
+
+    if (cycle < s.last_cycle) cycle = s.last_cycle;
+    s.last_cycle = cycle;
+
+    // Everything before the edge's first tap is final now
+    const double t = s.time_of(cycle);
+    const u64 first = (u64)t;
+    s.emit(first);
+
+    int phase = (int)((t - (double)first) * PHASES);
+    if (phase >= PHASES) phase = PHASES - 1;
+    const float* taps = kernel().taps[phase];
+    const float height = high ? PIN_STEP : -PIN_STEP;
+    for (int k = 0; k < KERNEL_WIDTH; k++) {
+        s.delta[(first + k) & (DELTA_SIZE - 1)] += height * taps[k];
+    }
+    if (first + KERNEL_WIDTH > s.pending_end) s.pending_end = first + KERNEL_WIDTH;
+}
+
+void audio_out::advance(u64 cycle) {
+    impl& s = *m_impl;
+    if (!s.started) return;
+    if (cycle < s.last_cycle) cycle = s.last_cycle;
+    s.last_cycle = cycle;
+    s.emit((u64)s.time_of(cycle));
+}
+
+void audio_out::finish(u64 cycle) {
+    impl& s = *m_impl;
+    if (!s.started) return;
+    advance(cycle);
+    s.emit(s.pending_end);
+    s.started = false;
+}
+
+// WHAT: Produces samples [next_sample, until).
+void audio_out::impl::emit(u64 until) {
+    while (next_sample < until) {
+        // Settled: no edge still ringing and the capacitor has discharged.
+        // The rest is silence until the next edge.
+        if (next_sample >= pending_end && std::fabs(dc) * VOLUME < 0.5) {
+            dc = 0;
+            acc_prev = acc;
+            push_zeros(until - next_sample);
+            next_sample = until;
+            break;
+        }
+
+        s16 out[BLOCK];
+        const size_t n = (until - next_sample < (u64)BLOCK) ? (size_t)(until - next_sample) : (size_t)BLOCK;
+        for (size_t i = 0; i < n; i++) {
+            float& d = delta[next_sample & (DELTA_SIZE - 1)];
+            acc += d;
+            d = 0;
+            dc = acc - acc_prev + DC_POLE * dc;
+            acc_prev = acc;
+
+            double v = std::round(dc * VOLUME);
+            if (v > 32767) v = 32767;
+            if (v < -32768) v = -32768;
+            out[i] = (s16)v;
+            next_sample++;
+        }
+        push(out, n);
+    }
+}
+
+// ============================================================================
+//  Ring (emulation thread side)
+// ============================================================================
+//  A full ring means the disk (or the player) is behind: the emulation waits
+//  for it rather than drop samples, which would break the time base.
+// ============================================================================
+void audio_out::impl::push(const s16* samples, size_t n) {
+    spsc_fifo<s16>::span spans[2];
+    while (n) {
+        const int count = ring.write_spans(spans);
+        if (count == 0) {
+            wake();
+            std::this_thread::yield();
+            continue;
+        }
+        for (int i = 0; i < count && n; i++) {
+            const size_t take = spans[i].size < n ? spans[i].size : n;
+            std::memcpy(spans[i].data, samples, take * sizeof(s16));
+            ring.commit_write(take);
+            samples += take;
+            n -= take;
+        }
+    }
+    if (ring.size() >= RING_SAMPLES / 4) wake();
+}
+
+void audio_out::impl::push_zeros(u64 n) {
+    spsc_fifo<s16>::span spans[2];
+    while (n) {
+        const int count = ring.write_spans(spans);
+        if (count == 0) {
+            wake();
+            std::this_thread::yield();
+            continue;
+        }
+        for (int i = 0; i < count && n; i++) {
+            const size_t take = spans[i].size < n ? spans[i].size : (size_t)n;
+            std::memset(spans[i].data, 0, take * sizeof(s16));
+            ring.commit_write(take);
+            n -= take;
+        }
+    }
+    if (ring.size() >= RING_SAMPLES / 4) wake();
+}
+
+// WHAT: At most one wake-up in flight. A notify that races with the writer
+//       going to sleep is caught by its WRITER_PERIOD_MS timeout.
+void audio_out::impl::wake() {
+    if (!wake_pending.exchange(true, std::memory_order_acq_rel)) cv.notify_one();
+}
+
+// ============================================================================
+//  Writer Thread
+// ============================================================================
+void audio_out::impl::writer_main() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait_for(lock, std::chrono::milliseconds(WRITER_PERIOD_MS), [this] {
+                return wake_pending.load(std::memory_order_acquire) || stopping.load(std::memory_order_acquire);
+            });
+        }
+        wake_pending.store(false, std::memory_order_release);
+        const bool stop = stopping.load(std::memory_order_acquire);
+        drain();
+        if (stop) break;
+    }
+}
+
+void audio_out::impl::drain() {
+    spsc_fifo<s16>::span spans[2];
+    const int count = ring.read_spans(spans);
+    if (count == 0) return;
+
+    size_t total = 0;
+    for (int i = 0; i < count; i++) {
+        if (!write_failed && std::fwrite(spans[i].data, sizeof(s16), spans[i].size, file) != spans[i].size) {
+            std::cerr << "[Audio] Error: Write to " << (is_pipe ? "pipe" : "file") << " failed; audio dropped from here." << std::endl;
+            write_failed = true;
+        }
+        total += spans[i].size;
+    }
+    // Keep consuming after a failure so the emulation never waits on a dead output
+    ring.commit_read(total);
+    if (!write_failed) {
+        written.fetch_add(total, std::memory_order_relaxed);
+        std::fflush(file);      // A player on the other end of a pipe hears it now
+    }
+}
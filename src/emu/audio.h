@@ -0,0 +1,69 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include "types.h"
+
+// ============================================================================
+//  audio_out (Speaker Pins -> 48 kHz WAV)
+// ============================================================================
+//  WHAT: Turns level changes on the board's sound pins (VIA PB7 and CB2)
+//        into a band-limited 16-bit mono sample stream and writes it to a
+//        WAV file or pipes it into a command.
+//  WHO:  main() creates and opens it for --audio and hands it to the driver
+//        (mb_driver::attach_audio), which reports every pin edge with the
+//        CPU cycle it happened on.
+//  WHY:  Firmware makes sound with T1 free-run on PB7 (ACR bit 7) and with
+//        the shift register on CB2. A square wave sampled naively at 48 kHz
+//        aliases badly; placing each edge with sub-sample precision as a
+//        band-limited step (BLEP) keeps the pitch clean.
+//  HOW:  Event-driven: an edge adds a windowed-sinc impulse (one of PHASES
+//        precomputed sub-sample positions) into a small delta buffer; samples
+//        are produced only when time is advanced, by integrating the deltas
+//        and removing DC like the speaker's coupling capacitor. Once the
+//        output has settled, idle stretches are emitted as bulk zeros with no
+//        per-sample work. Samples go through a lock-free ring to a writer
+//        thread, so the emulation thread never touches the disk.
+//
+//  Paths:  "file.wav"  Plain file (sizes patched in the header on close)
+//          "|command"  Piped into command's stdin (e.g. "|aplay")
+// ============================================================================
+class audio_out {
+public:
+    static constexpr u32 SAMPLE_RATE = 48000;
+
+    // Sound pins (one bit each in the level word)
+    enum source { SRC_PB7, SRC_CB2, SRC_COUNT };
+
+    audio_out();
+    ~audio_out();
+
+    // WHAT: Starts the writer. Returns false (with a console message) if the
+    //       file or command can't be opened.
+    bool open(const std::string& path);
+    // WHAT: Flushes everything emitted so far and finishes the file.
+    void close();
+    bool is_open() const;
+
+    // WHAT: Starts the time base: 'cycle' is sample 0, 'levels' are the pin
+    //       levels at that moment (bit n = source n is high).
+    void begin(u64 cycle, u32 clock_hz, u8 levels);
+
+    // WHAT: A pin changed level on 'cycle'. Cycles must not go backwards;
+    //       an earlier one is treated as 'now'.
+    void set_level(int src, bool high, u64 cycle);
+
+    // WHAT: Emits every sample that can no longer change, up to 'cycle'.
+    void advance(u64 cycle);
+
+    // WHAT: Advances to 'cycle' and lets the last edge's tail ring out.
+    void finish(u64 cycle);
+
+    u64 samples_written() const;
+    const std::string& name() const { return m_name; }
+
+private:
+    struct impl;
+    std::unique_ptr<impl> m_impl;
+    std::string m_name;
+};
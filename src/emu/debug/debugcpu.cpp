@@ -0,0 +1,327 @@
+#include "debugcpu.h"
+#include "../map.h"
+#include "../../devices/cpu/m6502.h"
+#include "../../ui/views/debug_view.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+device_debug::device_debug(m6502_p& cpu) : m_cpu(cpu) {
+    std::memset(m_bp_bitmap, 0, sizeof(m_bp_bitmap));
+}
+
+// ============================================================================
+//  Breakpoints
+// ============================================================================
+int device_debug::breakpoint_set(u16 address) {
+    // One plain breakpoint per address: re-enable an existing one instead
+    for (auto& bp : m_breakpoints) {
+        if (bp.address == address && bp.condition.is_empty() && !bp.trace) {
+            bp.enabled = true;
+            rebuild_bitmap();
+            return bp.index;
+        }
+    }
+    breakpoint bp;
+    bp.index = m_next_index++;
+    bp.address = address;
+    bp.enabled = true;
+    bp.hits = 0;
+    m_breakpoints.push_back(std::move(bp));
+    rebuild_bitmap();
+    return m_breakpoints.back().index;
+}
+
+int device_debug::breakpoint_set(u16 address, const std::string& condition,
+                                 const std::string& action, std::string& error) {
+    breakpoint bp;
+    bp.address = address;
+    bp.enabled = true;
+    bp.hits = 0;
+
+    if (!bp.condition.parse(condition, &m_symbols)) {
+        error = "Condition: " + bp.condition.error();
+        return -1;
+    }
+    if (!parse_action(bp, action, m_symbols, error)) return -1;
+
+    bp.index = m_next_index++;
+    m_breakpoints.push_back(std::move(bp));
+    rebuild_bitmap();
+    return m_breakpoints.back().index;
+}
+
+// WHAT: Splits  "format", expr, expr  into the format and compiled args.
+bool device_debug::parse_action(breakpoint& bp, const std::string& action,
+                                const symbol_table& symbols, std::string& error) {
+    size_t pos = action.find_first_not_of(" \t");
+    if (pos == std::string::npos) return true;     // Plain breakpoint
+
+    bp.trace = true;
+    bp.action = action;
+    if (action[pos] != '"') {
+        error = "Trace: format must start with '\"'";
+        return false;
+    }
+    size_t close = action.find('"', pos + 1);
+    if (close == std::string::npos) {
+        error = "Trace: missing closing '\"'";
+        return false;
+    }
+    bp.trace_format = action.substr(pos + 1, close - pos - 1);
+
+    // Arguments are separated by top-level commas
+    pos = close + 1;
+    while (pos < action.size()) {
+        size_t comma = action.find(',', pos);
+        if (comma == std::string::npos) {
+            if (action.find_first_not_of(" \t", pos) != std::string::npos) {
+                error = "Trace: expected ',' after format";
+                return false;
+            }
+            break;
+        }
+        int nest = 0;
+        size_t end = comma + 1;
+        for (; end < action.size(); end++) {
+            char c = action[end];
+            if (c == '(' || c == '[') nest++;
+            else if (c == ')' || c == ']') nest--;
+            else if (c == ',' && nest == 0) break;
+        }
+        parsed_expression arg;
+        if (!arg.parse(action.substr(comma + 1, end - comma - 1), &symbols) || arg.is_empty()) {
+            error = "Trace argument " + std::to_string(bp.trace_args.size() + 1) + ": " +
+                    (arg.error().empty() ? std::string("empty") : arg.error());
+            return false;
+        }
+        bp.trace_args.push_back(std::move(arg));
+        pos = end;
+    }
+    return true;
+}
+
+bool device_debug::breakpoint_clear(int index) {
+    auto it = std::find_if(m_breakpoints.begin(), m_breakpoints.end(),
+                           [index](const breakpoint& bp) { return bp.index == index; });
+    if (it == m_breakpoints.end()) return false;
+    m_breakpoints.erase(it);
+    rebuild_bitmap();
+    return true;
+}
+
+void device_debug::breakpoint_clear_all() {
+    m_breakpoints.clear();
+    rebuild_bitmap();
+}
+
+void device_debug::breakpoint_clear_address(u16 address) {
+    m_breakpoints.erase(std::remove_if(m_breakpoints.begin(), m_breakpoints.end(),
+                                       [address](const breakpoint& bp) { return bp.address == address; }),
+                        m_breakpoints.end());
+    rebuild_bitmap();
+}
+
+bool device_debug::breakpoint_enable(int index, bool enable) {
+    for (auto& bp : m_breakpoints) {
+        if (bp.index == index) {
+            bp.enabled = enable;
+            rebuild_bitmap();
+            return true;
+        }
+    }
+    return false;
+}
+
+// WHAT: Recomputes the bitmap from the list.
+// WHY:  Edits are rare (UI clicks), lookups happen every instruction.
+void device_debug::rebuild_bitmap() {
+    std::memset(m_bp_bitmap, 0, sizeof(m_bp_bitmap));
+    m_bp_active = 0;
+    for (const auto& bp : m_breakpoints) {
+        if (!bp.enabled) continue;
+        m_bp_bitmap[bp.address >> 6] |= (u64)1 << (bp.address & 63);
+        m_bp_active++;
+    }
+}
+
+bool device_debug::breakpoint_hit(u16 pc) {
+    // Resuming from this very breakpoint: let the instruction execute
+    if (m_resume_valid && m_resume_pc == pc && m_resume_cycle == m_cpu.total_cycles()) {
+        m_resume_valid = false;
+        return false;
+    }
+    m_resume_valid = false;
+
+    bool stop = false;
+    for (auto& bp : m_breakpoints) {
+        if (!bp.enabled || bp.address != pc) continue;
+        if (!bp.condition.is_empty() && !bp.condition.evaluate(m_cpu)) continue;
+
+        bp.hits++;
+        if (bp.trace) {
+            trace(bp);
+            continue;
+        }
+        if (!stop) {
+            char msg[96];
+            char sym[48];
+            if (m_symbols.format(pc, sym, sizeof(sym), 0xFF)) {
+                std::snprintf(msg, sizeof(msg), "Breakpoint %d hit at $%04X (%s)", bp.index, pc, sym);
+            } else {
+                std::snprintf(msg, sizeof(msg), "Breakpoint %d hit at $%04X", bp.index, pc);
+            }
+            request_break(msg);
+            stop = true;
+        }
+    }
+
+    if (stop) {
+        m_resume_valid = true;
+        m_resume_pc = pc;
+        m_resume_cycle = m_cpu.total_cycles();
+    }
+    return stop;
+}
+
+// WHAT: Formats a tracepoint line into the system log.
+// HOW:  printf-style: each %d %u %x %X %o %c consumes the next argument
+//       (flags and width are kept, e.g. %04X). %% prints a '%'.
+void device_debug::trace(breakpoint& bp) {
+    std::string out;
+    char buf[64];
+    size_t arg = 0;
+    const std::string& f = bp.trace_format;
+
+    for (size_t i = 0; i < f.size(); i++) {
+        if (f[i] != '%') { out += f[i]; continue; }
+        if (i + 1 < f.size() && f[i + 1] == '%') { out += '%'; i++; continue; }
+
+        // Collect flags/width: %[-+ #0][width]
+        size_t j = i + 1;
+        while (j < f.size() && std::strchr("-+ #0123456789", f[j])) j++;
+        if (j >= f.size() || !std::strchr("duxXoc", f[j])) { out += f[i]; continue; }
+
+        u64 v = (arg < bp.trace_args.size()) ? bp.trace_args[arg].evaluate(m_cpu) : 0;
+        arg++;
+
+        std::string spec = f.substr(i, j - i);
+        if (f[j] == 'c') {
+            spec += 'c';
+            std::snprintf(buf, sizeof(buf), spec.c_str(), (int)(v & 0xFF));
+        } else {
+            spec += "ll";
+            spec += f[j];
+            std::snprintf(buf, sizeof(buf), spec.c_str(), (unsigned long long)v);
+        }
+        out += buf;
+        i = j;
+    }
+
+    char sym[40];
+    if (m_symbols.format(bp.address, sym, sizeof(sym), 0xFF)) {
+        DebugView::add_log(LOG_CPU, "[Trace $%04X %s] %s", bp.address, sym, out.c_str());
+    } else {
+        DebugView::add_log(LOG_CPU, "[Trace $%04X] %s", bp.address, out.c_str());
+    }
+}
+
+// ============================================================================
+//  Watchpoints
+// ============================================================================
+int device_debug::watchpoint_set(u16 start, u16 end, u8 type) {
+    if (end < start) std::swap(start, end);
+    m_watchpoints.push_back({ m_next_index++, start, end, type, true, 0 });
+    install_watch_flags();
+    return m_watchpoints.back().index;
+}
+
+bool device_debug::watchpoint_clear(int index) {
+    auto it = std::find_if(m_watchpoints.begin(), m_watchpoints.end(),
+                           [index](const watchpoint& wp) { return wp.index == index; });
+    if (it == m_watchpoints.end()) return false;
+    m_watchpoints.erase(it);
+    install_watch_flags();
+    return true;
+}
+
+void device_debug::watchpoint_clear_all() {
+    m_watchpoints.clear();
+    install_watch_flags();
+}
+
+bool device_debug::watchpoint_enable(int index, bool enable) {
+    for (auto& wp : m_watchpoints) {
+        if (wp.index == index) {
+            wp.enabled = enable;
+            install_watch_flags();
+            return true;
+        }
+    }
+    return false;
+}
+
+void device_debug::attach_map(address_map* map) {
+    if (m_map && m_map != map) {
+        m_map->clear_watch();
+        m_map->set_heatmap(nullptr);
+    }
+    m_map = map;
+    install_watch_flags();
+    if (m_map) m_map->set_heatmap(m_heat);
+}
+
+void device_debug::attach_heatmap(debug_heatmap* heat) {
+    m_heat = heat;
+    if (m_map) m_map->set_heatmap(heat);
+}
+
+// WHAT: Marks every page touched by an enabled watchpoint in the map.
+// HOW:  The map only calls back for flagged pages; the exact range check
+//       happens in watchpoint_hit(). Unwatched pages cost one table lookup.
+void device_debug::install_watch_flags() {
+    if (!m_map) return;
+
+    m_map->clear_watch();
+    for (const auto& wp : m_watchpoints) {
+        if (!wp.enabled) continue;
+        for (int page = wp.start >> 8; page <= (wp.end >> 8); page++) {
+            m_map->set_watch_page((u8)page, wp.type);
+        }
+    }
+
+    if (m_map->has_watch()) {
+        m_map->set_watch_handler([this](u16 addr, u8 data, bool write) {
+            watchpoint_hit(addr, data, write);
+        });
+    }
+}
+
+void device_debug::watchpoint_hit(u16 addr, u8 data, bool write) {
+    const u8 type = write ? WATCH_WRITE : WATCH_READ;
+    for (auto& wp : m_watchpoints) {
+        if (!wp.enabled || !(wp.type & type)) continue;
+        if (addr < wp.start || addr > wp.end) continue;
+
+        wp.hits++;
+        char msg[96];
+        std::snprintf(msg, sizeof(msg), "Watchpoint %d: %s $%04X = $%02X (PC $%04X)",
+                      wp.index, write ? "write" : "read", addr, data, m_cpu.get_pc());
+        request_break(msg, addr, write);
+        return;
+    }
+}
+
+// ============================================================================
+//  Break State
+// ============================================================================
+// WHAT: Records the break and empties the CPU's timeslice.
+// WHY:  A watchpoint fires in the middle of an instruction; the instruction
+//       completes and the CPU stops at the next boundary.
+void device_debug::request_break(const std::string& reason, int watch_address, bool watch_write) {
+    m_break_pending = true;
+    m_break_reason = reason;
+    m_break_watch = watch_address;
+    m_break_watch_write = watch_write;
+    m_cpu.abort_timeslice();
+}
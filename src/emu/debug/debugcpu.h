@@ -0,0 +1,171 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "../types.h"
+#include "express.h"
+#include "heatmap.h"
+#include "symbols.h"
+
+class m6502_p;
+class address_map;
+
+// ============================================================================
+//  device_debug
+// ============================================================================
+//  WHAT: Breakpoint and watchpoint bookkeeping for one CPU.
+//  WHO:  Owned by the CPU (m6502_p::debug()). The UI adds/removes entries,
+//        the CPU and the address map report hits.
+//  WHY:  The execution loop must stay fast when nothing is set, so the hot
+//        state is kept in two compact forms:
+//          - Breakpoints: a 64K-bit bitmap, one bit test per instruction
+//            (and only when at least one breakpoint exists).
+//          - Watchpoints: per-page flags installed into the address_map, so
+//            accesses to unwatched pages never reach this class.
+// ============================================================================
+class device_debug {
+public:
+    // Watchpoint access types (match address_map::WATCH_READ/WATCH_WRITE)
+    static constexpr u8 WATCH_READ  = 0x01;
+    static constexpr u8 WATCH_WRITE = 0x02;
+
+    struct breakpoint {
+        int  index;             // User-visible number
+        u16  address;
+        bool enabled;
+        u32  hits;
+
+        // Optional: only stop when this evaluates non-zero
+        parsed_expression condition;
+
+        // Tracepoint: log instead of stopping
+        // e.g. format "A=%02X [$0200]=%02X" with arguments "A", "[$0200]"
+        bool trace = false;
+        std::string trace_format;
+        std::vector<parsed_expression> trace_args;
+        std::string action;     // Original action text (for display)
+    };
+
+    struct watchpoint {
+        int  index;
+        u16  start, end;        // Inclusive range
+        u8   type;              // WATCH_READ | WATCH_WRITE
+        bool enabled;
+        u32  hits;
+    };
+
+    explicit device_debug(m6502_p& cpu);
+
+    // ========================================================================
+    //  Breakpoints
+    // ========================================================================
+    int  breakpoint_set(u16 address);
+
+    // WHAT: Conditional breakpoint / tracepoint.
+    // HOW:  'condition' is an expression (empty = always). 'action' is empty
+    //       for a breakpoint, or  "format", expr, expr...  for a tracepoint.
+    //       Returns the index, or -1 with 'error' filled in if either fails to
+    //       parse.
+    int  breakpoint_set(u16 address, const std::string& condition,
+                        const std::string& action, std::string& error);
+    bool breakpoint_clear(int index);
+    void breakpoint_clear_all();
+    void breakpoint_clear_address(u16 address);     // All breakpoints at 'address'
+    bool breakpoint_enable(int index, bool enable);
+    const std::vector<breakpoint>& breakpoints() const { return m_breakpoints; }
+
+    // WHAT: Bitmap test (the only thing the CPU does per instruction).
+    bool breakpoint_at(u16 pc) const { return (m_bp_bitmap[pc >> 6] >> (pc & 63)) & 1; }
+
+    // WHAT: True if the CPU should use its instrumented loop.
+    bool active() const { return m_bp_active != 0 || m_heat != nullptr; }
+
+    // WHAT: Called by the CPU when the bitmap bit for 'pc' is set.
+    // HOW:  Evaluates the conditions of the breakpoints at 'pc' (this is the
+    //       only place they run), logs tracepoints, and returns true if
+    //       execution should stop before this instruction.
+    bool breakpoint_hit(u16 pc);
+
+    // ========================================================================
+    //  Watchpoints
+    // ========================================================================
+    int  watchpoint_set(u16 start, u16 end, u8 type);
+    bool watchpoint_clear(int index);
+    void watchpoint_clear_all();
+    bool watchpoint_enable(int index, bool enable);
+    const std::vector<watchpoint>& watchpoints() const { return m_watchpoints; }
+
+    // WHAT: Points the watchpoints at a (new) address map.
+    // WHEN: Whenever the CPU gets a map installed.
+    void attach_map(address_map* map);
+
+    // ========================================================================
+    //  Heatmap
+    // ========================================================================
+    // WHAT: Starts (or with nullptr stops) counting accesses into 'heat'.
+    // WHY:  Reads and writes come from the address map; opcode fetches are
+    //       counted by the CPU's instrumented loop, which is only selected
+    //       while a heatmap is attached.
+    void attach_heatmap(debug_heatmap* heat);
+    void count_execute(u16 pc) { if (m_heat) m_heat->count_execute(pc); }
+
+    // ========================================================================
+    //  Symbols
+    // ========================================================================
+    // WHAT: Labels loaded from the assembler (see symbol_table).
+    symbol_table& symbols() { return m_symbols; }
+    const symbol_table& symbols() const { return m_symbols; }
+
+    // ========================================================================
+    //  Break State
+    // ========================================================================
+    // WHAT: Returns true once per break, and the reason text.
+    // WHY:  The UI polls this after each run slice to pause the machine.
+    bool consume_break() { bool b = m_break_pending; m_break_pending = false; return b; }
+    bool break_pending() const { return m_break_pending; }
+    const std::string& break_reason() const { return m_break_reason; }
+
+    // WHAT: For a watchpoint break, the accessed address (else -1) and
+    //       whether it was a write. (GDB reports "watch:ADDR" stops.)
+    int  break_watch_address() const { return m_break_watch; }
+    bool break_watch_write() const   { return m_break_watch_write; }
+
+private:
+    m6502_p& m_cpu;
+    address_map* m_map = nullptr;
+
+    // Breakpoints
+    u64 m_bp_bitmap[0x10000 / 64];  // 8KB: one bit per address
+    int m_bp_active = 0;            // Number of enabled breakpoints
+    int m_next_index = 1;
+    std::vector<breakpoint> m_breakpoints;
+
+    // WHAT: The breakpoint we last stopped on.
+    // WHY:  Continuing must execute that instruction instead of re-hitting it.
+    bool m_resume_valid = false;
+    u16  m_resume_pc = 0;
+    u64  m_resume_cycle = 0;
+
+    // Watchpoints
+    std::vector<watchpoint> m_watchpoints;
+
+    // Access heatmap (owned by the UI)
+    debug_heatmap* m_heat = nullptr;
+
+    // Symbols
+    symbol_table m_symbols;
+
+    // Break state
+    bool m_break_pending = false;
+    std::string m_break_reason;
+    int  m_break_watch = -1;
+    bool m_break_watch_write = false;
+
+    void rebuild_bitmap();
+    void install_watch_flags();
+    void watchpoint_hit(u16 addr, u8 data, bool write);
+    void request_break(const std::string& reason, int watch_address = -1, bool watch_write = false);
+    void trace(breakpoint& bp);
+    static bool parse_action(breakpoint& bp, const std::string& action,
+                             const symbol_table& symbols, std::string& error);
+};
@@ -0,0 +1,180 @@
+#include "dvdisasm.h"
+#include "symbols.h"
+#include "../../devices/cpu/m6502.h"
+#include <algorithm>
+#include <cstdio>
+
+debug_disasm::debug_disasm(m6502_p& cpu, generation_func generation)
+    : m_cpu(cpu), m_generation(std::move(generation)) {}
+
+// ============================================================================
+//  Update
+// ============================================================================
+//  HOW:  Walk the pages in address order, carrying the spill of each page
+//        into the next. A page is decoded again only if its bytes changed or
+//        its entry point moved; a change ripples forward only as long as the
+//        spill keeps changing (usually not past the next page).
+// ============================================================================
+void debug_disasm::update() {
+    bool counts_changed = false;
+    u8 entry = 0;
+
+    // New labels: the decode is still good, only the text must be redone
+    u32 symbol_gen = m_symbols ? m_symbols->generation() : 0;
+    if (symbol_gen != m_symbol_gen) {
+        m_symbol_gen = symbol_gen;
+        for (auto& pg : m_pages) {
+            for (auto& t : pg.text) t.clear();
+        }
+    }
+
+    for (int p = 0; p < 256; p++) {
+        page& pg = m_pages[p];
+        u32 gen = m_generation ? m_generation((u8)p) : 0;
+
+        if (!pg.valid || pg.generation != gen || pg.entry != entry) {
+            // The last line of the previous page shows operand bytes from here
+            if (p > 0 && pg.generation != gen) {
+                page& prev = m_pages[p - 1];
+                if (prev.spill && !prev.text.empty()) prev.text.back().clear();
+            }
+
+            size_t old_count = pg.lines.size();
+            decode_page(p, entry);
+            pg.generation = gen;
+            if (pg.lines.size() != old_count) counts_changed = true;
+        }
+        entry = pg.spill;
+    }
+
+    if (counts_changed) {
+        m_prefix[0] = 0;
+        for (int p = 0; p < 256; p++) m_prefix[p + 1] = m_prefix[p] + (int)m_pages[p].lines.size();
+    }
+}
+
+// WHAT: Linear sweep of one page starting 'entry' bytes in.
+void debug_disasm::decode_page(int p, u8 entry) {
+    page& pg = m_pages[p];
+    pg.valid = true;
+    pg.entry = entry;
+    pg.spill = 0;
+    pg.lines.clear();
+
+    // Lengths only depend on the opcode byte, so one page is enough
+    u8 bytes[256];
+    m_cpu.read_range_debug((u16)(p << 8), 256, bytes);
+
+    const int base = p << 8;
+    int addr = base + entry;
+    while (addr < base + 256) {
+        int len = m_cpu.dasm_length(bytes[addr - base]);
+
+        // An anchor inside this instruction wins: show the byte as data
+        int last = std::min(addr + len - 1, 0xFFFF);
+        if (len > 1 && anchored_between((u16)(addr + 1), (u16)last)) {
+            pg.lines.push_back({ (u16)addr, true });
+            addr++;
+            continue;
+        }
+
+        pg.lines.push_back({ (u16)addr, false });
+        addr += len;
+    }
+    if (p < 255) pg.spill = (u8)(addr - (base + 256));
+
+    pg.text.assign(pg.lines.size(), std::string());
+}
+
+bool debug_disasm::anchored_between(u16 first, u16 last) const {
+    auto it = std::lower_bound(m_anchors.begin(), m_anchors.end(), first);
+    return it != m_anchors.end() && *it <= last;
+}
+
+void debug_disasm::anchor(u16 addr) {
+    auto it = std::lower_bound(m_anchors.begin(), m_anchors.end(), addr);
+    if (it != m_anchors.end() && *it == addr) return;
+
+    // Keep the list short; the oldest-by-address anchor is dropped
+    if (m_anchors.size() >= MAX_ANCHORS) {
+        m_pages[m_anchors.front() >> 8].valid = false;
+        m_anchors.erase(m_anchors.begin());
+        it = std::lower_bound(m_anchors.begin(), m_anchors.end(), addr);
+    }
+    m_anchors.insert(it, addr);
+
+    // The instruction covering 'addr' may start on the previous page
+    m_pages[addr >> 8].valid = false;
+    if ((addr >> 8) > 0) m_pages[(addr >> 8) - 1].valid = false;
+}
+
+// ============================================================================
+//  Row Lookup
+// ============================================================================
+u16 debug_disasm::line_address(int row) const {
+    if (row < 0 || row >= line_count()) return 0;
+    int p = (int)(std::upper_bound(m_prefix, m_prefix + 257, row) - m_prefix) - 1;
+    return m_pages[p].lines[row - m_prefix[p]].address;
+}
+
+int debug_disasm::row_of(u16 addr) const {
+    int p = addr >> 8;
+    const auto& lines = m_pages[p].lines;
+
+    // Find the last line starting at or before 'addr'
+    auto it = std::upper_bound(lines.begin(), lines.end(), addr,
+                               [](u16 a, const line& l) { return a < l.address; });
+    if (it != lines.begin()) return m_prefix[p] + (int)(it - lines.begin()) - 1;
+
+    // 'addr' is inside an instruction spilling in from an earlier page
+    while (--p >= 0) {
+        if (!m_pages[p].lines.empty()) return m_prefix[p] + (int)m_pages[p].lines.size() - 1;
+    }
+    return 0;
+}
+
+// ============================================================================
+//  Line Text
+// ============================================================================
+//  Format:  8000  A9 FF     LDA #$FF
+// ============================================================================
+const std::string& debug_disasm::line_text(int row) {
+    static const std::string empty;
+    if (row < 0 || row >= line_count()) return empty;
+
+    int p = (int)(std::upper_bound(m_prefix, m_prefix + 257, row) - m_prefix) - 1;
+    page& pg = m_pages[p];
+    int idx = row - m_prefix[p];
+    std::string& text = pg.text[idx];
+    if (!text.empty()) return text;
+
+    const line& ln = pg.lines[idx];
+    u8 ops[3];
+    m_cpu.read_range_debug(ln.address, 3, ops);
+
+    char body[64];
+    char hex[12];
+    int len = 1;
+    if (ln.data) {
+        std::snprintf(body, sizeof(body), ".db $%02X", ops[0]);
+    } else {
+        len = m_cpu.disassemble(ln.address, ops, body, sizeof(body), m_symbols);
+    }
+
+    switch (len) {
+        case 1:  std::snprintf(hex, sizeof(hex), "%02X", ops[0]); break;
+        case 2:  std::snprintf(hex, sizeof(hex), "%02X %02X", ops[0], ops[1]); break;
+        default: std::snprintf(hex, sizeof(hex), "%02X %02X %02X", ops[0], ops[1], ops[2]); break;
+    }
+
+    char buf[128];
+    if (m_symbols && !m_symbols->empty()) {
+        const symbol_table::symbol* label = m_symbols->exact(ln.address);
+        std::snprintf(buf, sizeof(buf), "%04X  %-16.16s %-9s  %s", ln.address,
+                      label ? label->name.c_str() : "", hex, body);
+    } else {
+        std::snprintf(buf, sizeof(buf), "%04X  %-9s  %s", ln.address, hex, body);
+    }
+    text = buf;
+    return text;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "../types.h"
+
+class m6502_p;
+class symbol_table;
+
+// ============================================================================
+//  debug_disasm
+// ============================================================================
+//  WHAT: A disassembly listing of the full 64K address space, one row per
+//        instruction, for the debugger's disassembly window.
+//  WHO:  Owned by the DebugView. Reads memory through read_range_debug.
+//  WHY:  Decoding 64K every frame is wasteful when almost nothing changes.
+//        The listing is kept per 256-byte page and only rebuilt when:
+//          - the page's generation counter changed (ROM load, RAM write), or
+//          - the instruction spilling in from the previous page now ends
+//            somewhere else.
+//        Line text is formatted lazily, so drawing costs only what is on
+//        screen.
+//  HOW:  Page p lists the addresses of the lines that start inside it. A
+//        prefix sum over the per-page line counts maps a list row to its
+//        page with a binary search.
+// ============================================================================
+class debug_disasm {
+public:
+    // Returns the change counter of a CPU page (see mb_driver::page_generation)
+    using generation_func = std::function<u32(u8 page)>;
+
+    debug_disasm(m6502_p& cpu, generation_func generation);
+
+    // WHAT: Labels used for operands and the label column (may be null).
+    void set_symbols(const symbol_table* symbols) { m_symbols = symbols; m_symbol_gen = ~0u; }
+
+    // WHAT: Re-decodes stale pages. Cheap when nothing changed.
+    // WHEN: Once per frame, before drawing.
+    void update();
+
+    // WHAT: Number of rows in the listing.
+    int line_count() const { return m_prefix[256]; }
+
+    // WHAT: Address / formatted text of a row (0 .. line_count()-1).
+    u16 line_address(int row) const;
+    const std::string& line_text(int row);
+
+    // WHAT: Row of the line containing 'addr'.
+    int row_of(u16 addr) const;
+
+    // WHAT: Forces a line to start at 'addr' (e.g. the PC landed in the
+    //       middle of what the linear sweep decoded as an operand).
+    // HOW:  Bytes that would overlap it are shown as data. Takes effect on
+    //       the next update().
+    void anchor(u16 addr);
+
+private:
+    struct line {
+        u16  address;
+        bool data;          // Shown as ".db" (cut short by an anchor)
+    };
+
+    struct page {
+        bool valid = false;
+        u32  generation = 0;
+        u8   entry = 0;     // Offset of the first line (spill from page-1)
+        u8   spill = 0;     // Bytes the last line runs into page+1
+        std::vector<line> lines;
+        std::vector<std::string> text;      // Lazily formatted, "" = not yet
+    };
+
+    m6502_p& m_cpu;
+    generation_func m_generation;
+    const symbol_table* m_symbols = nullptr;
+    u32 m_symbol_gen = ~0u;                 // Symbol table generation the text was made with
+
+    page m_pages[256];
+    int  m_prefix[257] = {};                // Rows before page p
+    std::vector<u16> m_anchors;             // Sorted
+
+    static constexpr size_t MAX_ANCHORS = 64;
+
+    void decode_page(int p, u8 entry);
+    bool anchored_between(u16 first, u16 last) const;
+};
@@ -0,0 +1,277 @@
+#include "express.h"
+#include "symbols.h"
+#include "../../devices/cpu/m6502.h"
+#include <cctype>
+#include <cstdlib>
+
+// ============================================================================
+//  Parser
+// ============================================================================
+//  HOW:  One function per precedence level, lowest first. Each level parses
+//        its operands (which emit their own code) and then emits the operator,
+//        so the output is already in postfix order.
+// ============================================================================
+struct parsed_expression::parser {
+    const std::string& src;
+    size_t pos = 0;
+    std::vector<instruction>& out;
+    const symbol_table* symbols = nullptr;
+    std::string error;
+    int depth = 0;      // Current stack depth
+    int max_depth = 0;
+
+    parser(const std::string& s, std::vector<instruction>& o) : src(s), out(o) {}
+
+    // --- Helpers ---
+    void skip_ws() {
+        while (pos < src.size() && std::isspace((unsigned char)src[pos])) pos++;
+    }
+    bool accept(const char* tok) {
+        skip_ws();
+        size_t len = 0;
+        while (tok[len]) len++;
+        if (src.compare(pos, len, tok) != 0) return false;
+        pos += len;
+        return true;
+    }
+    bool fail(const std::string& msg) {
+        if (error.empty()) error = msg + " at column " + std::to_string(pos + 1);
+        return false;
+    }
+    void emit(opcode op, u64 value = 0) {
+        out.push_back({ op, value });
+        if (op == OP_CONST || op == OP_REG) depth++;
+        else if (op >= OP_MUL) depth--;     // Binary: pop 2, push 1
+        if (depth > max_depth) max_depth = depth;
+    }
+
+    // --- Precedence levels ---
+    using level_fn = bool (parser::*)();
+    struct binop { const char* tok; opcode op; };
+
+    bool binary(level_fn next, const binop* ops, int count) {
+        if (!(this->*next)()) return false;
+        for (;;) {
+            bool matched = false;
+            for (int i = 0; i < count; i++) {
+                size_t save = pos;
+                if (!accept(ops[i].tok)) continue;
+                // A lone '&' or '|' must not swallow the first half of '&&' / '||'
+                if (ops[i].tok[1] == '\0' && pos < src.size() && src[pos] == ops[i].tok[0]) {
+                    pos = save;
+                    continue;
+                }
+                if (!(this->*next)()) return false;
+                emit(ops[i].op);
+                matched = true;
+                break;
+            }
+            if (!matched) return true;
+        }
+    }
+
+    bool parse_lor()  { static const binop o[] = { {"||", OP_LOR} };  return binary(&parser::parse_land, o, 1); }
+    bool parse_land() { static const binop o[] = { {"&&", OP_LAND} }; return binary(&parser::parse_bor, o, 1); }
+    bool parse_bor()  { static const binop o[] = { {"|", OP_BOR} };   return binary(&parser::parse_bxor, o, 1); }
+    bool parse_bxor() { static const binop o[] = { {"^", OP_BXOR} };  return binary(&parser::parse_band, o, 1); }
+    bool parse_band() { static const binop o[] = { {"&", OP_BAND} };  return binary(&parser::parse_eq, o, 1); }
+    bool parse_eq()   { static const binop o[] = { {"==", OP_EQ}, {"!=", OP_NE} }; return binary(&parser::parse_rel, o, 2); }
+    bool parse_rel()  {
+        static const binop o[] = { {"<=", OP_LE}, {">=", OP_GE}, {"<", OP_LT}, {">", OP_GT} };
+        return binary(&parser::parse_shift, o, 4);
+    }
+    bool parse_shift() { static const binop o[] = { {"<<", OP_SHL}, {">>", OP_SHR} }; return binary(&parser::parse_add, o, 2); }
+    bool parse_add()  { static const binop o[] = { {"+", OP_ADD}, {"-", OP_SUB} }; return binary(&parser::parse_mul, o, 2); }
+    bool parse_mul()  {
+        static const binop o[] = { {"*", OP_MUL}, {"/", OP_DIV}, {"%", OP_MOD} };
+        return binary(&parser::parse_unary, o, 3);
+    }
+
+    bool parse_unary() {
+        skip_ws();
+        if (pos < src.size() && src[pos] == '!' && (pos + 1 >= src.size() || src[pos + 1] != '=')) {
+            pos++;
+            if (!parse_unary()) return false;
+            emit(OP_NOT);
+            return true;
+        }
+        if (accept("~")) { if (!parse_unary()) return false; emit(OP_COMPL); return true; }
+        if (accept("-")) { if (!parse_unary()) return false; emit(OP_NEG);   return true; }
+        return parse_primary();
+    }
+
+    bool parse_primary() {
+        skip_ws();
+        if (pos >= src.size()) return fail("Unexpected end of expression");
+
+        // ( expr )
+        if (accept("(")) {
+            if (!parse_lor()) return false;
+            if (!accept(")")) return fail("Expected ')'");
+            return true;
+        }
+
+        // [expr]  byte read
+        if (accept("[")) {
+            if (!parse_lor()) return false;
+            if (!accept("]")) return fail("Expected ']'");
+            emit(OP_READ8);
+            return true;
+        }
+
+        // Numbers
+        char c = src[pos];
+        if (c == '$' || std::isdigit((unsigned char)c)) {
+            int base = 10;
+            if (c == '$') { base = 16; pos++; }
+            else if (c == '0' && pos + 1 < src.size() && (src[pos + 1] == 'x' || src[pos + 1] == 'X')) {
+                base = 16; pos += 2;
+            }
+            const char* begin = src.c_str() + pos;
+            char* end = nullptr;
+            u64 v = std::strtoull(begin, &end, base);
+            if (end == begin) return fail("Bad number");
+            pos += (size_t)(end - begin);
+            emit(OP_CONST, v);
+            return true;
+        }
+
+        // Identifiers: registers, flags, w[...]
+        if (std::isalpha((unsigned char)c) || c == '_') {
+            size_t start = pos;
+            while (pos < src.size() && (std::isalnum((unsigned char)src[pos]) || src[pos] == '_' || src[pos] == '.')) pos++;
+            const std::string name = src.substr(start, pos - start);
+            std::string id = name;
+            for (auto& ch : id) ch = (char)std::toupper((unsigned char)ch);
+
+            if (id == "W" && accept("[")) {
+                if (!parse_lor()) return false;
+                if (!accept("]")) return fail("Expected ']'");
+                emit(OP_READ16);
+                return true;
+            }
+
+            static const struct { const char* name; reg_id reg; } regs[] = {
+                {"A", REG_A}, {"X", REG_X}, {"Y", REG_Y}, {"S", REG_S}, {"SP", REG_S},
+                {"P", REG_P}, {"PC", REG_PC}, {"CYCLES", REG_CYCLES},
+                {"C", FLAG_C}, {"Z", FLAG_Z}, {"I", FLAG_I}, {"D", FLAG_D},
+                {"V", FLAG_V}, {"N", FLAG_N},
+            };
+            for (const auto& r : regs) {
+                if (id == r.name) { emit(OP_REG, r.reg); return true; }
+            }
+
+            // Labels (case-sensitive, as the assembler wrote them)
+            u16 addr = 0;
+            if (symbols && symbols->find(name, addr)) { emit(OP_CONST, addr); return true; }
+
+            pos = start;
+            return fail("Unknown symbol '" + name + "'");
+        }
+
+        return fail(std::string("Unexpected '") + c + "'");
+    }
+};
+
+// ============================================================================
+//  Compile
+// ============================================================================
+bool parsed_expression::parse(const std::string& text, const symbol_table* symbols) {
+    m_text = text;
+    m_error.clear();
+    m_code.clear();
+
+    parser p(text, m_code);
+    p.symbols = symbols;
+    p.skip_ws();
+    if (p.pos >= text.size()) return true;     // Empty = always true
+
+    bool ok = p.parse_lor();
+    if (ok) {
+        p.skip_ws();
+        if (p.pos != text.size()) ok = p.fail("Unexpected trailing text");
+    }
+    if (ok && p.max_depth > MAX_DEPTH) ok = p.fail("Expression too deep");
+
+    if (!ok) {
+        m_error = p.error;
+        m_code.clear();
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+//  Evaluate
+// ============================================================================
+u64 parsed_expression::evaluate(m6502_p& cpu) const {
+    if (m_code.empty()) return 1;
+
+    u64 stack[MAX_DEPTH];
+    int sp = 0;
+
+    for (const instruction& ins : m_code) {
+        switch (ins.op) {
+            case OP_CONST: stack[sp++] = ins.value; break;
+            case OP_REG: {
+                u64 v = 0;
+                const u8 p = cpu.get_flags();
+                switch ((reg_id)ins.value) {
+                    case REG_A:      v = cpu.get_a(); break;
+                    case REG_X:      v = cpu.get_x(); break;
+                    case REG_Y:      v = cpu.get_y(); break;
+                    case REG_S:      v = cpu.get_sp(); break;
+                    case REG_P:      v = p; break;
+                    case REG_PC:     v = cpu.get_pc(); break;
+                    case REG_CYCLES: v = cpu.total_cycles(); break;
+                    case FLAG_C:     v = (p >> 0) & 1; break;
+                    case FLAG_Z:     v = (p >> 1) & 1; break;
+                    case FLAG_I:     v = (p >> 2) & 1; break;
+                    case FLAG_D:     v = (p >> 3) & 1; break;
+                    case FLAG_V:     v = (p >> 6) & 1; break;
+                    case FLAG_N:     v = (p >> 7) & 1; break;
+                }
+                stack[sp++] = v;
+                break;
+            }
+            case OP_READ8:
+                stack[sp - 1] = cpu.read_byte_debug((u16)stack[sp - 1]);
+                break;
+            case OP_READ16: {
+                u16 a = (u16)stack[sp - 1];
+                stack[sp - 1] = cpu.read_byte_debug(a) | (cpu.read_byte_debug((u16)(a + 1)) << 8);
+                break;
+            }
+            case OP_NOT:   stack[sp - 1] = !stack[sp - 1]; break;
+            case OP_COMPL: stack[sp - 1] = ~stack[sp - 1]; break;
+            case OP_NEG:   stack[sp - 1] = (u64)0 - stack[sp - 1]; break;
+            default: {
+                u64 r = stack[--sp];
+                u64& l = stack[sp - 1];
+                switch (ins.op) {
+                    case OP_MUL:  l = l * r; break;
+                    case OP_DIV:  l = r ? l / r : 0; break;
+                    case OP_MOD:  l = r ? l % r : 0; break;
+                    case OP_ADD:  l = l + r; break;
+                    case OP_SUB:  l = l - r; break;
+                    case OP_SHL:  l = (r < 64) ? l << r : 0; break;
+                    case OP_SHR:  l = (r < 64) ? l >> r : 0; break;
+                    case OP_LT:   l = l < r; break;
+                    case OP_LE:   l = l <= r; break;
+                    case OP_GT:   l = l > r; break;
+                    case OP_GE:   l = l >= r; break;
+                    case OP_EQ:   l = l == r; break;
+                    case OP_NE:   l = l != r; break;
+                    case OP_BAND: l = l & r; break;
+                    case OP_BXOR: l = l ^ r; break;
+                    case OP_BOR:  l = l | r; break;
+                    case OP_LAND: l = (l && r); break;
+                    case OP_LOR:  l = (l || r); break;
+                    default: break;
+                }
+                break;
+            }
+        }
+    }
+    return sp ? stack[sp - 1] : 0;
+}
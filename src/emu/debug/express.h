@@ -0,0 +1,74 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "../types.h"
+
+class m6502_p;
+class symbol_table;
+
+// ============================================================================
+//  parsed_expression
+// ============================================================================
+//  WHAT: A debugger expression such as  A == $41 && [$0200] > 3
+//  WHO:  Used by device_debug for breakpoint conditions and tracepoint values.
+//  WHY:  Conditions are checked every time their breakpoint address executes,
+//        so the text is parsed once and compiled to a small postfix bytecode.
+//        Evaluation is a tight loop over that array with a fixed-size stack.
+//
+//  Syntax:
+//    Numbers    : $1F, 0x1F (hex)  31 (decimal)
+//    Registers  : A X Y S/SP P PC CYCLES
+//    Flags      : C Z I D V N  (0 or 1)
+//    Memory     : [expr] byte,  w[expr] little-endian word (side-effect free)
+//    Symbols    : any label from the symbol table (resolved at parse time)
+//    Operators  : ! ~ - (unary)  * / %  + -  << >>  < <= > >=  == !=
+//                 &  ^  |  &&  ||   and parentheses
+// ============================================================================
+class parsed_expression {
+public:
+    parsed_expression() = default;
+
+    // WHAT: Compiles 'text'. On failure returns false and error() says why.
+    //       Labels are looked up in 'symbols' if given.
+    bool parse(const std::string& text, const symbol_table* symbols = nullptr);
+
+    // WHAT: Runs the bytecode. An empty expression evaluates to 1 (true).
+    u64 evaluate(m6502_p& cpu) const;
+
+    bool is_empty() const              { return m_code.empty(); }
+    const std::string& text() const    { return m_text; }
+    const std::string& error() const   { return m_error; }
+
+private:
+    enum opcode : u8 {
+        OP_CONST,                           // push value
+        OP_REG,                             // push register (value = reg id)
+        OP_READ8, OP_READ16,                // pop address, push memory
+        OP_NOT, OP_COMPL, OP_NEG,           // unary
+        OP_MUL, OP_DIV, OP_MOD, OP_ADD, OP_SUB, OP_SHL, OP_SHR,
+        OP_LT, OP_LE, OP_GT, OP_GE, OP_EQ, OP_NE,
+        OP_BAND, OP_BXOR, OP_BOR, OP_LAND, OP_LOR
+    };
+
+    enum reg_id : u8 {
+        REG_A, REG_X, REG_Y, REG_S, REG_P, REG_PC, REG_CYCLES,
+        FLAG_C, FLAG_Z, FLAG_I, FLAG_D, FLAG_V, FLAG_N
+    };
+
+    struct instruction {
+        opcode op;
+        u64    value;
+    };
+
+    // Evaluation stack limit (checked at compile time, so eval never overflows)
+    static constexpr int MAX_DEPTH = 32;
+
+    std::string m_text;
+    std::string m_error;
+    std::vector<instruction> m_code;
+
+    // --- Parser (recursive descent, emits postfix) ---
+    struct parser;
+    friend struct parser;
+};
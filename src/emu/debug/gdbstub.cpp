@@ -0,0 +1,583 @@
+#include "gdbstub.h"
+#include "debugcpu.h"
+#include "devices/cpu/m6502.h"
+
+#include <asio.hpp>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using asio::generic::stream_protocol;
+
+// ============================================================================
+//  Target Description
+// ============================================================================
+//  Register numbers follow the 'g' packet order: a x y s p pc.
+// ============================================================================
+static const char s_target_xml[] =
+    "<?xml version=\"1.0\"?>"
+    "<!DOCTYPE target SYSTEM \"gdb-target.dtd\">"
+    "<target version=\"1.0\">"
+    "<feature name=\"org.eater6502.cpu\">"
+    "<reg name=\"a\" bitsize=\"8\" regnum=\"0\" type=\"uint8\"/>"
+    "<reg name=\"x\" bitsize=\"8\" type=\"uint8\"/>"
+    "<reg name=\"y\" bitsize=\"8\" type=\"uint8\"/>"
+    "<reg name=\"s\" bitsize=\"8\" type=\"uint8\"/>"
+    "<reg name=\"p\" bitsize=\"8\" type=\"uint8\"/>"
+    "<reg name=\"pc\" bitsize=\"16\" type=\"code_ptr\"/>"
+    "</feature>"
+    "</target>";
+
+static const char s_hex[] = "0123456789abcdef";
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static void append_hex(std::string& out, u8 v) {
+    out += s_hex[v >> 4];
+    out += s_hex[v & 15];
+}
+
+// WHAT: Parses "addr,len" (hex) starting at 'pos'; 'pos' ends after 'len'.
+static bool parse_addr_len(const std::string& s, size_t& pos, u32& addr, u32& len) {
+    char* end = nullptr;
+    addr = (u32)std::strtoul(s.c_str() + pos, &end, 16);
+    if (*end != ',') return false;
+    len = (u32)std::strtoul(end + 1, &end, 16);
+    pos = (size_t)(end - s.c_str());
+    return addr <= 0xFFFF;
+}
+
+// ============================================================================
+//  Network Side
+// ============================================================================
+//  Everything in here runs on the asio thread, except the queues/flags that
+//  poll() reads (mutex or atomics).
+// ============================================================================
+struct gdb_server::impl {
+    asio::io_context io;
+    asio::basic_socket_acceptor<stream_protocol> acceptor{io};
+    stream_protocol::socket socket{io};
+    std::thread thread;
+    std::string unix_path;              // Removed again on stop()
+
+    // Packet framing
+    enum frame_state { IDLE, DATA, CHECKSUM1, CHECKSUM2 };
+    frame_state state = IDLE;
+    std::string frame;
+    u8  sum = 0;
+    int checksum = 0;
+    char rx[4096];
+
+    // Replies (asio thread only)
+    std::deque<std::string> outbox;
+    bool writing = false;
+
+    // Shared with poll()
+    std::mutex lock;
+    std::deque<std::string> inbox;
+    std::atomic<bool> no_ack{false};
+    std::atomic<bool> interrupt{false};
+    std::atomic<bool> is_connected{false};
+    std::atomic<bool> dropped{false};
+
+    void accept() {
+        acceptor.async_accept(socket, [this](const asio::error_code& ec) {
+            if (ec) return;     // Acceptor closed
+            std::cout << "[GDB] Client connected." << std::endl;
+            state = IDLE;
+            no_ack = false;
+            is_connected = true;
+            read();
+        });
+    }
+
+    void read() {
+        socket.async_read_some(asio::buffer(rx), [this](const asio::error_code& ec, size_t n) {
+            if (ec) {
+                disconnect();
+                return;
+            }
+            for (size_t i = 0; i < n; i++) receive((u8)rx[i]);
+            read();
+        });
+    }
+
+    void disconnect() {
+        if (!is_connected) return;
+        asio::error_code ignore;
+        socket.close(ignore);
+        outbox.clear();
+        writing = false;
+        is_connected = false;
+        dropped = true;
+        std::cout << "[GDB] Client disconnected." << std::endl;
+        accept();
+    }
+
+    void receive(u8 c) {
+        switch (state) {
+            case IDLE:
+                if (c == '$') { frame.clear(); sum = 0; state = DATA; }
+                else if (c == 0x03) interrupt = true;       // Ctrl-C
+                break;                                      // '+' / '-' acks: nothing to resend
+            case DATA:
+                if (c == '#') { state = CHECKSUM1; break; }
+                frame += (char)c;
+                sum = (u8)(sum + c);
+                break;
+            case CHECKSUM1:
+                checksum = hex_value((char)c) << 4;
+                state = CHECKSUM2;
+                break;
+            case CHECKSUM2:
+                checksum |= hex_value((char)c);
+                state = IDLE;
+                if (no_ack) {
+                    queue(frame);
+                } else if (checksum == sum) {
+                    write("+");
+                    queue(frame);
+                } else {
+                    write("-");
+                }
+                break;
+        }
+    }
+
+    void queue(const std::string& packet) {
+        std::lock_guard<std::mutex> guard(lock);
+        inbox.push_back(packet);
+    }
+
+    void write(std::string data) {
+        outbox.push_back(std::move(data));
+        if (!writing) write_next();
+    }
+
+    void write_next() {
+        if (outbox.empty() || !is_connected) { writing = false; return; }
+        writing = true;
+        asio::async_write(socket, asio::buffer(outbox.front()), [this](const asio::error_code& ec, size_t) {
+            if (ec) { writing = false; return; }    // The read side reports the drop
+            outbox.pop_front();
+            write_next();
+        });
+    }
+};
+
+// ============================================================================
+//  Lifetime
+// ============================================================================
+gdb_server::gdb_server(m6502_p& cpu, step_func step)
+    : m_impl(std::make_unique<impl>()), m_cpu(cpu), m_step(std::move(step)) {}
+
+gdb_server::~gdb_server() {
+    stop();
+}
+
+bool gdb_server::start(const std::string& endpoint) {
+    asio::error_code ec;
+    stream_protocol::endpoint ep;
+
+    if (endpoint.compare(0, 4, "tcp:") == 0) {
+        int port = std::atoi(endpoint.c_str() + 4);
+        if (port <= 0 || port > 65535) {
+            std::cerr << "[GDB] Error: Bad port in " << endpoint << std::endl;
+            return false;
+        }
+        ep = asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), (unsigned short)port);
+    } else {
+#if defined(ASIO_HAS_LOCAL_SOCKETS)
+        std::remove(endpoint.c_str());      // Stale socket from a previous run
+        ep = asio::local::stream_protocol::endpoint(endpoint);
+        m_impl->unix_path = endpoint;
+#else
+        std::cerr << "[GDB] Error: Unix sockets are not available here, use tcp:PORT." << std::endl;
+        return false;
+#endif
+    }
+
+    impl& n = *m_impl;
+    n.acceptor.open(ep.protocol(), ec);
+    if (!ec && n.unix_path.empty()) n.acceptor.set_option(asio::socket_base::reuse_address(true), ec);
+    if (!ec) n.acceptor.bind(ep, ec);
+    if (!ec) n.acceptor.listen(1, ec);
+    if (ec) {
+        std::cerr << "[GDB] Error: Could not listen on " << endpoint << ": " << ec.message() << std::endl;
+        return false;
+    }
+
+    n.accept();
+    n.thread = std::thread([&n] { n.io.run(); });
+    std::cout << "[GDB] Listening on " << endpoint << std::endl;
+    return true;
+}
+
+void gdb_server::stop() {
+    impl& n = *m_impl;
+    if (!n.thread.joinable()) return;
+
+    n.io.stop();
+    n.thread.join();
+    asio::error_code ignore;
+    n.socket.close(ignore);
+    n.acceptor.close(ignore);
+    if (!n.unix_path.empty()) std::remove(n.unix_path.c_str());
+    clear_points();
+}
+
+bool gdb_server::connected() const {
+    return m_impl->is_connected;
+}
+
+// ============================================================================
+//  Emulation Side
+// ============================================================================
+void gdb_server::send(const std::string& payload) {
+    std::string packet;
+    packet.reserve(payload.size() + 4);
+    packet += '$';
+    u8 sum = 0;
+    for (char c : payload) {
+        // Binary payloads: '#', '$', '}' (and '*', run-length) are escaped
+        if (c == '#' || c == '$' || c == '}' || c == '*') {
+            packet += '}';
+            sum = (u8)(sum + '}');
+            c = (char)(c ^ 0x20);
+        }
+        packet += c;
+        sum = (u8)(sum + (u8)c);
+    }
+    packet += '#';
+    append_hex(packet, sum);
+
+    impl* n = m_impl.get();
+    asio::post(n->io, [n, packet = std::move(packet)]() mutable { n->write(std::move(packet)); });
+}
+
+std::string gdb_server::stop_reply(int signal) const {
+    std::string reply = "T";
+    append_hex(reply, (u8)signal);
+
+    const device_debug& dbg = m_cpu.debug();
+    if (dbg.break_pending() && dbg.break_watch_address() >= 0) {
+        char field[24];
+        std::snprintf(field, sizeof(field), "%s:%04x;", dbg.break_watch_write() ? "watch" : "rwatch",
+                      (unsigned)dbg.break_watch_address());
+        reply += field;
+    }
+    // PC, so GDB doesn't have to ask
+    reply += "05:";
+    append_hex(reply, (u8)(m_cpu.get_pc() & 0xFF));
+    append_hex(reply, (u8)(m_cpu.get_pc() >> 8));
+    reply += ';';
+    return reply;
+}
+
+void gdb_server::poll(bool& is_paused) {
+    impl& n = *m_impl;
+
+    if (n.dropped.exchange(false)) {
+        clear_points();
+        m_running = false;
+    }
+
+    // Stop reply owed for the last 'c'?
+    if (m_running) {
+        if (n.interrupt.exchange(false)) {
+            is_paused = true;
+            m_running = false;
+            send(stop_reply(2));        // SIGINT
+        } else if (m_cpu.debug().break_pending() || is_paused) {
+            is_paused = true;
+            m_running = false;
+            send(stop_reply(5));        // SIGTRAP
+        }
+    } else {
+        n.interrupt = false;
+    }
+
+    std::deque<std::string> packets;
+    {
+        std::lock_guard<std::mutex> guard(n.lock);
+        packets.swap(n.inbox);
+    }
+    for (const std::string& p : packets) handle(p, is_paused);
+}
+
+void gdb_server::clear_points() {
+    device_debug& dbg = m_cpu.debug();
+    for (auto& bp : m_breakpoints) dbg.breakpoint_clear(bp.second);
+    for (auto& wp : m_watchpoints) dbg.watchpoint_clear(wp.second);
+    m_breakpoints.clear();
+    m_watchpoints.clear();
+}
+
+// ============================================================================
+//  Registers & Memory
+// ============================================================================
+std::string gdb_server::read_registers() const {
+    std::string out;
+    append_hex(out, m_cpu.get_a());
+    append_hex(out, m_cpu.get_x());
+    append_hex(out, m_cpu.get_y());
+    append_hex(out, m_cpu.get_sp());
+    append_hex(out, m_cpu.get_flags());
+    append_hex(out, (u8)(m_cpu.get_pc() & 0xFF));
+    append_hex(out, (u8)(m_cpu.get_pc() >> 8));
+    return out;
+}
+
+bool gdb_server::write_register(int reg, u32 value) {
+    switch (reg) {
+        case 0: m_cpu.set_a((u8)value);     return true;
+        case 1: m_cpu.set_x((u8)value);     return true;
+        case 2: m_cpu.set_y((u8)value);     return true;
+        case 3: m_cpu.set_sp((u8)value);    return true;
+        case 4: m_cpu.set_flags((u8)value); return true;
+        case 5: m_cpu.set_pc((u16)value);   return true;
+    }
+    return false;
+}
+
+std::string gdb_server::read_memory(u16 addr, u32 len) const {
+    if (len > PACKET_SIZE / 2) len = PACKET_SIZE / 2;
+    std::vector<u8> bytes(len);
+    m_cpu.read_range_debug(addr, len, bytes.data());
+
+    std::string out;
+    out.reserve(len * 2);
+    for (u8 b : bytes) append_hex(out, b);
+    return out;
+}
+
+void gdb_server::write_memory(u16 addr, const u8* data, u32 len) {
+    for (u32 i = 0; i < len; i++) m_cpu.write_byte((u16)(addr + i), data[i]);
+}
+
+// WHAT: Z/z packets. "Z0,addr,kind" (software), Z1 (hardware: same thing
+//       here), Z2 write / Z3 read / Z4 access watchpoints over addr..addr+len-1.
+std::string gdb_server::set_point(char op, const std::string& args) {
+    const bool insert = (op == 'Z');
+    const int type = hex_value(args.empty() ? 'x' : args[0]);
+    size_t pos = 2;
+    u32 addr = 0, len = 0;
+    if (type < 0 || args.size() < 3 || !parse_addr_len(args, pos, addr, len)) return "E01";
+
+    device_debug& dbg = m_cpu.debug();
+
+    if (type == 0 || type == 1) {
+        auto it = m_breakpoints.find((u16)addr);
+        if (insert && it == m_breakpoints.end()) {
+            m_breakpoints[(u16)addr] = dbg.breakpoint_set((u16)addr);
+        } else if (!insert && it != m_breakpoints.end()) {
+            dbg.breakpoint_clear(it->second);
+            m_breakpoints.erase(it);
+        }
+        return "OK";
+    }
+
+    if (type >= 2 && type <= 4) {
+        if (len == 0) len = 1;
+        u32 last = addr + len - 1;
+        if (last > 0xFFFF) last = 0xFFFF;
+        const u8 access = (type == 2) ? device_debug::WATCH_WRITE
+                        : (type == 3) ? device_debug::WATCH_READ
+                        : (u8)(device_debug::WATCH_READ | device_debug::WATCH_WRITE);
+        const u64 key = ((u64)type << 48) | ((u64)addr << 32) | len;
+
+        auto it = m_watchpoints.find(key);
+        if (insert && it == m_watchpoints.end()) {
+            m_watchpoints[key] = dbg.watchpoint_set((u16)addr, (u16)last, access);
+        } else if (!insert && it != m_watchpoints.end()) {
+            dbg.watchpoint_clear(it->second);
+            m_watchpoints.erase(it);
+        }
+        return "OK";
+    }
+    return "";      // Unsupported type
+}
+
+// ============================================================================
+//  Command Dispatch
+// ============================================================================
+void gdb_server::handle(const std::string& p, bool& is_paused) {
+    if (p.empty()) return;
+
+    auto resume = [&](bool step) {
+        if (step) {
+            m_step();
+            is_paused = true;
+            send(stop_reply(5));
+        } else {
+            is_paused = false;
+            m_running = true;
+        }
+    };
+
+    switch (p[0]) {
+        case '?':
+            send(is_paused ? stop_reply(5) : "S00");
+            return;
+
+        case 'c':
+        case 's':
+            if (p.size() > 1) m_cpu.set_pc((u16)std::strtoul(p.c_str() + 1, nullptr, 16));
+            resume(p[0] == 's');
+            return;
+
+        case 'g':
+            send(read_registers());
+            return;
+
+        case 'G': {
+            u8 regs[7];
+            if (p.size() < 1 + 14) { send("E01"); return; }
+            for (int i = 0; i < 7; i++) {
+                regs[i] = (u8)((hex_value(p[1 + i * 2]) << 4) | hex_value(p[2 + i * 2]));
+            }
+            for (int i = 0; i < 5; i++) write_register(i, regs[i]);
+            write_register(5, regs[5] | (regs[6] << 8));
+            send("OK");
+            return;
+        }
+
+        case 'p': {
+            int reg = (int)std::strtol(p.c_str() + 1, nullptr, 16);
+            std::string out;
+            switch (reg) {
+                case 0: append_hex(out, m_cpu.get_a());     break;
+                case 1: append_hex(out, m_cpu.get_x());     break;
+                case 2: append_hex(out, m_cpu.get_y());     break;
+                case 3: append_hex(out, m_cpu.get_sp());    break;
+                case 4: append_hex(out, m_cpu.get_flags()); break;
+                case 5:
+                    append_hex(out, (u8)(m_cpu.get_pc() & 0xFF));
+                    append_hex(out, (u8)(m_cpu.get_pc() >> 8));
+                    break;
+                default: out = "E01";
+            }
+            send(out);
+            return;
+        }
+
+        case 'P': {
+            char* end = nullptr;
+            int reg = (int)std::strtol(p.c_str() + 1, &end, 16);
+            if (*end != '=') { send("E01"); return; }
+            // Value is target byte order (little endian)
+            u32 value = 0;
+            int shift = 0;
+            for (const char* h = end + 1; h[0] && h[1] && shift < 32; h += 2, shift += 8) {
+                value |= (u32)((hex_value(h[0]) << 4) | hex_value(h[1])) << shift;
+            }
+            send(write_register(reg, value) ? "OK" : "E01");
+            return;
+        }
+
+        case 'm': {
+            size_t pos = 1;
+            u32 addr = 0, len = 0;
+            if (!parse_addr_len(p, pos, addr, len)) { send("E01"); return; }
+            send(read_memory((u16)addr, len));
+            return;
+        }
+
+        case 'M':
+        case 'X': {
+            size_t pos = 1;
+            u32 addr = 0, len = 0;
+            if (!parse_addr_len(p, pos, addr, len) || pos >= p.size() || p[pos] != ':') { send("E01"); return; }
+            std::vector<u8> data;
+            data.reserve(len);
+            if (p[0] == 'M') {
+                for (size_t i = pos + 1; i + 1 < p.size(); i += 2) {
+                    data.push_back((u8)((hex_value(p[i]) << 4) | hex_value(p[i + 1])));
+                }
+            } else {
+                for (size_t i = pos + 1; i < p.size(); i++) {
+                    u8 c = (u8)p[i];
+                    if (c == '}' && i + 1 < p.size()) c = (u8)(p[++i] ^ 0x20);
+                    data.push_back(c);
+                }
+            }
+            if (data.size() < len) { send("E01"); return; }
+            write_memory((u16)addr, data.data(), len);
+            send("OK");
+            return;
+        }
+
+        case 'Z':
+        case 'z':
+            send(set_point(p[0], p.substr(1)));
+            return;
+
+        case 'H':
+            send("OK");     // One thread
+            return;
+
+        case 'T':
+            send("OK");
+            return;
+
+        case 'D':
+            clear_points();
+            m_running = false;
+            send("OK");
+            return;
+
+        case 'k':
+            clear_points();
+            m_running = false;
+            return;         // No reply; the client closes the connection
+    }
+
+    // --- Queries ---
+    if (p.compare(0, 10, "qSupported") == 0) {
+        char reply[96];
+        std::snprintf(reply, sizeof(reply), "PacketSize=%zx;QStartNoAckMode+;qXfer:features:read+;vContSupported+",
+                      PACKET_SIZE);
+        send(reply);
+    } else if (p == "QStartNoAckMode") {
+        send("OK");
+        m_impl->no_ack = true;
+    } else if (p.compare(0, 31, "qXfer:features:read:target.xml:") == 0) {
+        size_t pos = 31;
+        u32 offset = 0, len = 0;
+        char* end = nullptr;
+        if (p.size() > pos) {
+            offset = (u32)std::strtoul(p.c_str() + pos, &end, 16);
+            if (*end == ',') len = (u32)std::strtoul(end + 1, nullptr, 16);
+        }
+        const u32 size = (u32)(sizeof(s_target_xml) - 1);
+        if (offset >= size) { send("l"); return; }
+        const u32 n = (size - offset < len) ? size - offset : len;
+        send(std::string(offset + n >= size ? "l" : "m") + std::string(s_target_xml + offset, n));
+    } else if (p == "qAttached") {
+        send("1");
+    } else if (p == "qfThreadInfo") {
+        send("m1");
+    } else if (p == "qsThreadInfo") {
+        send("l");
+    } else if (p == "qC") {
+        send("QC1");
+    } else if (p == "qOffsets") {
+        send("Text=0;Data=0;Bss=0");
+    } else if (p == "vCont?") {
+        send("vCont;c;s");
+    } else if (p.compare(0, 6, "vCont;") == 0 && p.size() > 6 && (p[6] == 'c' || p[6] == 's')) {
+        resume(p[6] == 's');
+    } else {
+        send("");       // Unsupported
+    }
+}
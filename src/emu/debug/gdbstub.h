@@ -0,0 +1,78 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include "../types.h"
+
+class m6502_p;
+
+// ============================================================================
+//  gdb_server
+// ============================================================================
+//  WHAT: A GDB Remote Serial Protocol stub, so GDB (or any RSP script) can
+//        read/write registers and memory, set breakpoints and watchpoints,
+//        step and continue.
+//  WHO:  Created by main() for --gdb. The socket lives on a private asio
+//        thread; everything that touches the machine happens in poll(),
+//        on the emulation thread, between run slices.
+//  WHY:  The CPU loop never sees the stub. Breakpoints and watchpoints are
+//        the regular device_debug ones (bitmap / page flags), so there is no
+//        per-instruction cost beyond what the debugger already has.
+//  HOW:  Network thread: frames "$data#cs" packets, acks them and queues
+//        them. poll(): runs queued commands and sends replies; when a
+//        continue stops (breakpoint, watchpoint, UI pause, Ctrl-C) it sends
+//        the stop reply.
+//
+//  Endpoints:  "/path/to/sock" (Unix domain socket) or "tcp:PORT"
+//              (127.0.0.1 only).
+//  Registers:  0 A, 1 X, 2 Y, 3 S, 4 P (8 bit), 5 PC (16 bit, little endian).
+//              Described to GDB by target.xml (qXfer:features:read).
+//  Memory:     'm' reads up to PacketSize/2 bytes with one read_range_debug
+//              (no side effects); 'M' and binary 'X' write through the bus.
+// ============================================================================
+class gdb_server {
+public:
+    // Runs exactly one instruction on the board (VIA/LCD keep in step)
+    using step_func = std::function<void()>;
+
+    gdb_server(m6502_p& cpu, step_func step);
+    ~gdb_server();
+
+    // WHAT: Starts listening. Returns false (with a console message) if the
+    //       endpoint can't be opened.
+    bool start(const std::string& endpoint);
+    void stop();
+
+    // WHAT: Executes pending commands. May pause or resume the machine.
+    // WHEN: Every frame / run slice, after running and before the UI draws
+    //       (so a breakpoint stop is seen before the UI consumes it).
+    void poll(bool& is_paused);
+
+    bool connected() const;
+
+    static constexpr size_t PACKET_SIZE = 0x4000;   // Advertised to GDB
+
+private:
+    struct impl;
+    std::unique_ptr<impl> m_impl;
+
+    m6502_p& m_cpu;
+    step_func m_step;
+
+    bool m_running = false;                 // 'c' sent, stop reply owed
+    std::map<u16, int> m_breakpoints;       // Address -> device_debug index
+    std::map<u64, int> m_watchpoints;       // (type, addr, len) -> index
+
+    void handle(const std::string& packet, bool& is_paused);
+    void send(const std::string& payload);
+    std::string stop_reply(int signal) const;
+    void clear_points();
+
+    std::string read_registers() const;
+    bool write_register(int reg, u32 value);
+    std::string read_memory(u16 addr, u32 len) const;
+    void write_memory(u16 addr, const u8* data, u32 len);
+    std::string set_point(char op, const std::string& args);
+};
@@ -0,0 +1,67 @@
+#include "heatmap.h"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HEATMAP_SSE2 1
+#endif
+
+void debug_heatmap::clear() {
+    std::memset(m_count, 0, sizeof(m_count));
+}
+
+// ============================================================================
+//  Decay
+// ============================================================================
+//  c -= ceil(c / 2^shift), i.e. c -= (c + 2^shift - 1) >> shift.
+//  A count of 1 drops to 0 in one step, large counts shrink geometrically.
+// ============================================================================
+void debug_heatmap::decay(int shift) {
+    if (shift < 1) shift = 1;
+    if (shift > 16) shift = 16;
+    u32* c = &m_count[0][0];
+    const int n = CHANNELS * 0x10000;
+
+#ifdef HEATMAP_SSE2
+    const __m128i bias  = _mm_set1_epi32((1 << shift) - 1);
+    const __m128i count = _mm_cvtsi32_si128(shift);
+    for (int i = 0; i < n; i += 4) {
+        __m128i v = _mm_load_si128((const __m128i*)(c + i));
+        __m128i d = _mm_srl_epi32(_mm_add_epi32(v, bias), count);
+        _mm_store_si128((__m128i*)(c + i), _mm_sub_epi32(v, d));
+    }
+#else
+    const u32 bias = (1u << shift) - 1;
+    for (int i = 0; i < n; i++) c[i] -= (c[i] + bias) >> shift;
+#endif
+}
+
+// ============================================================================
+//  Render
+// ============================================================================
+//  Brightness is the bit length of the count (0-32), so 1 access is
+//  visible and 65535 per frame is full white-hot.
+// ============================================================================
+static inline u32 bit_length(u32 v) {
+#if defined(__GNUC__)
+    return v ? 32 - (u32)__builtin_clz(v) : 0;
+#else
+    u32 n = 0;
+    while (v) { n++; v >>= 1; }
+    return n;
+#endif
+}
+
+static inline u32 level(u32 count) {
+    u32 l = bit_length(count) * 16;
+    return l > 255 ? 255 : l;
+}
+
+void debug_heatmap::render(u32* rgba) const {
+    const u32* rd = m_count[READ];
+    const u32* wr = m_count[WRITE];
+    const u32* ex = m_count[EXECUTE];
+    for (int i = 0; i < 0x10000; i++) {
+        rgba[i] = level(wr[i]) | (level(ex[i]) << 8) | (level(rd[i]) << 16) | 0xFF000000u;
+    }
+}
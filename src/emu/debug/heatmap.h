@@ -0,0 +1,47 @@
+#pragma once
+
+#include "../types.h"
+
+// ============================================================================
+//  debug_heatmap
+// ============================================================================
+//  WHAT: Read / write / execute counters for every address in the 64K space.
+//  WHO:  Created by the DebugView while the heatmap window is open and
+//        handed to device_debug, which feeds it from the address map (reads,
+//        writes) and the CPU's instrumented loop (opcode fetches).
+//  WHY:  Shows at a glance which zero-page variables, stack regions and ROM
+//        routines are hot. Counters decay every frame, so the picture follows
+//        what the program is doing now rather than since power-on.
+//  HOW:  Three flat u32 arrays. Counting is a single increment; decay and
+//        rendering are straight passes over the arrays (SSE2 where
+//        available). When no heatmap is attached the bus does no extra work.
+// ============================================================================
+class debug_heatmap {
+public:
+    enum channel { READ, WRITE, EXECUTE, CHANNELS };
+
+    debug_heatmap() { clear(); }
+
+    void count_read(u16 addr)    { m_count[READ][addr]++; }
+    void count_write(u16 addr)   { m_count[WRITE][addr]++; }
+    void count_execute(u16 addr) { m_count[EXECUTE][addr]++; }
+
+    u32 count(channel ch, u16 addr) const { return m_count[ch][addr]; }
+
+    void clear();
+
+    // WHAT: Exponential decay: every counter loses 1/2^shift of its value
+    //       (rounded up, so idle addresses reach zero).
+    // WHEN: Once per UI frame.
+    void decay(int shift);
+
+    // WHAT: 256x256 RGBA image (row = high byte, column = low byte).
+    //       Red = writes, green = executes, blue = reads, brightness on a
+    //       log scale.
+    // HOW:  'rgba' must hold 65536 pixels (R in the lowest byte, as OpenGL
+    //       expects for GL_RGBA / GL_UNSIGNED_BYTE on little-endian hosts).
+    void render(u32* rgba) const;
+
+private:
+    alignas(16) u32 m_count[CHANNELS][0x10000];
+};
@@ -0,0 +1,235 @@
+#include "search.h"
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SEARCH_SSE2 1
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SEARCH_AVX2 1
+#endif
+
+static inline int popcount16(u16 v) {
+#if defined(__GNUC__)
+    return __builtin_popcount(v);
+#else
+    int n = 0;
+    while (v) { v &= (u16)(v - 1); n++; }
+    return n;
+#endif
+}
+
+static inline int lowest_bit(u32 v) {
+#if defined(__GNUC__)
+    return __builtin_ctz(v);
+#else
+    int n = 0;
+    while (!(v & 1)) { v >>= 1; n++; }
+    return n;
+#endif
+}
+
+// ============================================================================
+//  memory_find: Pattern Parsing
+// ============================================================================
+bool memory_find::parse(const std::string& text, std::string& error) {
+    m_bytes.clear();
+    m_mask.clear();
+    m_anchor = -1;
+
+    size_t i = 0;
+    while (i < text.size()) {
+        char c = text[i];
+        if (std::isspace((unsigned char)c) || c == ',') { i++; continue; }
+
+        // "text"
+        if (c == '"') {
+            size_t close = text.find('"', i + 1);
+            if (close == std::string::npos) { error = "Unterminated string"; return false; }
+            for (size_t k = i + 1; k < close; k++) {
+                m_bytes.push_back((u8)text[k]);
+                m_mask.push_back(0xFF);
+            }
+            i = close + 1;
+            continue;
+        }
+
+        // ?? or * wildcard
+        if (c == '?' || c == '*') {
+            m_bytes.push_back(0);
+            m_mask.push_back(0x00);
+            i += (c == '?' && i + 1 < text.size() && text[i + 1] == '?') ? 2 : 1;
+            continue;
+        }
+
+        // Hex byte ($ prefix allowed)
+        if (c == '$') { i++; continue; }
+        if (i + 1 < text.size() && std::isxdigit((unsigned char)c) && std::isxdigit((unsigned char)text[i + 1])) {
+            m_bytes.push_back((u8)std::strtoul(text.substr(i, 2).c_str(), nullptr, 16));
+            m_mask.push_back(0xFF);
+            i += 2;
+            continue;
+        }
+
+        error = std::string("Unexpected '") + c + "' (use hex bytes, ?? or \"text\")";
+        return false;
+    }
+
+    for (size_t k = 0; k < m_mask.size(); k++) {
+        if (m_mask[k]) { m_anchor = (int)k; break; }
+    }
+    if (m_bytes.empty())  { error = "Empty pattern"; return false; }
+    if (m_anchor < 0)     { error = "Pattern is all wildcards"; return false; }
+    if (m_bytes.size() > 256) { error = "Pattern too long (max 256 bytes)"; return false; }
+    return true;
+}
+
+// ============================================================================
+//  memory_find: Search
+// ============================================================================
+//  HOW:  The anchor byte is compared 16 (or 32) positions at a time; only
+//        the positions it matches are checked against the whole pattern.
+// ============================================================================
+void memory_find::find(const u8* mem, u16 start, u16 end, std::vector<u16>& hits, size_t max_hits) const {
+    hits.clear();
+    if (m_anchor < 0) return;
+
+    const int len = (int)m_bytes.size();
+    int last = (int)end;
+    if (last > 0x10000 - len) last = 0x10000 - len;
+    const u8* bytes = m_bytes.data();
+    const u8* mask = m_mask.data();
+    const u8 key = bytes[m_anchor];
+
+    auto matches = [&](int p) {
+        for (int k = 0; k < len; k++) {
+            if ((mem[p + k] ^ bytes[k]) & mask[k]) return false;
+        }
+        return true;
+    };
+
+    int p = start;
+
+    // The anchor byte of position p is mem[p + anchor]. Since every
+    // position is <= last = 64K - len, the vector loads stay in the buffer.
+#ifdef SEARCH_AVX2
+    const __m256i key32 = _mm256_set1_epi8((char)key);
+    for (; p + 31 <= last; p += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(mem + p + m_anchor));
+        u32 bits = (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, key32));
+        while (bits) {
+            int q = p + lowest_bit(bits);
+            bits &= bits - 1;
+            if (matches(q)) {
+                hits.push_back((u16)q);
+                if (hits.size() >= max_hits) return;
+            }
+        }
+    }
+#endif
+#ifdef SEARCH_SSE2
+    const __m128i key16 = _mm_set1_epi8((char)key);
+    for (; p + 15 <= last; p += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(mem + p + m_anchor));
+        u32 bits = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(v, key16));
+        while (bits) {
+            int q = p + lowest_bit(bits);
+            bits &= bits - 1;
+            if (matches(q)) {
+                hits.push_back((u16)q);
+                if (hits.size() >= max_hits) return;
+            }
+        }
+    }
+#endif
+    for (; p <= last; p++) {
+        if (mem[p + m_anchor] == key && matches(p)) {
+            hits.push_back((u16)p);
+            if (hits.size() >= max_hits) return;
+        }
+    }
+}
+
+// ============================================================================
+//  memory_scanner
+// ============================================================================
+void memory_scanner::start(const u8* mem, u16 start, u16 end) {
+    std::memset(m_live, 0, sizeof(m_live));
+    for (int a = start; a <= end; a++) m_live[a >> 4] |= (u16)(1u << (a & 15));
+    std::memcpy(m_prev, mem, sizeof(m_prev));
+    m_started = true;
+    recount();
+}
+
+// WHAT: 16 "keep" bits for the bytes at cur[0..15].
+// HOW:  Unsigned compares from min/max: a <= b  <=>  min(a, b) == a.
+static u16 keep_mask(const u8* cur, const u8* prev, memory_scanner::condition cond, u8 value) {
+#ifdef SEARCH_SSE2
+    const __m128i c = _mm_loadu_si128((const __m128i*)cur);
+    const __m128i r = (cond >= memory_scanner::CHANGED) ? _mm_load_si128((const __m128i*)prev)
+                                                        : _mm_set1_epi8((char)value);
+    switch (cond) {
+        case memory_scanner::EQUAL:
+        case memory_scanner::UNCHANGED:
+            return (u16)_mm_movemask_epi8(_mm_cmpeq_epi8(c, r));
+        case memory_scanner::NOT_EQUAL:
+        case memory_scanner::CHANGED:
+            return (u16)~_mm_movemask_epi8(_mm_cmpeq_epi8(c, r));
+        case memory_scanner::GREATER:
+        case memory_scanner::INCREASED:     // c > r  <=>  !(c <= r)
+            return (u16)~_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(c, r), c));
+        case memory_scanner::LESS:
+        case memory_scanner::DECREASED:     // c < r  <=>  !(c >= r)
+            return (u16)~_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(c, r), c));
+    }
+    return 0;
+#else
+    u16 bits = 0;
+    for (int i = 0; i < 16; i++) {
+        const u8 r = (cond >= memory_scanner::CHANGED) ? prev[i] : value;
+        bool keep = false;
+        switch (cond) {
+            case memory_scanner::EQUAL:
+            case memory_scanner::UNCHANGED: keep = cur[i] == r; break;
+            case memory_scanner::NOT_EQUAL:
+            case memory_scanner::CHANGED:   keep = cur[i] != r; break;
+            case memory_scanner::GREATER:
+            case memory_scanner::INCREASED: keep = cur[i] >  r; break;
+            case memory_scanner::LESS:
+            case memory_scanner::DECREASED: keep = cur[i] <  r; break;
+        }
+        if (keep) bits |= (u16)(1u << i);
+    }
+    return bits;
+#endif
+}
+
+void memory_scanner::narrow(const u8* mem, condition cond, u8 value) {
+    if (!m_started) return;
+
+    for (int c = 0; c < 0x10000 / 16; c++) {
+        if (!m_live[c]) continue;       // Most chunks die in the first steps
+        m_live[c] &= keep_mask(mem + c * 16, m_prev + c * 16, cond, value);
+    }
+    std::memcpy(m_prev, mem, sizeof(m_prev));
+    recount();
+}
+
+void memory_scanner::recount() {
+    m_count = 0;
+    for (u16 bits : m_live) m_count += popcount16(bits);
+}
+
+void memory_scanner::results(std::vector<u16>& out, size_t max) const {
+    out.clear();
+    for (int c = 0; c < 0x10000 / 16 && out.size() < max; c++) {
+        u32 bits = m_live[c];
+        while (bits && out.size() < max) {
+            out.push_back((u16)(c * 16 + lowest_bit(bits)));
+            bits &= bits - 1;
+        }
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "../types.h"
+
+// ============================================================================
+//  Memory Search
+// ============================================================================
+//  WHAT: Tools for finding where the firmware keeps things:
+//          - memory_find:    byte patterns with wildcards ("A9 ?? 8D").
+//          - memory_scanner: a candidate set narrowed step by step
+//                            ("changed", "increased", "== 5"), like the
+//                            MAME cheat engine.
+//  WHO:  Driven by the DebugView's search window. Both work on a 64K
+//        snapshot from read_range_debug, never on the live bus.
+//  WHY:  A full-space pass is 4096 16-byte vector compares (SSE2, AVX2 when
+//        the build enables it), so scans take microseconds.
+// ============================================================================
+
+// ============================================================================
+//  memory_find
+// ============================================================================
+class memory_find {
+public:
+    // WHAT: Compiles a pattern. Accepted:
+    //         A9 ?? 8D        hex bytes, "??" (or "*") matches anything
+    //         "Hello"         quoted text
+    //       Returns false with 'error' set if the text doesn't parse.
+    bool parse(const std::string& text, std::string& error);
+
+    // WHAT: Every address in [start, end] where the pattern begins (the
+    //       pattern must fit before $FFFF). Stops after 'max_hits'.
+    void find(const u8* mem, u16 start, u16 end, std::vector<u16>& hits, size_t max_hits) const;
+
+    size_t length() const { return m_bytes.size(); }
+
+private:
+    std::vector<u8> m_bytes;
+    std::vector<u8> m_mask;     // 0xFF = must match, 0x00 = wildcard
+    int m_anchor = -1;          // First non-wildcard byte (the vector compare key)
+};
+
+// ============================================================================
+//  memory_scanner
+// ============================================================================
+class memory_scanner {
+public:
+    enum condition {
+        EQUAL, NOT_EQUAL, GREATER, LESS,        // Against a value
+        CHANGED, UNCHANGED, INCREASED, DECREASED // Against the previous snapshot
+    };
+
+    // WHAT: Starts over: every address in [start, end] is a candidate and
+    //       'mem' becomes the reference snapshot.
+    void start(const u8* mem, u16 start, u16 end);
+
+    // WHAT: Drops candidates that fail 'cond', then remembers 'mem' as the
+    //       new previous snapshot.
+    void narrow(const u8* mem, condition cond, u8 value);
+
+    bool   started() const   { return m_started; }
+    size_t count() const     { return m_count; }
+    u8     previous(u16 addr) const { return m_prev[addr]; }
+
+    // WHAT: The first 'max' candidate addresses, ascending.
+    void results(std::vector<u16>& out, size_t max) const;
+
+private:
+    // Bit i of m_live[c] = address c*16 + i is still a candidate
+    u16 m_live[0x10000 / 16] = {};
+    alignas(16) u8 m_prev[0x10000] = {};
+    size_t m_count = 0;
+    bool m_started = false;
+
+    void recount();
+};
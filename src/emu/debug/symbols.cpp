@@ -0,0 +1,196 @@
+#include "symbols.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <utility>
+
+// ============================================================================
+//  Loading
+// ============================================================================
+bool symbol_table::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        std::cerr << "[Symbols] Error: Could not open " << path << std::endl;
+        return false;
+    }
+
+    // Parse everything first, then sort once (files can hold thousands)
+    size_t loaded = 0;
+    size_t skipped = 0;
+    std::string line;
+    std::string name;
+    u16 addr = 0;
+    while (std::getline(in, line)) {
+        if (!parse_line(line, name, addr)) { skipped++; continue; }
+        if (name.empty()) continue;
+        m_by_name[name] = addr;     // A later definition wins
+        m_sorted.push_back({ addr, name });
+        loaded++;
+    }
+
+    // Drop entries that a later line redefined
+    m_sorted.erase(std::remove_if(m_sorted.begin(), m_sorted.end(),
+                   [this](const symbol& s) { return m_by_name[s.name] != s.address; }),
+                   m_sorted.end());
+    std::stable_sort(m_sorted.begin(), m_sorted.end(),
+                     [](const symbol& a, const symbol& b) { return a.address < b.address; });
+    m_sorted.erase(std::unique(m_sorted.begin(), m_sorted.end(),
+                   [](const symbol& a, const symbol& b) { return a.address == b.address && a.name == b.name; }),
+                   m_sorted.end());
+    m_generation++;
+
+    std::cout << "[Symbols] Loaded " << loaded << " symbols from " << path;
+    if (skipped) std::cout << " (" << skipped << " lines skipped)";
+    std::cout << std::endl;
+    return true;
+}
+
+std::string symbol_table::companion_path(const std::string& rom_path) {
+    size_t slash = rom_path.find_last_of("/\\");
+    size_t dot = rom_path.find_last_of('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return rom_path + ".sym";
+    return rom_path.substr(0, dot) + ".sym";
+}
+
+// WHAT: Parses a number written as $8100, 0x8100, 8100 (hex), or C:8100.
+static bool parse_address(std::string tok, u16& out) {
+    if (tok.size() > 2 && tok[1] == ':') tok = tok.substr(2);        // VICE "C:8100"
+    if (!tok.empty() && tok[0] == '$') tok = tok.substr(1);
+    else if (tok.size() > 2 && tok[0] == '0' && (tok[1] == 'x' || tok[1] == 'X')) tok = tok.substr(2);
+    if (tok.empty()) return false;
+
+    char* end = nullptr;
+    unsigned long v = std::strtoul(tok.c_str(), &end, 16);
+    if (*end != '\0' || v > 0xFFFFFF) return false;
+    out = (u16)v;     // ld65 writes 24-bit addresses
+    return true;
+}
+
+static bool is_identifier(const std::string& s) {
+    if (s.empty() || !(std::isalpha((unsigned char)s[0]) || s[0] == '_' || s[0] == '@' || s[0] == '.')) return false;
+    for (char c : s) {
+        if (!(std::isalnum((unsigned char)c) || c == '_' || c == '@' || c == '.')) return false;
+    }
+    return true;
+}
+
+bool symbol_table::parse_line(const std::string& raw, std::string& name_out, u16& addr_out) {
+    name_out.clear();
+
+    // Strip comments and surrounding blanks
+    std::string line = raw.substr(0, raw.find_first_of(";#"));
+    std::istringstream ss(line);
+    std::vector<std::string> tok;
+    for (std::string t; ss >> t; ) tok.push_back(t);
+    if (tok.empty()) return true;   // Blank / comment-only lines are fine
+
+    // "name=$8100" written without spaces
+    if (tok.size() == 1) {
+        size_t eq = tok[0].find('=');
+        if (eq == std::string::npos) return false;
+        tok = { tok[0].substr(0, eq), "=", tok[0].substr(eq + 1) };
+    }
+
+    u16 addr = 0;
+
+    // al 008100 .name
+    if (tok.size() == 3 && tok[0] == "al" && parse_address(tok[1], addr)) {
+        std::string name = tok[2];
+        if (!name.empty() && name[0] == '.') name = name.substr(1);
+        if (!is_identifier(name)) return false;
+        name_out = name;
+        addr_out = addr;
+        return true;
+    }
+
+    // name = $8100  /  name equ $8100  /  name: = $8100
+    if (tok.size() == 3) {
+        std::string op = tok[1];
+        for (auto& c : op) c = (char)std::tolower((unsigned char)c);
+        std::string name = tok[0];
+        if (!name.empty() && name.back() == ':') name.pop_back();
+        if ((op == "=" || op == "equ" || op == ":=") && is_identifier(name) && parse_address(tok[2], addr)) {
+            name_out = name;
+            addr_out = addr;
+            return true;
+        }
+    }
+
+    // 8100 name
+    if (tok.size() == 2 && parse_address(tok[0], addr) && is_identifier(tok[1])) {
+        name_out = tok[1];
+        addr_out = addr;
+        return true;
+    }
+    return false;
+}
+
+// ============================================================================
+//  Editing
+// ============================================================================
+void symbol_table::add(const std::string& name, u16 address) {
+    // Renaming an existing symbol: drop the old entry
+    auto old = m_by_name.find(name);
+    if (old != m_by_name.end()) {
+        u16 old_addr = old->second;
+        m_sorted.erase(std::remove_if(m_sorted.begin(), m_sorted.end(),
+                       [&](const symbol& s) { return s.address == old_addr && s.name == name; }),
+                       m_sorted.end());
+    }
+    m_by_name[name] = address;
+
+    // Insert after any existing symbols at the same address (first one wins)
+    auto it = std::upper_bound(m_sorted.begin(), m_sorted.end(), address,
+                               [](u16 a, const symbol& s) { return a < s.address; });
+    m_sorted.insert(it, { address, name });
+    m_generation++;
+}
+
+void symbol_table::clear() {
+    m_sorted.clear();
+    m_by_name.clear();
+    m_generation++;
+}
+
+void symbol_table::replace(symbol_table&& other) {
+    m_sorted = std::move(other.m_sorted);
+    m_by_name = std::move(other.m_by_name);
+    m_generation++;     // Ours, not other's: caches must see a change
+}
+
+// ============================================================================
+//  Lookup
+// ============================================================================
+bool symbol_table::find(const std::string& name, u16& address) const {
+    auto it = m_by_name.find(name);
+    if (it == m_by_name.end()) return false;
+    address = it->second;
+    return true;
+}
+
+const symbol_table::symbol* symbol_table::nearest(u16 address, u16 max_offset) const {
+    // Last entry with s.address <= address
+    auto it = std::upper_bound(m_sorted.begin(), m_sorted.end(), address,
+                               [](u16 a, const symbol& s) { return a < s.address; });
+    if (it == m_sorted.begin()) return nullptr;
+    --it;
+
+    // Several names on one address: report the first one added
+    u16 at = it->address;
+    while (it != m_sorted.begin() && (it - 1)->address == at) --it;
+
+    if ((u16)(address - it->address) > max_offset) return nullptr;
+    return &*it;
+}
+
+bool symbol_table::format(u16 address, char* buf, size_t size, u16 max_offset) const {
+    const symbol* s = nearest(address, max_offset);
+    if (!s) return false;
+    if (s->address == address) std::snprintf(buf, size, "%s", s->name.c_str());
+    else                       std::snprintf(buf, size, "%s+%u", s->name.c_str(), (unsigned)(address - s->address));
+    return true;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../types.h"
+
+// ============================================================================
+//  symbol_table
+// ============================================================================
+//  WHAT: Label names for addresses, loaded from assembler output.
+//  WHO:  Owned by device_debug. Used by the disassembly, stack and trace
+//        views to print "lcd_instruction" instead of "$8100".
+//  WHY:  Annotating is done per visible row and per trace line, so lookups
+//        must be cheap:
+//          - address -> nearest symbol: binary search in a flat array
+//            sorted by address (O(log n), no allocation).
+//          - name -> address: hash map.
+//
+//  Accepted formats (one symbol per line, ';' or '#' start a comment):
+//    name = $8100          (rom_build.py, hand-written maps; also 0x8100)
+//    name equ $8100
+//    al 008100 .name       (ca65/ld65 -Ln, vasm -Fvice; "al C:8100 .name")
+//    8100 name             (plain "address name" listings)
+// ============================================================================
+class symbol_table {
+public:
+    struct symbol {
+        u16 address;
+        std::string name;
+    };
+
+    // WHAT: Adds the symbols in 'path' to the table.
+    // HOW:  Returns false if the file can't be opened; lines that don't parse
+    //       are skipped (and counted in the console message).
+    bool load(const std::string& path);
+
+    // WHAT: "roms/hello.bin" -> "roms/hello.sym" (where rom_build.py puts them)
+    static std::string companion_path(const std::string& rom_path);
+
+    void add(const std::string& name, u16 address);
+    void clear();
+
+    // WHAT: Takes over 'other's symbols, dropping the current ones.
+    // WHY:  A reload goes into a scratch table first, so a bad path
+    //       leaves the loaded labels alone.
+    void replace(symbol_table&& other);
+
+    // WHAT: Name -> address. Returns false if unknown.
+    bool find(const std::string& name, u16& address) const;
+
+    // WHAT: The symbol at or below 'address' (nullptr if none within
+    //       'max_offset' bytes).
+    const symbol* nearest(u16 address, u16 max_offset = 0xFFFF) const;
+
+    // WHAT: Exact match only (for operands: "JSR lcd_instruction").
+    const symbol* exact(u16 address) const { return nearest(address, 0); }
+
+    // WHAT: "name" or "name+3" into 'buf'. Returns false (buf untouched)
+    //       if nothing is within 'max_offset'.
+    bool format(u16 address, char* buf, size_t size, u16 max_offset = 0xFFFF) const;
+
+    size_t size() const      { return m_sorted.size(); }
+    bool   empty() const     { return m_sorted.empty(); }
+    const std::vector<symbol>& symbols() const { return m_sorted; }
+
+    // WHAT: Bumped on every change, so caches holding formatted text know
+    //       to refresh.
+    u32 generation() const   { return m_generation; }
+
+private:
+    std::vector<symbol> m_sorted;                       // By address
+    std::unordered_map<std::string, u16> m_by_name;
+    u32 m_generation = 0;
+
+    // WHAT: One line -> (name, address). Blank lines succeed with no name.
+    static bool parse_line(const std::string& line, std::string& name, u16& address);
+};
@@ -58,6 +58,13 @@ class device_execute_interface {
         // HOW:  Direct assignment.
         void icount_set(s32 cycles) { m_icount = cycles; }
 
+        // WHAT: Ends the current timeslice early.
+        // WHEN: Called by the debugger when a breakpoint or watchpoint fires.
+        // WHY:  The CPU returns to the driver at the next instruction boundary
+        //       instead of burning the rest of its budget.
+        // HOW:  Empties the tank; the execution loop sees m_icount <= 0.
+        void abort_timeslice() { m_icount = 0; }
+
     protected:
         // ========================================================================
         //  Internal State
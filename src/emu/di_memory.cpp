@@ -1,5 +1,6 @@
 #include "di_memory.h"
 #include "map.h" // Include our new Map definition
+#include <cstring>
 
 // ============================================================================
 //  di_memory::read_byte
@@ -42,4 +43,12 @@ u8 device_memory_interface::read_byte_debug(u16 addr) {
             return m_map->read_debug(addr);
         }
         return 0xFF; // Default open bus value
-    }
\ No newline at end of file
+    }
+
+void device_memory_interface::read_range_debug(u16 start, u32 len, u8* out) {
+    if (m_map) {
+        m_map->read_range_debug(start, len, out);
+        return;
+    }
+    std::memset(out, 0xFF, len);
+}
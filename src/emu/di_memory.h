@@ -45,6 +45,10 @@ public:
     // NEW: Debugger Access (No side effects allowed!)
     u8 read_byte_debug(u16 addr);
 
+    // WHAT: Debugger bulk access: copies 'len' bytes from 'start' into 'out'.
+    // WHY:  One call per frame for a whole dump view instead of one per byte.
+    void read_range_debug(u16 start, u32 len, u8* out);
+
     // WHAT: The generic Write Byte function.
     // WHEN: Called by the CPU when executing "STA $1234".
     // WHY:  Abstracts the complex hardware lookup.
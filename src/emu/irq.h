@@ -0,0 +1,48 @@
+#pragma once
+
+#include "signal.h"
+#include "types.h"
+
+// ============================================================================
+//  irq_merger (Wired-OR /IRQ)
+// ============================================================================
+//  WHAT: The shared open-drain /IRQ wire. Every chip that can interrupt the
+//        CPU is a numbered source; the line is asserted while at least one
+//        source holds it.
+//  WHO:  The driver owns one, connects output() to the CPU's IRQ input and
+//        feeds each device's IRQ callback into set() with its own source id.
+//  WHY:  On the board /IRQ is pulled up and any chip can pull it low. With a
+//        single callback shared by every chip, one chip releasing the line
+//        would cancel another chip's request.
+//  HOW:  One bit per source. output() is asserted-high (true = some chip is
+//        pulling /IRQ low) and, being an output_line, only notifies the CPU
+//        when the OR of all bits changes.
+// ============================================================================
+class irq_merger {
+public:
+    static constexpr int MAX_SOURCES = 32;
+
+    // WHAT: Source 'id' (0..MAX_SOURCES-1) asserts or releases the line.
+    void set(int id, bool asserted) {
+        const u32 bit = 1u << id;
+        const u32 sources = asserted ? (m_sources | bit) : (m_sources & ~bit);
+        if (sources == m_sources) return;
+        m_sources = sources;
+        m_out.set(sources != 0);
+    }
+
+    // WHAT: Releases every source (board reset).
+    void clear() {
+        m_sources = 0;
+        m_out.set(false);
+    }
+
+    bool asserted() const { return m_sources != 0; }
+    u32  sources() const  { return m_sources; }     // Bit n = source n holds the line
+
+    output_line& output() { return m_out; }
+
+private:
+    u32 m_sources = 0;
+    output_line m_out;
+};
@@ -0,0 +1,202 @@
+#include "journal.h"
+#include <iostream>
+#include <cstring>
+
+static const char JOURNAL_MAGIC[8] = { 'E','6','5','0','2','J','N','L' };
+
+// ============================================================================
+//  Little-endian / varint helpers
+// ============================================================================
+static void put_u32(std::ofstream& out, u32 v) {
+    for (int i = 0; i < 4; i++) out.put((char)((v >> (i * 8)) & 0xFF));
+}
+static void put_u64(std::ofstream& out, u64 v) {
+    for (int i = 0; i < 8; i++) out.put((char)((v >> (i * 8)) & 0xFF));
+}
+static void put_varint(std::ofstream& out, u64 v) {
+    // LEB128: 7 bits per byte, high bit set means "more follows"
+    while (v >= 0x80) {
+        out.put((char)((v & 0x7F) | 0x80));
+        v >>= 7;
+    }
+    out.put((char)v);
+}
+
+static bool get_u32(const std::vector<u8>& buf, size_t& pos, u32& v) {
+    if (pos + 4 > buf.size()) return false;
+    v = 0;
+    for (int i = 0; i < 4; i++) v |= (u32)buf[pos++] << (i * 8);
+    return true;
+}
+static bool get_u64(const std::vector<u8>& buf, size_t& pos, u64& v) {
+    if (pos + 8 > buf.size()) return false;
+    v = 0;
+    for (int i = 0; i < 8; i++) v |= (u64)buf[pos++] << (i * 8);
+    return true;
+}
+static bool get_varint(const std::vector<u8>& buf, size_t& pos, u64& v) {
+    v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos >= buf.size()) return false;
+        u8 b = buf[pos++];
+        v |= (u64)(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+// ============================================================================
+//  CRC32 (IEEE, reflected)
+// ============================================================================
+u32 input_journal::crc32(const u8* data, size_t len) {
+    static u32 table[256];
+    static bool table_ready = false;
+    if (!table_ready) {
+        for (u32 i = 0; i < 256; i++) {
+            u32 c = i;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            table[i] = c;
+        }
+        table_ready = true;
+    }
+
+    u32 crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < len; i++) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// ============================================================================
+//  Recording
+// ============================================================================
+bool input_journal::start_recording(const std::string& path, u8 machine_type, u32 rom_crc, u64 start_cycle) {
+    stop();
+
+    m_out.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_out.is_open()) {
+        std::cerr << "[Journal] Error: Could not create " << path << std::endl;
+        return false;
+    }
+
+    m_out.write(JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+    m_out.put((char)VERSION);
+    m_out.put((char)machine_type);
+    put_u32(m_out, rom_crc);
+    put_u64(m_out, start_cycle);
+
+    m_path = path;
+    m_last_cycle = start_cycle;
+    m_recorded = 0;
+    m_mode = mode::RECORD;
+
+    std::cout << "[Journal] Recording inputs to " << path << std::endl;
+    return true;
+}
+
+void input_journal::record(u64 cycle, input_type type, u8 data, const u8* payload, u32 payload_len) {
+    if (m_mode != mode::RECORD) return;
+
+    // Cycles are monotonic, so the delta is small and usually fits in 1-3 bytes.
+    put_varint(m_out, cycle - m_last_cycle);
+    m_out.put((char)type);
+    m_out.put((char)data);
+    if (type == input_type::ROM_LOAD) {
+        put_u32(m_out, payload_len);
+        if (payload_len) m_out.write((const char*)payload, payload_len);
+    }
+
+    m_last_cycle = cycle;
+    m_recorded++;
+}
+
+// ============================================================================
+//  Replay
+// ============================================================================
+bool input_journal::start_replay(const std::string& path) {
+    stop();
+
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in.is_open()) {
+        std::cerr << "[Journal] Error: Could not open " << path << std::endl;
+        return false;
+    }
+
+    std::streamsize size = in.tellg();
+    in.seekg(0, std::ios::beg);
+    std::vector<u8> buf((size_t)size);
+    if (size > 0 && !in.read((char*)buf.data(), size)) {
+        std::cerr << "[Journal] Error: Could not read " << path << std::endl;
+        return false;
+    }
+
+    // --- Header ---
+    size_t pos = 0;
+    u64 cycle = 0;
+    if (buf.size() < sizeof(JOURNAL_MAGIC) + 2 ||
+        std::memcmp(buf.data(), JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0) {
+        std::cerr << "[Journal] Error: " << path << " is not an input journal." << std::endl;
+        return false;
+    }
+    pos += sizeof(JOURNAL_MAGIC);
+    if (buf[pos++] != VERSION) {
+        std::cerr << "[Journal] Error: Unsupported journal version." << std::endl;
+        return false;
+    }
+    m_machine_type = buf[pos++];
+    if (!get_u32(buf, pos, m_rom_crc) || !get_u64(buf, pos, cycle)) {
+        std::cerr << "[Journal] Error: Truncated header." << std::endl;
+        return false;
+    }
+
+    // --- Events ---
+    m_events.clear();
+    while (pos < buf.size()) {
+        input_event ev;
+        u64 delta = 0;
+        if (!get_varint(buf, pos, delta) || pos + 2 > buf.size()) {
+            std::cerr << "[Journal] Warning: Truncated event at byte " << pos << ", ignoring tail." << std::endl;
+            break;
+        }
+        cycle += delta;
+        ev.cycle = cycle;
+        ev.type  = (input_type)buf[pos++];
+        ev.data  = buf[pos++];
+
+        if (ev.type == input_type::ROM_LOAD) {
+            u32 len = 0;
+            if (!get_u32(buf, pos, len) || pos + len > buf.size()) {
+                std::cerr << "[Journal] Warning: Truncated ROM payload, ignoring tail." << std::endl;
+                break;
+            }
+            ev.payload.assign(buf.begin() + pos, buf.begin() + pos + len);
+            pos += len;
+        }
+        m_events.push_back(std::move(ev));
+    }
+
+    m_path = path;
+    m_cursor = 0;
+    m_mode = mode::REPLAY;
+
+    std::cout << "[Journal] Replaying " << m_events.size() << " inputs from " << path << std::endl;
+    return true;
+}
+
+void input_journal::pop() {
+    if (m_cursor < m_events.size()) m_cursor++;
+    if (m_mode == mode::REPLAY && m_cursor >= m_events.size()) {
+        std::cout << "[Journal] Replay complete (" << m_events.size() << " inputs)." << std::endl;
+        m_mode = mode::IDLE;
+    }
+}
+
+// ============================================================================
+//  Stop
+// ============================================================================
+void input_journal::stop() {
+    if (m_mode == mode::RECORD) {
+        m_out.flush();
+        m_out.close();
+        std::cout << "[Journal] Recorded " << m_recorded << " inputs to " << m_path << std::endl;
+    }
+    m_mode = mode::IDLE;
+}
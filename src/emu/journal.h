@@ -0,0 +1,116 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include "types.h"
+
+// ============================================================================
+//  Input Journal (Deterministic Record / Replay)
+// ============================================================================
+//  WHAT: A log of every external stimulus applied to the board, stamped with
+//        the emulated CPU cycle at which it happened.
+//  WHY:  The board is fully deterministic apart from these inputs. Recording
+//        them lets a field-reported session be replayed bit-for-bit (and far
+//        faster than real time) in the headless runner.
+//  HOW:  Events are appended to a compact binary file:
+//          Header : "E6502JNL" | version u8 | machine type u8 | ROM crc32 u32
+//                   | start cycle u64
+//          Events : varint(cycle delta) | type u8 | data u8 [| payload]
+//        Only ROM_LOAD carries a payload (the full 32K image), so a typical
+//        event costs 3-4 bytes.
+// ============================================================================
+
+enum class input_type : u8 {
+    SERIAL_RX    = 0,   // w65c51::rx_char
+    PORT_A       = 1,   // w65c22::set_port_a_input
+    PORT_B       = 2,   // w65c22::set_port_b_input
+    CA1          = 3,   // w65c22::set_ca1
+    CB1          = 4,   // w65c22::set_cb1
+    CB2          = 5,   // w65c22::set_cb2_input
+    PB6          = 6,   // w65c22::set_pb6_input
+    RESET        = 7,   // Board reset (RAM clear + VIA + CPU)
+    CPU_RESET    = 8,   // CPU-only reset (debugger button)
+    MACHINE_TYPE = 9,   // Schematic switch (data = MachineType)
+    ROM_LOAD     = 10,  // New firmware image (payload = 32K ROM)
+    SERIAL_TURBO = 11,  // ACIA line timing (data = 1 turbo, 0 baud-accurate)
+    PS2_BYTE     = 12,  // ps2_keyboard::queue (one scancode byte)
+};
+
+struct input_event {
+    u64 cycle = 0;              // CPU cycle the input was applied at
+    input_type type = input_type::RESET;
+    u8 data = 0;
+    std::vector<u8> payload;    // Only used by ROM_LOAD
+};
+
+class input_journal {
+public:
+    enum class mode { IDLE, RECORD, REPLAY };
+
+    static constexpr u8 VERSION = 1;
+
+    input_journal() = default;
+    ~input_journal() { stop(); }
+
+    // ========================================================================
+    //  Recording
+    // ========================================================================
+    // WHAT: Opens 'path' and writes the header.
+    // WHEN: At power-on (the journal assumes the board starts from reset).
+    bool start_recording(const std::string& path, u8 machine_type, u32 rom_crc, u64 start_cycle);
+
+    // WHAT: Appends one event. Cheap: a few bytes into a buffered stream.
+    void record(u64 cycle, input_type type, u8 data, const u8* payload = nullptr, u32 payload_len = 0);
+
+    // ========================================================================
+    //  Replay
+    // ========================================================================
+    // WHAT: Loads the whole journal into memory and validates the header.
+    bool start_replay(const std::string& path);
+
+    // WHAT: Cycle of the next pending event (or ~0 when exhausted).
+    // WHY:  The driver ends its execution slice exactly on this cycle.
+    u64 next_cycle() const {
+        return (m_cursor < m_events.size()) ? m_events[m_cursor].cycle : ~0ULL;
+    }
+    const input_event& peek() const { return m_events[m_cursor]; }
+    void pop();
+
+    // Last cycle present in the loaded journal (0 if empty)
+    u64 last_cycle() const { return m_events.empty() ? 0 : m_events.back().cycle; }
+
+    // Header information (valid after start_replay)
+    u8  machine_type() const { return m_machine_type; }
+    u32 rom_crc() const      { return m_rom_crc; }
+
+    // ========================================================================
+    //  Common
+    // ========================================================================
+    void stop();
+
+    mode get_mode() const        { return m_mode; }
+    bool is_recording() const    { return m_mode == mode::RECORD; }
+    bool is_replaying() const    { return m_mode == mode::REPLAY; }
+    size_t event_count() const   { return m_mode == mode::REPLAY ? m_events.size() : m_recorded; }
+    size_t events_done() const   { return m_cursor; }
+    const std::string& path() const { return m_path; }
+
+    // Helper: CRC32 used to tie a journal to the firmware it was recorded with
+    static u32 crc32(const u8* data, size_t len);
+
+private:
+    mode m_mode = mode::IDLE;
+    std::string m_path;
+
+    // Record state
+    std::ofstream m_out;
+    u64 m_last_cycle = 0;       // For delta encoding
+    size_t m_recorded = 0;
+
+    // Replay state
+    std::vector<input_event> m_events;
+    size_t m_cursor = 0;
+    u8  m_machine_type = 0;
+    u32 m_rom_crc = 0;
+};
@@ -0,0 +1,54 @@
+#include "map.h"
+#include "debug/heatmap.h"
+
+// ============================================================================
+//  Shared Pages (Search)
+// ============================================================================
+//  WHAT: Pages no single entry answers in full; the first entry (in
+//        install order) whose range holds the address and has a handler
+//        gets the access, as before the page table existed.
+// ============================================================================
+u8 address_map::search_read(u16 addr) {
+    for (int i = 0; i < m_count; i++) {
+        if (addr >= m_entries[i].m_start && addr <= m_entries[i].m_end && m_entries[i].m_read) {
+            return m_entries[i].m_read(addr);
+        }
+    }
+    // Fallback: If no device responds (Open Bus), return 0.
+    return 0x00;
+}
+
+void address_map::search_write(u16 addr, u8 data) {
+    for (int i = 0; i < m_count; i++) {
+        if (addr >= m_entries[i].m_start && addr <= m_entries[i].m_end && m_entries[i].m_write) {
+            m_entries[i].m_write(addr, data);
+            return;
+        }
+    }
+}
+
+// ============================================================================
+//  Watched Pages (Trampoline)
+// ============================================================================
+//  WHAT: Only reached for pages with a watchpoint or while the heatmap is
+//        attached. Reads are reported with the value read; writes are
+//        reported before they land.
+// ============================================================================
+u8 address_map::observed_read(u16 addr) {
+    const u8 data = m_page_owner[addr >> 8]->m_read(addr);
+    observe(addr, data, m_watch_page[addr >> 8], false);
+    return data;
+}
+
+void address_map::observed_write(u16 addr, u8 data) {
+    observe(addr, data, m_watch_page[addr >> 8], true);
+    m_page_owner[addr >> 8]->m_write(addr, data);
+}
+
+void address_map::observe(u16 addr, u8 data, u8 flags, bool write) {
+    if ((flags & (write ? WATCH_WRITE : WATCH_READ)) && m_watch) m_watch(addr, data, write);
+    if (m_heat) {
+        if (write) m_heat->count_write(addr);
+        else       m_heat->count_read(addr);
+    }
+}
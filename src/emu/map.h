@@ -1,9 +1,12 @@
 #pragma once
 
+#include <cstring>
 #include <functional>
 #include <iostream>
 #include "types.h"
 
+class debug_heatmap;    // emu/debug/heatmap.h (only map.cpp needs it)
+
 // ============================================================================
 //  Delegate Definitions
 // ============================================================================
@@ -20,6 +23,9 @@ using read8_delegate  = std::function<u8(u16)>;
 // A function that accepts an Address (u16) and a Byte (u8) and returns void
 using write8_delegate = std::function<void(u16, u8)>;
 
+// A debugger hook: Address, Data, and whether the access was a write
+using watch8_delegate = std::function<void(u16, u8, bool)>;
+
 // ============================================================================
 //  struct map_entry
 // ============================================================================
@@ -70,7 +76,28 @@ public:
     // WHEN: When the CPU is created.
     // WHY:  Initializes the counter to zero so we know the list is empty.
     // HOW:  Simple assignment.
-    address_map() : m_count(0) {}
+    address_map() : m_count(0) {
+        // Page handlers that aren't a device (see m_page_entry)
+        m_open_bus.m_read    = [](u16) -> u8 { return 0x00; };
+        m_open_bus.m_write   = [](u16, u8) {};
+        m_search.m_read      = [this](u16 addr) { return search_read(addr); };
+        m_search.m_write     = [this](u16 addr, u8 data) { search_write(addr, data); };
+        m_trampoline.m_read  = [this](u16 addr) { return observed_read(addr); };
+        m_trampoline.m_write = [this](u16 addr, u8 data) { observed_write(addr, data); };
+
+        for (int i = 0; i < 256; i++) m_watch_page[i] = 0;
+        for (int i = 0; i < 256; i++) m_direct_page[i] = nullptr;
+        for (int i = 0; i < 256; i++) m_page_owner[i] = m_page_entry[i] = &m_open_bus;
+    }
+
+    // The special entries capture 'this': a map stays where it was built.
+    address_map(const address_map&) = delete;
+    address_map& operator=(const address_map&) = delete;
+
+    // Watchpoint page flags
+    static constexpr u8 WATCH_READ  = 0x01;
+    static constexpr u8 WATCH_WRITE = 0x02;
+    static constexpr u8 WATCH_HEAT  = 0x04;     // Count accesses (heatmap)
 
     // ========================================================================
     //  Installation (Building the Board)
@@ -102,6 +129,9 @@ public:
         // This is correct for 99% of cases (RAM, ROM).
         entry.m_read_debug = r;
 
+        // Resolve the pages this entry answers for (see m_page_entry)
+        resolve_pages(m_count);
+
         // Increment the counter so the next install goes to the next slot
         m_count++;
     }
@@ -121,6 +151,22 @@ public:
                   << std::hex << start << std::endl;
     }
 
+    // WHAT: Declares that [start, end] is plain memory backed by 'base'
+    //       (base[0] holds 'start'). Both ends must be page aligned.
+    // WHEN: After install(), for RAM and ROM.
+    // WHY:  Lets read_range_debug() copy those pages with memcpy instead
+    //       of one delegate call per byte.
+    void install_debug_direct(u16 start, u16 end, const u8* base) {
+        if ((start & 0xFF) != 0 || (end & 0xFF) != 0xFF) {
+            std::cerr << "Warning: Direct debug range must be page aligned: "
+                      << std::hex << start << "-" << end << std::endl;
+            return;
+        }
+        for (int page = start >> 8; page <= (end >> 8); page++) {
+            m_direct_page[page] = base + ((page << 8) - start);
+        }
+    }
+
     // ========================================================================
     //  Access (Running the Emulation)
     // ========================================================================
@@ -128,22 +174,11 @@ public:
     // WHAT: The Read Lookup.
     // WHEN: Called by the CPU (every instruction cycle).
     // WHY:  Resolves a 16-bit address to a specific byte of data.
-    // HOW:  Iterates through the fixed array up to 'm_count'.
+    // HOW:  One indexed call through the page table. Open pages, pages
+    //       shared by several entries and watched pages point at special
+    //       entries, so nothing here tests for them.
     u8 read(u16 addr) {
-        // Loop through all installed devices
-        for (int i = 0; i < m_count; i++) {
-            // Check if address falls inside this entry's range
-            if (addr >= m_entries[i].m_start && addr <= m_entries[i].m_end) {
-                
-                // If a read function was provided, call it!
-                if (m_entries[i].m_read) {
-                    return m_entries[i].m_read(addr);
-                }
-            }
-        }
-        // Fallback: If no device responds (Open Bus), return 0.
-        // In real hardware, this might be floating voltage, but 0 is safe.
-        return 0x00; 
+        return m_page_entry[addr >> 8]->m_read(addr);
     }
 
     u8 read_debug(u16 addr) {
@@ -158,24 +193,102 @@ public:
         return 0x00; 
     }
 
+    // WHAT: Side-effect free copy of 'len' bytes starting at 'start'
+    //       (wraps at $FFFF, so len may be the full 0x10000).
+    // WHEN: Debugger views, once per frame.
+    // WHY:  A 64K dump is a few memcpys for RAM/ROM; only I/O pages go
+    //       through the per-byte debug delegate.
+    void read_range_debug(u16 start, u32 len, u8* out) {
+        u16 addr = start;
+        while (len > 0) {
+            u32 chunk = 256 - (addr & 0xFF);        // To the end of this page
+            if (chunk > len) chunk = len;
+
+            const u8* direct = m_direct_page[addr >> 8];
+            if (direct) {
+                std::memcpy(out, direct + (addr & 0xFF), chunk);
+            } else {
+                for (u32 i = 0; i < chunk; i++) out[i] = read_debug((u16)(addr + i));
+            }
+            out  += chunk;
+            addr  = (u16)(addr + chunk);
+            len  -= chunk;
+        }
+    }
+
     // WHAT: The Write Lookup.
     // WHEN: Called by the CPU (e.g., STA $6000).
     // WHY:  Delivers data to the correct chip.
-    // HOW:  Iterates through the fixed array.
+    // HOW:  Same page table as read().
     void write(u16 addr, u8 data) {
-        for (int i = 0; i < m_count; i++) {
-            if (addr >= m_entries[i].m_start && addr <= m_entries[i].m_end) {
-                
-                // If a write function was provided, call it!
-                if (m_entries[i].m_write) {
-                    m_entries[i].m_write(addr, data);
-                    return; // We found the target, no need to keep searching.
-                }
-            }
+        m_page_entry[addr >> 8]->m_write(addr, data);
+    }
+
+    // ========================================================================
+    //  Watchpoints (Debugger)
+    // ========================================================================
+    // WHAT: Per-page flags that route accesses to the debugger.
+    // WHEN: Set by device_debug when watchpoints are added or removed.
+    // WHY:  A flagged page's table slot is swapped for the trampoline
+    //       entry, which reports the access and then calls the device;
+    //       unwatched pages keep their direct entry and test nothing.
+    //       read_debug() never triggers them (the UI must not break itself).
+    void set_watch_page(u8 page, u8 flags) {
+        m_watch_page[page] |= flags;
+        refresh_page(page);
+    }
+    void set_watch_handler(watch8_delegate handler) { m_watch = std::move(handler); }
+    void clear_watch() {
+        for (int i = 0; i < 256; i++) {
+            m_watch_page[i] &= ~(WATCH_READ | WATCH_WRITE);
+            refresh_page(i);
+        }
+    }
+    bool has_watch() const {
+        for (int i = 0; i < 256; i++) if (m_watch_page[i] & (WATCH_READ | WATCH_WRITE)) return true;
+        return false;
+    }
+
+    // WHAT: Routes every access into 'heat' (nullptr detaches).
+    // HOW:  Sets WATCH_HEAT on all pages, so every page goes through the
+    //       trampoline like a watched one; detached, it costs nothing.
+    void set_heatmap(debug_heatmap* heat) {
+        m_heat = heat;
+        for (int i = 0; i < 256; i++) {
+            if (heat) m_watch_page[i] |= WATCH_HEAT;
+            else      m_watch_page[i] &= ~WATCH_HEAT;
+            refresh_page(i);
         }
     }
 
 private:
+    // WHAT: Folds entry 'idx' into the page table.
+    // HOW:  The first entry to cover a whole page owns it, as the search
+    //       would find it first. A page an entry covers only in part, or
+    //       one with a missing handler, falls back to the search.
+    void resolve_pages(int idx) {
+        map_entry& e = m_entries[idx];
+        for (int page = e.m_start >> 8; page <= (e.m_end >> 8); page++) {
+            map_entry*& owner = m_page_owner[page];
+            if (owner != &m_open_bus && owner != &m_search) continue;     // Already answered in full
+            const bool whole = e.m_start <= (page << 8) && e.m_end >= ((page << 8) | 0xFF);
+            owner = (whole && owner == &m_open_bus && e.m_read && e.m_write) ? &e : &m_search;
+            refresh_page(page);
+        }
+    }
+
+    // WHAT: Points a page at its owner, or at the trampoline while flagged.
+    void refresh_page(int page) {
+        m_page_entry[page] = m_watch_page[page] ? &m_trampoline : m_page_owner[page];
+    }
+
+    // Special entries' handlers (map.cpp)
+    u8   search_read(u16 addr);
+    void search_write(u16 addr, u8 data);
+    u8   observed_read(u16 addr);
+    void observed_write(u16 addr, u8 data);
+    void observe(u16 addr, u8 data, u8 flags, bool write);
+
     // ========================================================================
     //  Internal Storage
     // ========================================================================
@@ -191,4 +304,28 @@ private:
     // WHY:  Since the array is fixed size (64), we need to know how many 
     //       slots are actually being used (e.g., 4).
     int m_count;
+
+    // WHAT: The entry that answers each 256-byte page: a device, open bus,
+    //       or the search (page shared by several entries).
+    // WHEN: Built by install().
+    // WHY:  Decode is resolved once, so an access never walks the list.
+    map_entry* m_page_owner[256];
+
+    // WHAT: What an access calls: the owner, or the trampoline while the
+    //       page is watched or heat-tracked.
+    map_entry* m_page_entry[256];
+
+    // WHAT: The entries a page can point at besides a device's.
+    map_entry m_open_bus;       // Nothing mapped: reads 0, writes vanish
+    map_entry m_search;         // Walks m_entries in install order
+    map_entry m_trampoline;     // observe(), then the page's owner
+
+    // WHAT: Watchpoint flags (one byte per 256-byte page) and the hook.
+    u8 m_watch_page[256];
+    watch8_delegate m_watch;
+    debug_heatmap* m_heat = nullptr;
+
+    // WHAT: Backing storage of each page for debug reads (nullptr = I/O,
+    //       use the debug delegate).
+    const u8* m_direct_page[256];
 };
\ No newline at end of file
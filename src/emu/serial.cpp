@@ -0,0 +1,464 @@
+#include "serial.h"
+
+#include <asio.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/uio.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+using asio::generic::stream_protocol;
+
+static constexpr int STOP_DRAIN_MS = 1000;  // stop(): time left for queued TX
+
+// ============================================================================
+//  Host Side State
+// ============================================================================
+struct serial_bridge::impl {
+    spsc_fifo<u8>& rx;
+    spsc_fifo<u8>& tx;
+    impl(spsc_fifo<u8>& r, spsc_fifo<u8>& t) : rx(r), tx(t) {}
+
+    std::thread thread;
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> wake_pending{false};
+    std::atomic<bool> host_eof{false};      // No more input from the host
+    std::atomic<bool> out_failed{false};    // Host stopped accepting output
+
+    // --- Unix socket ("unix:PATH"): asio, everything on the helper thread ---
+    bool use_socket = false;
+    asio::io_context io;
+    // Keeps run() going while nothing is outstanding (client idle after EOF,
+    // rings empty/full); sock_stop() ends it with io.stop().
+    asio::executor_work_guard<asio::io_context::executor_type> keep_alive{io.get_executor()};
+    asio::basic_socket_acceptor<stream_protocol> acceptor{io};
+    stream_protocol::socket socket{io};
+    asio::steady_timer drain_timer{io};
+    std::string unix_path;              // Removed again on stop()
+    bool connected = false;
+    bool reading = false;
+    bool writing = false;
+
+    void sock_accept();
+    void sock_read();
+    void sock_write();
+    void sock_drop();
+    void sock_stop();
+
+#ifndef _WIN32
+    int fd_in  = -1;                    // Host -> board
+    int fd_out = -1;                    // Board -> host (same fd for a pty)
+    int pty_slave = -1;                 // Held open so the master never sees a hangup
+    int wake[2] = { -1, -1 };           // Self-pipe: notify() / stop()
+    bool owns_fds = false;              // pty: close on stop; stdio: leave alone
+
+    bool restore_tty = false;           // stdio on a terminal: undo raw mode
+    struct termios saved_tty {};
+#endif
+};
+
+serial_bridge::serial_bridge(size_t depth)
+    : m_rx(depth), m_tx(depth) {
+    m_impl = std::make_unique<impl>(m_rx, m_tx);
+}
+
+serial_bridge::~serial_bridge() { stop(); }
+
+bool serial_bridge::closed() const {
+    const impl& s = *m_impl;
+    return (s.host_eof.load(std::memory_order_acquire) && m_tx.empty()) ||
+           s.out_failed.load(std::memory_order_acquire);
+}
+
+// ============================================================================
+//  Start / Stop
+// ============================================================================
+bool serial_bridge::start(const std::string& spec) {
+    stop();
+    impl& s = *m_impl;
+    s.stopping = false;
+    s.host_eof = false;
+    s.out_failed = false;
+    s.use_socket = (spec.compare(0, 5, "unix:") == 0);
+
+    if (s.use_socket) {
+        if (!start_socket(spec.substr(5))) return false;
+    } else {
+#ifdef _WIN32
+        std::cerr << "[Serial] Error: '" << spec << "' needs a POSIX host (try unix:PATH)." << std::endl;
+        return false;
+#else
+        if (!start_fd(spec)) return false;
+#endif
+    }
+
+    s.thread = std::thread([this] { thread_main(); });
+    std::cerr << "[Serial] Connected to " << m_name << std::endl;
+    return true;
+}
+
+void serial_bridge::stop() {
+    impl& s = *m_impl;
+    if (s.thread.joinable()) {
+        if (s.use_socket) {
+            asio::post(s.io, [&s] { s.sock_stop(); });
+        } else {
+            s.stopping = true;
+            notify();
+        }
+        s.thread.join();
+    }
+
+    asio::error_code ignore;
+    s.socket.close(ignore);
+    s.acceptor.close(ignore);
+    if (!s.unix_path.empty()) std::remove(s.unix_path.c_str());
+    s.unix_path.clear();
+    s.connected = s.reading = s.writing = false;
+
+#ifndef _WIN32
+    if (s.owns_fds && s.fd_in >= 0) close(s.fd_in);
+    if (s.pty_slave >= 0) close(s.pty_slave);
+    if (s.restore_tty) tcsetattr(STDIN_FILENO, TCSANOW, &s.saved_tty);
+    for (int& fd : s.wake) {
+        if (fd >= 0) close(fd);
+        fd = -1;
+    }
+    s.fd_in = s.fd_out = s.pty_slave = -1;
+    s.owns_fds = false;
+    s.restore_tty = false;
+#endif
+}
+
+void serial_bridge::notify() {
+    impl& s = *m_impl;
+    if (s.use_socket) {
+        if (s.wake_pending.exchange(true, std::memory_order_acq_rel)) return;
+        asio::post(s.io, [&s] {
+            s.wake_pending.store(false, std::memory_order_release);
+            s.sock_write();
+            s.sock_read();
+        });
+        return;
+    }
+#ifndef _WIN32
+    if (s.wake[1] < 0 || s.wake_pending.exchange(true, std::memory_order_acq_rel)) return;
+    const char c = 1;
+    ssize_t r = write(s.wake[1], &c, 1);
+    (void)r;
+#endif
+}
+
+void serial_bridge::thread_main() {
+    impl& s = *m_impl;
+    if (s.use_socket) {
+        s.io.run();
+        return;
+    }
+#ifndef _WIN32
+    fd_loop();
+#endif
+}
+
+// ============================================================================
+//  Unix Socket
+// ============================================================================
+//  WHAT: One client at a time; the next one is accepted when it leaves.
+//  HOW:  Reads land directly in the RX ring's free spans and writes go out
+//        straight from the TX ring's filled spans (scatter/gather buffer
+//        sequences, no staging copy). A full RX ring simply leaves no read
+//        outstanding; the driver's notify() after it pops restarts it.
+//        TX waits in the ring while no client is connected.
+//        A client that shuts down its sending side (EOF) ends the input, so
+//        the headless runner can finish, while its replies still go out.
+// ============================================================================
+bool serial_bridge::start_socket(const std::string& path) {
+#if defined(ASIO_HAS_LOCAL_SOCKETS)
+    impl& s = *m_impl;
+    asio::error_code ec;
+    std::remove(path.c_str());          // Stale socket from a previous run
+    stream_protocol::endpoint ep = asio::local::stream_protocol::endpoint(path);
+
+    s.io.restart();
+    s.acceptor.open(ep.protocol(), ec);
+    if (!ec) s.acceptor.bind(ep, ec);
+    if (!ec) s.acceptor.listen(1, ec);
+    if (ec) {
+        std::cerr << "[Serial] Error: Could not listen on " << path << ": " << ec.message() << std::endl;
+        asio::error_code ignore;
+        s.acceptor.close(ignore);
+        return false;
+    }
+    s.unix_path = path;
+    m_name = path;
+    s.sock_accept();
+    return true;
+#else
+    std::cerr << "[Serial] Error: Unix sockets are not available here (" << path << ")." << std::endl;
+    return false;
+#endif
+}
+
+void serial_bridge::impl::sock_accept() {
+    acceptor.async_accept(socket, [this](const asio::error_code& ec) {
+        if (ec) return;     // Acceptor closed
+        std::cerr << "[Serial] Client connected." << std::endl;
+        connected = true;
+        host_eof = false;
+        out_failed = false;
+        sock_read();
+        sock_write();
+    });
+}
+
+void serial_bridge::impl::sock_read() {
+    if (!connected || reading || host_eof || stopping) return;
+
+    spsc_fifo<u8>::span spans[2];
+    int n = rx.write_spans(spans);
+    if (n == 0) return;                 // Ring full: notify() restarts us
+    std::array<asio::mutable_buffer, 2> bufs = {
+        asio::buffer(spans[0].data, spans[0].size),
+        n > 1 ? asio::buffer(spans[1].data, spans[1].size) : asio::mutable_buffer()
+    };
+
+    reading = true;
+    socket.async_read_some(bufs, [this](const asio::error_code& ec, size_t got) {
+        reading = false;
+        if (got) rx.commit_write(got);
+        if (ec == asio::error::eof) {
+            host_eof = true;            // Client is done sending; keep answering
+            return;
+        }
+        if (ec) {
+            if (ec != asio::error::operation_aborted) sock_drop();
+            return;
+        }
+        sock_read();
+    });
+}
+
+void serial_bridge::impl::sock_write() {
+    if (!connected || writing) return;
+
+    spsc_fifo<u8>::span spans[2];
+    int n = tx.read_spans(spans);
+    if (n == 0) {
+        if (stopping) io.stop();        // Drained
+        return;
+    }
+    std::array<asio::const_buffer, 2> bufs = {
+        asio::buffer((const u8*)spans[0].data, spans[0].size),
+        n > 1 ? asio::buffer((const u8*)spans[1].data, spans[1].size) : asio::const_buffer()
+    };
+
+    writing = true;
+    socket.async_write_some(bufs, [this](const asio::error_code& ec, size_t put) {
+        writing = false;
+        if (put) tx.commit_read(put);
+        if (ec) {
+            if (ec != asio::error::operation_aborted) sock_drop();
+            return;
+        }
+        sock_write();
+    });
+}
+
+void serial_bridge::impl::sock_drop() {
+    if (!connected) return;
+    asio::error_code ignore;
+    socket.close(ignore);
+    connected = false;
+    host_eof = true;                    // Input over, and nobody to take output
+    out_failed = true;
+    std::cerr << "[Serial] Client disconnected." << std::endl;
+    if (stopping) io.stop();
+    else sock_accept();
+}
+
+void serial_bridge::impl::sock_stop() {
+    stopping = true;
+    asio::error_code ignore;
+    acceptor.close(ignore);
+    if (!connected || tx.empty()) {
+        io.stop();
+        return;
+    }
+    // Let queued TX go out first (sock_write stops the loop when drained)
+    sock_write();
+    drain_timer.expires_after(std::chrono::milliseconds(STOP_DRAIN_MS));
+    drain_timer.async_wait([this](const asio::error_code& ec) {
+        if (!ec) io.stop();
+    });
+}
+
+#ifndef _WIN32
+// ============================================================================
+//  Pseudo-Terminal / stdio
+// ============================================================================
+static bool open_pty(int& master, int& slave, std::string& name) {
+    master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) return false;
+    const char* path = ptsname(master);
+    if (!path) return false;
+    name = path;
+
+    slave = open(path, O_RDWR | O_NOCTTY);
+    if (slave < 0) return false;
+
+    // Raw: no echo, no line editing, no CR/LF translation. The firmware
+    // (WozMon, BASIC) does its own echo and expects CR.
+    struct termios tio;
+    if (tcgetattr(slave, &tio) == 0) {
+        cfmakeraw(&tio);
+        tcsetattr(slave, TCSANOW, &tio);
+    }
+    fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+    return true;
+}
+
+bool serial_bridge::start_fd(const std::string& spec) {
+    impl& s = *m_impl;
+
+    if (spec == "pty") {
+        int master = -1;
+        if (!open_pty(master, s.pty_slave, m_name)) {
+            std::cerr << "[Serial] Error: Could not create a pseudo-terminal." << std::endl;
+            if (master >= 0) close(master);
+            if (s.pty_slave >= 0) close(s.pty_slave);
+            s.pty_slave = -1;
+            return false;
+        }
+        s.fd_in = s.fd_out = master;
+        s.owns_fds = true;
+    }
+    else if (spec == "stdio") {
+        // stdin/stdout stay blocking (the rest of the process logs to them);
+        // the thread only touches them when poll() says they are ready.
+        s.fd_in = STDIN_FILENO;
+        s.fd_out = STDOUT_FILENO;
+        s.owns_fds = false;
+        m_name = "stdio";
+
+        // A reader that goes away should end the bridge, not the process
+        std::signal(SIGPIPE, SIG_IGN);
+
+        // A terminal sends each key as typed; keep ISIG so Ctrl-C still works
+        if (isatty(STDIN_FILENO) && tcgetattr(STDIN_FILENO, &s.saved_tty) == 0) {
+            struct termios tio = s.saved_tty;
+            tio.c_lflag &= ~(ICANON | ECHO);
+            tio.c_iflag &= ~(ICRNL | INLCR);
+            tio.c_cc[VMIN] = 1;
+            tio.c_cc[VTIME] = 0;
+            tcsetattr(STDIN_FILENO, TCSANOW, &tio);
+            s.restore_tty = true;
+        }
+    }
+    else {
+        std::cerr << "[Serial] Error: Unknown endpoint '" << spec << "' (expected pty, stdio or unix:PATH)." << std::endl;
+        return false;
+    }
+
+    if (pipe(s.wake) != 0) {
+        std::cerr << "[Serial] Error: Could not create the wake pipe." << std::endl;
+        stop();
+        return false;
+    }
+    fcntl(s.wake[0], F_SETFL, O_NONBLOCK);
+    fcntl(s.wake[1], F_SETFL, O_NONBLOCK);
+    return true;
+}
+
+// ============================================================================
+//  Host Thread (pty / stdio)
+// ============================================================================
+//  WHAT: Moves bytes between the host fd(s) and the rings until stop().
+//  HOW:  Only asks for POLLIN while the RX ring has room and POLLOUT while
+//        the TX ring has data; otherwise sleeps on the wake pipe. A full RX
+//        ring is re-checked every millisecond (the emulation thread drains
+//        it without waking us). On stop() whatever is still queued for the
+//        host gets up to STOP_DRAIN_MS to go out.
+// ============================================================================
+void serial_bridge::fd_loop() {
+    impl& s = *m_impl;
+    bool in_open = true;
+    int drain_ms = 0;
+    spsc_fifo<u8>::span spans[2];
+    struct iovec iov[2];
+
+    while (true) {
+        const bool stopping = s.stopping.load(std::memory_order_acquire);
+        if (stopping && (m_tx.empty() || s.out_failed.load() || drain_ms >= STOP_DRAIN_MS)) break;
+
+        const bool want_in  = !stopping && in_open && m_rx.space() > 0;
+        const bool want_out = !m_tx.empty();
+
+        struct pollfd fds[3];
+        int nfds = 0;
+        fds[nfds++] = { s.wake[0], POLLIN, 0 };
+        int in_idx = -1, out_idx = -1;
+        if (s.fd_in == s.fd_out) {
+            short ev = (short)((want_in ? POLLIN : 0) | (want_out ? POLLOUT : 0));
+            if (ev) { in_idx = out_idx = nfds; fds[nfds++] = { s.fd_in, ev, 0 }; }
+        } else {
+            if (want_in)  { in_idx = nfds;  fds[nfds++] = { s.fd_in,  POLLIN,  0 }; }
+            if (want_out) { out_idx = nfds; fds[nfds++] = { s.fd_out, POLLOUT, 0 }; }
+        }
+
+        int timeout = -1;
+        if (stopping) { timeout = 10; drain_ms += 10; }
+        else if (in_open && !want_in) timeout = 1;
+        if (poll(fds, (nfds_t)nfds, timeout) < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "[Serial] Error: poll failed (" << errno << ")." << std::endl;
+            break;
+        }
+
+        // Clear the flag before draining, so a notify() racing with us
+        // leaves a byte in the pipe rather than getting lost
+        if (fds[0].revents) {
+            s.wake_pending.store(false, std::memory_order_release);
+            char drain[64];
+            while (read(s.wake[0], drain, sizeof(drain)) > 0) {}
+        }
+
+        // Host -> board: read straight into the free part of the ring
+        if (want_in && (fds[in_idx].revents & (POLLIN | POLLHUP | POLLERR))) {
+            int n = m_rx.write_spans(spans);
+            for (int i = 0; i < n; i++) iov[i] = { spans[i].data, spans[i].size };
+            ssize_t got = readv(s.fd_in, iov, n);
+            if (got > 0) {
+                m_rx.commit_write((size_t)got);
+            } else if (got == 0 || (errno != EAGAIN && errno != EINTR)) {
+                in_open = false;            // EOF (stdin) or the host end went away
+                s.host_eof.store(true, std::memory_order_release);
+            }
+        }
+
+        // Board -> host: write whatever is queued, in one call
+        if (want_out && (fds[out_idx].revents & POLLOUT)) {
+            int n = m_tx.read_spans(spans);
+            for (int i = 0; i < n; i++) iov[i] = { spans[i].data, spans[i].size };
+            ssize_t put = writev(s.fd_out, iov, n);
+            if (put > 0) m_tx.commit_read((size_t)put);
+            else if (put < 0 && errno != EAGAIN && errno != EINTR) {
+                // Nobody to deliver to: discard so the board is not stalled forever
+                s.out_failed.store(true, std::memory_order_release);
+                m_tx.commit_read(m_tx.size());
+            }
+        }
+    }
+}
+#endif
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include "spsc.h"
+#include "types.h"
+
+// ============================================================================
+//  serial_bridge (ACIA <-> Host)
+// ============================================================================
+//  WHAT: Connects the board's serial port to something on the host: a
+//        pseudo-terminal ("pty", for screen/minicom), the process's own
+//        stdin/stdout ("stdio", for pipes and scripts) or a Unix-domain
+//        socket ("unix:PATH", for test harnesses and other programs).
+//  WHO:  main() creates and starts it for --serial and hands it to the
+//        driver (mb_driver::attach_serial). The driver moves bytes between
+//        the ACIA and the FIFOs at its sync points.
+//  WHY:  The emulation thread must never block on the host. All host I/O
+//        happens on a helper thread; the only thing shared is a pair of
+//        lock-free FIFOs.
+//  HOW:  Host thread: poll()s the host fd and a wake pipe, then reads as
+//        much as fits straight into the RX ring (readv on its free spans)
+//        and writes whatever the TX ring holds (writev). A socket runs the
+//        same scheme on an asio io_context instead (buffer sequences over
+//        the spans). When the RX ring is full it stops reading, so the host
+//        sees ordinary flow control.
+//        Board side: pops one byte into the ACIA whenever its receive
+//        register is empty, and only completes a transmit when the TX ring
+//        has room (TX-empty stays clear until then).
+//
+//  Specs:  "pty"        New /dev/pts/N in raw mode (name printed at start)
+//          "stdio"      stdin -> RX, TX -> stdout
+//          "unix:PATH"  Listens on PATH, one client at a time
+//  Depth:  Ring size in bytes (--serial-depth), rounded up to a power of two.
+// ============================================================================
+class serial_bridge {
+public:
+    static constexpr size_t DEFAULT_DEPTH = 4096;
+
+    explicit serial_bridge(size_t depth = DEFAULT_DEPTH);
+    ~serial_bridge();
+
+    // WHAT: Opens the host side and starts the helper thread. Returns false
+    //       (with a console message) if it can't.
+    bool start(const std::string& spec);
+    void stop();
+
+    // WHAT: Host -> board and board -> host rings.
+    //       rx(): produced by the host thread, consumed by the emulation thread.
+    //       tx(): produced by the emulation thread, consumed by the host thread.
+    spsc_fifo<u8>& rx() { return m_rx; }
+    spsc_fifo<u8>& tx() { return m_tx; }
+
+    // WHAT: Wakes the host thread (TX bytes queued, or RX space freed).
+    // HOW:  At most one wake-up byte is in flight, so calling this for every
+    //       byte costs an atomic exchange, not a system call.
+    void notify();
+
+    // WHAT: The host end is gone: EOF on its input with everything queued
+    //       for it written, or it stopped accepting output.
+    bool closed() const;
+
+    // WHAT: What to connect to, e.g. "/dev/pts/3", "stdio" or a socket path.
+    const std::string& name() const { return m_name; }
+
+private:
+    struct impl;
+    std::unique_ptr<impl> m_impl;
+
+    spsc_fifo<u8> m_rx;
+    spsc_fifo<u8> m_tx;
+    std::string m_name;
+
+    bool start_socket(const std::string& path);
+    bool start_fd(const std::string& spec);
+    void thread_main();
+    void fd_loop();
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+#include "types.h"
+
+// ============================================================================
+//  Signals (Output Pins & Ports)
+// ============================================================================
+//  WHAT: The wires between chips. A device owns its output lines / ports and
+//        drives them; the board connects listeners (other devices' inputs).
+//  WHO:  Devices call set() whenever they recompute an output. The driver
+//        connects listeners in its wiring code (mb_driver::configure_machine).
+//  WHY:  A device may recompute its pins far more often than they change
+//        (every register write). Listeners only run on a real level change
+//        and are told which edge it was, so nobody has to keep a
+//        "last state" copy to find edges.
+//  HOW:  Plain vectors of std::function; the level compare is the only
+//        cost when nothing changes.
+// ============================================================================
+enum class signal_edge : u8 { FALLING, RISING };
+
+// ============================================================================
+//  output_line (one pin)
+// ============================================================================
+class output_line {
+public:
+    using listener = std::function<void(signal_edge)>;
+
+    void connect(listener fn) { m_listeners.push_back(std::move(fn)); }
+    void disconnect_all()     { m_listeners.clear(); }
+
+    bool state() const { return m_state; }
+
+    // WHAT: Drives the pin. Listeners run only if the level changed.
+    void set(bool state) {
+        if (state == m_state) return;
+        m_state = state;
+        const signal_edge edge = state ? signal_edge::RISING : signal_edge::FALLING;
+        for (auto& fn : m_listeners) fn(edge);
+    }
+
+private:
+    bool m_state = false;
+    std::vector<listener> m_listeners;
+};
+
+// ============================================================================
+//  output_port (8 pins)
+// ============================================================================
+class output_port {
+public:
+    using listener     = std::function<void(u8 value, u8 changed)>;
+    using bit_listener = std::function<void(signal_edge)>;
+
+    // WHAT: Whole-port listener: new value plus the mask of pins that moved.
+    void connect(listener fn) { m_listeners.push_back(std::move(fn)); }
+
+    // WHAT: Single-pin listener (e.g. a strobe). Runs after the whole-port
+    //       listeners, so value() already shows the other pins' new levels.
+    void connect_bit(int bit, bit_listener fn) { m_bit_listeners.push_back({ (u8)(1u << bit), std::move(fn) }); }
+
+    void disconnect_all() {
+        m_listeners.clear();
+        m_bit_listeners.clear();
+    }
+
+    u8 value() const { return m_value; }
+
+    // WHAT: Drives the pins. Listeners run only for pins that changed.
+    void set(u8 value) {
+        const u8 changed = value ^ m_value;
+        if (!changed) return;
+        m_value = value;
+        for (auto& fn : m_listeners) fn(value, changed);
+        for (auto& b : m_bit_listeners) {
+            if (changed & b.mask) b.fn((value & b.mask) ? signal_edge::RISING : signal_edge::FALLING);
+        }
+    }
+
+private:
+    struct bit_entry {
+        u8 mask;
+        bit_listener fn;
+    };
+    u8 m_value = 0;
+    std::vector<listener> m_listeners;
+    std::vector<bit_entry> m_bit_listeners;
+};
@@ -0,0 +1,200 @@
+#include "snapshot.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SNAPSHOT_SSE2 1
+#endif
+
+static const char SNAPSHOT_MAGIC[8] = { 'E','6','5','0','2','S','N','P' };
+
+// ============================================================================
+//  Blocks
+// ============================================================================
+static const machine_snapshot::block s_blocks[] = {
+    { "CPU",  0x0000, machine_snapshot::CPU_REGS },
+    { "RAM",  0x0000, 0x8000 },
+    { "ROM",  0x8000, 0x8000 },
+    { "VIA",  0x6000, 16 },
+    { "ACIA", 0x5000, 4 },
+};
+
+const machine_snapshot::block* machine_snapshot::blocks(int& count) {
+    count = (int)(sizeof(s_blocks) / sizeof(s_blocks[0]));
+    return s_blocks;
+}
+
+const u8* machine_snapshot::block_data(int index) const {
+    switch (index) {
+        case 0: return cpu;
+        case 1: return ram;
+        case 2: return rom;
+        case 3: return via;
+        case 4: return acia;
+    }
+    return nullptr;
+}
+
+// ============================================================================
+//  File I/O
+// ============================================================================
+bool machine_snapshot::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) {
+        std::cerr << "[Snapshot] Error: Could not create " << path << std::endl;
+        return false;
+    }
+    out.write(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    out.put((char)VERSION);
+    for (int i = 0; i < 8; i++) out.put((char)((cycle >> (i * 8)) & 0xFF));
+    out.put((char)machine_type);
+
+    int count = 0;
+    const block* b = blocks(count);
+    for (int i = 0; i < count; i++) out.write((const char*)block_data(i), b[i].size);
+
+    if (!out) {
+        std::cerr << "[Snapshot] Error: Write failed for " << path << std::endl;
+        return false;
+    }
+    std::cout << "[Snapshot] Saved " << path << " (cycle " << cycle << ")" << std::endl;
+    return true;
+}
+
+bool machine_snapshot::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "[Snapshot] Error: Could not open " << path << std::endl;
+        return false;
+    }
+
+    char magic[sizeof(SNAPSHOT_MAGIC)];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) != 0) {
+        std::cerr << "[Snapshot] Error: " << path << " is not a snapshot." << std::endl;
+        return false;
+    }
+    if (in.get() != VERSION) {
+        std::cerr << "[Snapshot] Error: Unsupported snapshot version." << std::endl;
+        return false;
+    }
+
+    u8 header[9];
+    if (!in.read((char*)header, sizeof(header))) {
+        std::cerr << "[Snapshot] Error: Truncated header." << std::endl;
+        return false;
+    }
+    cycle = 0;
+    for (int i = 0; i < 8; i++) cycle |= (u64)header[i] << (i * 8);
+    machine_type = header[8];
+
+    int count = 0;
+    const block* b = blocks(count);
+    for (int i = 0; i < count; i++) {
+        if (!in.read((char*)block_data(i), b[i].size)) {
+            std::cerr << "[Snapshot] Error: " << path << " is truncated (" << b[i].name << ")." << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+//  Diff
+// ============================================================================
+//  WHAT: First offset in [from, n) where a and b differ (n if none).
+//  HOW:  16 bytes per compare; a fully equal chunk is one movemask test.
+// ============================================================================
+static u32 next_difference(const u8* a, const u8* b, u32 from, u32 n) {
+    u32 i = from;
+#ifdef SNAPSHOT_SSE2
+    for (; i + 16 <= n; i += 16) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+        u32 same = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb));
+        if (same != 0xFFFF) {
+            u32 diff = ~same & 0xFFFF;
+#if defined(__GNUC__)
+            return i + (u32)__builtin_ctz(diff);
+#else
+            while (!(diff & 1)) { diff >>= 1; i++; }
+            return i;
+#endif
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        if (a[i] != b[i]) return i;
+    }
+    return n;
+}
+
+void snapshot_diff::compare(const machine_snapshot& a, const machine_snapshot& b, size_t max_ranges) {
+    ranges.clear();
+    total_bytes = 0;
+    truncated = false;
+
+    int count = 0;
+    const machine_snapshot::block* blocks = machine_snapshot::blocks(count);
+    for (int blk = 0; blk < count; blk++) {
+        const u8* pa = a.block_data(blk);
+        const u8* pb = b.block_data(blk);
+        const u32 n = blocks[blk].size;
+
+        u32 i = next_difference(pa, pb, 0, n);
+        while (i < n) {
+            // Extend the span until MERGE_GAP equal bytes in a row
+            u32 start = i;
+            u32 end = i + 1;        // Exclusive
+            total_bytes++;
+            for (u32 j = i + 1; j < n && j - end < MERGE_GAP; j++) {
+                if (pa[j] != pb[j]) { end = j + 1; total_bytes++; }
+            }
+
+            if (ranges.size() < max_ranges) {
+                diff_range r;
+                r.block = blk;
+                r.offset = start;
+                r.length = end - start;
+                r.before.assign(pa + start, pa + end);
+                r.after.assign(pb + start, pb + end);
+                ranges.push_back(std::move(r));
+            } else {
+                truncated = true;
+            }
+            i = next_difference(pa, pb, end, n);
+        }
+    }
+}
+
+std::string snapshot_diff::format_range(const diff_range& r, size_t max_bytes) const {
+    static const char* cpu_names[] = { "A", "X", "Y", "S", "P", "PCL", "PCH" };
+
+    int count = 0;
+    const machine_snapshot::block& blk = machine_snapshot::blocks(count)[r.block];
+    char where[48];
+    if (r.block == 0) {
+        std::snprintf(where, sizeof(where), "CPU %s", cpu_names[r.offset]);
+        if (r.length > 1) std::snprintf(where + std::strlen(where), sizeof(where) - std::strlen(where),
+                                        "-%s", cpu_names[r.offset + r.length - 1]);
+    } else if (r.length == 1) {
+        std::snprintf(where, sizeof(where), "%s $%04X", blk.name, (unsigned)(blk.base + r.offset));
+    } else {
+        std::snprintf(where, sizeof(where), "%s $%04X-$%04X", blk.name, (unsigned)(blk.base + r.offset),
+                      (unsigned)(blk.base + r.offset + r.length - 1));
+    }
+
+    auto hex = [&](const std::vector<u8>& v) {
+        std::string s;
+        char byte[4];
+        for (size_t i = 0; i < v.size() && i < max_bytes; i++) {
+            std::snprintf(byte, sizeof(byte), i ? " %02X" : "%02X", v[i]);
+            s += byte;
+        }
+        if (v.size() > max_bytes) s += " ...";
+        return s;
+    };
+    return std::string(where) + ": " + hex(r.before) + " -> " + hex(r.after);
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "types.h"
+
+// ============================================================================
+//  Machine Snapshot & Diff
+// ============================================================================
+//  WHAT: A copy of everything a program can leave behind (CPU registers,
+//        RAM, ROM, VIA and ACIA registers) and a byte-level comparison of
+//        two such copies.
+//  WHY:  Regression triage: "what is different at cycle N between this
+//        build and the last good one?". The debugger can compare the live
+//        board against a snapshot, and the headless runner can write one at
+//        the end of a run and diff two files.
+//  HOW:  The state is a handful of flat blocks. The diff walks each block
+//        16 bytes at a time (SSE2 byte compare), so 64K costs microseconds;
+//        only the differing spans are examined byte by byte.
+//        This is not a save state: it cannot be loaded back into the board.
+//
+//  File: "E6502SNP" | version u8 | cycle u64 | machine type u8 | blocks
+// ============================================================================
+struct machine_snapshot {
+    static constexpr u8 VERSION = 1;
+
+    // CPU block layout
+    enum cpu_reg { CPU_A, CPU_X, CPU_Y, CPU_S, CPU_P, CPU_PCL, CPU_PCH, CPU_REGS };
+
+    u64 cycle = 0;
+    u8  machine_type = 0;
+    u8  cpu[CPU_REGS] = {};
+    u8  ram[0x8000] = {};       // The whole 62256 (only $0000-$3FFF is mapped)
+    u8  rom[0x8000] = {};
+    u8  via[16] = {};
+    u8  acia[4] = {};
+
+    // WHAT: One comparable region of the snapshot.
+    struct block {
+        const char* name;
+        u16 base;               // Address shown for offset 0
+        u32 size;
+    };
+    static const block* blocks(int& count);
+    const u8* block_data(int index) const;
+
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+};
+
+// ============================================================================
+//  snapshot_diff
+// ============================================================================
+struct diff_range {
+    int block;                  // Index into machine_snapshot::blocks()
+    u32 offset;                 // Within the block
+    u32 length;
+    std::vector<u8> before;
+    std::vector<u8> after;
+};
+
+// WHAT: The spans where 'b' differs from 'a', in block order. Spans closer
+//       than MERGE_GAP bytes are merged so the list stays compact.
+//       Stops after 'max_ranges'; 'total_bytes' counts every changed byte.
+struct snapshot_diff {
+    static constexpr u32 MERGE_GAP = 4;
+
+    std::vector<diff_range> ranges;
+    u32  total_bytes = 0;
+    bool truncated = false;
+
+    void compare(const machine_snapshot& a, const machine_snapshot& b, size_t max_ranges = 1024);
+
+    // WHAT: One line per range, e.g. "RAM $0200-$0203: 00 00 00 00 -> 48 65 6C 6C"
+    std::string format_range(const diff_range& r, size_t max_bytes = 8) const;
+};
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+#include "types.h"
+
+// ============================================================================
+//  spsc_fifo (Lock-Free Single-Producer / Single-Consumer Ring)
+// ============================================================================
+//  WHAT: A fixed-size ring that one thread fills and one other thread drains,
+//        with no locks and no system calls.
+//  WHO:  The serial bridge: host thread -> board (RX) and board -> host (TX).
+//  WHY:  The emulation thread must never wait on the host. A full or empty
+//        ring is simply reported (push/pop return 0) and the caller turns
+//        that into back-pressure.
+//  HOW:  Free-running head (consumer) and tail (producer) indices; the
+//        capacity is a power of two so the slot is 'index & mask'. Each side
+//        only stores its own index (release) and loads the other (acquire).
+//        The span API hands out the (at most two) contiguous regions of the
+//        ring, so readv()/writev() or asio buffer sequences can move data in
+//        and out without an intermediate copy.
+// ============================================================================
+template <typename T>
+class spsc_fifo {
+public:
+    struct span {
+        T*     data;
+        size_t size;
+    };
+
+    // WHAT: Capacity is rounded up to a power of two (minimum 2).
+    explicit spsc_fifo(size_t capacity) {
+        size_t n = 2;
+        while (n < capacity) n <<= 1;
+        m_buf.resize(n);
+        m_mask = n - 1;
+    }
+
+    spsc_fifo(const spsc_fifo&) = delete;
+    spsc_fifo& operator=(const spsc_fifo&) = delete;
+
+    size_t capacity() const { return m_mask + 1; }
+
+    // Exact on the calling side, a lower/upper bound for the other one
+    size_t size() const  { return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire); }
+    size_t space() const { return capacity() - size(); }
+    bool   empty() const { return size() == 0; }
+
+    // ========================================================================
+    //  Producer Side
+    // ========================================================================
+    bool push(const T& v) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == capacity()) return false;
+        m_buf[tail & m_mask] = v;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // WHAT: Free regions in ring order. Returns how many spans (0-2) are valid.
+    int write_spans(span out[2]) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        const size_t free = capacity() - (tail - m_head.load(std::memory_order_acquire));
+        return make_spans(tail, free, out);
+    }
+
+    // WHAT: Publishes 'n' elements written through write_spans().
+    void commit_write(size_t n) {
+        m_tail.store(m_tail.load(std::memory_order_relaxed) + n, std::memory_order_release);
+    }
+
+    // ========================================================================
+    //  Consumer Side
+    // ========================================================================
+    bool pop(T& v) {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (m_tail.load(std::memory_order_acquire) == head) return false;
+        v = m_buf[head & m_mask];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // WHAT: Filled regions in ring order. Returns how many spans (0-2) are valid.
+    int read_spans(span out[2]) {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        const size_t used = m_tail.load(std::memory_order_acquire) - head;
+        return make_spans(head, used, out);
+    }
+
+    // WHAT: Releases 'n' elements consumed through read_spans().
+    void commit_read(size_t n) {
+        m_head.store(m_head.load(std::memory_order_relaxed) + n, std::memory_order_release);
+    }
+
+private:
+    int make_spans(size_t index, size_t count, span out[2]) {
+        if (count == 0) return 0;
+        const size_t start = index & m_mask;
+        const size_t first = (count < capacity() - start) ? count : capacity() - start;
+        out[0] = { &m_buf[start], first };
+        if (first == count) return 1;
+        out[1] = { &m_buf[0], count - first };
+        return 2;
+    }
+
+    std::vector<T> m_buf;
+    size_t m_mask = 0;
+
+    // Each index on its own cache line: the two threads never share a line
+    alignas(64) std::atomic<size_t> m_head{0};     // Next slot to read  (consumer)
+    alignas(64) std::atomic<size_t> m_tail{0};     // Next slot to write (producer)
+};
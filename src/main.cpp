@@ -1,8 +1,11 @@
 #include <iostream>
 #include <vector>
+#include <string>
 #include <cstring>
+#include <cstdlib>
 #include <chrono>
 #include <thread>
+#include <memory>
 
 
 // UI Includes
@@ -11,16 +14,239 @@
 
 // Hardware Includes
 #include "driver/mainboard.h"
+#include "devices/cpu/m6502.h"
+#include "devices/video/nhd_0216k1z.h"
+#include "emu/debug/gdbstub.h"
+#include "emu/audio.h"
+#include "emu/serial.h"
+#include "devices/storage/sdcard.h"
+#include <filesystem>
 
 // ============================================================================
-// 4. MAIN ENTRY POINT
+// 1. COMMAND LINE
 // ============================================================================
-int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
+//  eater.exe [--rom file] [--symbols file] [--record journal]
+//            [--replay journal] [--headless] [--cycles N]
+//            [--save-snapshot file] [--diff a.snap b.snap]
+//            [--gdb socket-path | --gdb tcp:PORT]
+//            [--serial pty|stdio|unix:PATH] [--serial-turbo] [--serial-depth N]
+//            [--audio file.wav | --audio "|command"]
+//            [--machine 1|2|3] [--keys TEXT] [--sdcard image]
+// ============================================================================
+struct launch_options {
+    std::string rom;            // Firmware override (default: rom.bin)
+    std::string symbols;        // Label file (default: <rom>.sym if present)
+    std::string record;         // Input journal to write
+    std::string replay;         // Input journal to play back
+    bool headless = false;      // Run without the UI
+    u64  cycles = 0;            // Headless: cycles to run (0 = until journal ends)
+    std::string save_snapshot;  // Headless: state file to write at the end
+    std::string diff_a, diff_b; // Compare two state files and exit
+    std::string gdb;            // GDB remote endpoint (Unix socket path or tcp:PORT)
+    std::string serial;         // ACIA host bridge ("pty", "stdio" or "unix:PATH")
+    size_t serial_depth = serial_bridge::DEFAULT_DEPTH;     // Bytes per direction
+    bool serial_turbo = false;  // ACIA ignores the baud rate
+    std::string audio;          // PB7/CB2 sound: WAV file or "|command"
+    int  machine = 0;           // Schematic number (0 = default)
+    std::string keys;           // Headless: text typed on the PS/2 keyboard
+    std::string sdcard;         // SD card image on the port A SPI bus (Schematic 2)
+};
+
+// WHAT: --keys escapes: \n (Enter), \t, \b (Backspace), \\.
+static std::string unescape_keys(const std::string& in) {
+    std::string out;
+    for (size_t i = 0; i < in.size(); i++) {
+        if (in[i] != '\\' || i + 1 == in.size()) { out += in[i]; continue; }
+        switch (in[++i]) {
+            case 'n': out += '\n'; break;
+            case 't': out += '\t'; break;
+            case 'b': out += '\b'; break;
+            default:  out += in[i]; break;
+        }
+    }
+    return out;
+}
+
+static bool parse_args(int argc, char* argv[], launch_options& opt) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = (i + 1 < argc);
+
+        if      (arg == "--headless")              opt.headless = true;
+        else if (arg == "--rom"    && has_value)   opt.rom    = argv[++i];
+        else if (arg == "--symbols" && has_value)  opt.symbols = argv[++i];
+        else if (arg == "--record" && has_value)   opt.record = argv[++i];
+        else if (arg == "--replay" && has_value)   opt.replay = argv[++i];
+        else if (arg == "--cycles" && has_value)   opt.cycles = std::strtoull(argv[++i], nullptr, 0);
+        else if (arg == "--save-snapshot" && has_value) opt.save_snapshot = argv[++i];
+        else if (arg == "--gdb"    && has_value)   opt.gdb    = argv[++i];
+        else if (arg == "--serial" && has_value)   opt.serial = argv[++i];
+        else if (arg == "--serial-turbo")          opt.serial_turbo = true;
+        else if (arg == "--serial-depth" && has_value) opt.serial_depth = (size_t)std::strtoull(argv[++i], nullptr, 0);
+        else if (arg == "--audio"  && has_value)   opt.audio  = argv[++i];
+        else if (arg == "--machine" && has_value)  opt.machine = std::atoi(argv[++i]);
+        else if (arg == "--keys"   && has_value)   opt.keys   = unescape_keys(argv[++i]);
+        else if (arg == "--sdcard" && has_value)   opt.sdcard = argv[++i];
+        else if (arg == "--diff" && i + 2 < argc) {
+            opt.diff_a = argv[++i];
+            opt.diff_b = argv[++i];
+        }
+        else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--rom file] [--symbols file] [--record journal] [--replay journal]"
+                         " [--headless] [--cycles N] [--save-snapshot file] [--diff a.snap b.snap]"
+                         " [--gdb socket|tcp:PORT] [--serial pty|stdio|unix:PATH] [--serial-turbo]"
+                         " [--serial-depth N] [--audio file.wav|\"|command\"]"
+                         " [--machine 1|2|3] [--keys TEXT] [--sdcard image]" << std::endl;
+            return false;
+        }
+    }
+    if (opt.machine < 0 || opt.machine > 3) {
+        std::cerr << "[System] --machine takes 1, 2 or 3." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// 2. HEADLESS RUNNER
+// ============================================================================
+//  WHAT: Runs the board flat out with no window and no frame pacing.
+//  WHY:  Reproducing a recorded session (or a long soak test) should not be
+//        bound to 60 FPS x cycles-per-frame.
+//  NOTE: With --serial and no cycle count it runs until the host end closes
+//        and every byte it sent has reached the firmware (plus one more
+//        chunk for the answer). With "stdio" the report goes to stderr.
+//        --keys is typed after 1/KEYS_DELAY_DIV s of emulated time (room
+//        for the firmware's own init); without a cycle count the run lasts
+//        until every key has reached the VIA (plus one chunk).
+// ============================================================================
+static constexpr u32 KEYS_DELAY_DIV = 10;     // 100 ms
+
+static int run_headless(mb_driver& computer, const launch_options& opt, serial_bridge* serial) {
+    m6502_p* cpu = computer.get_cpu();
+
+    u64 end = opt.cycles;
+    if (end == 0 && computer.get_journal().is_replaying()) {
+        end = computer.get_journal().last_cycle() + 1;
+    }
+    if (end == 0 && (serial || !opt.keys.empty())) end = ~0ull;
+    if (end == 0) {
+        std::cerr << "[Headless] Nothing to do: pass --cycles, --replay, --serial or --keys." << std::endl;
+        return -1;
+    }
+    FILE* report = (serial && serial->name() == "stdio") ? stderr : stdout;
+
+    std::cerr << "[Headless] Running to cycle " << end << "..." << std::endl;
+    auto t0 = std::chrono::steady_clock::now();
+
+    const u64 chunk = 1000000;
+    const u64 keys_at = cpu->total_cycles() + cpu->clock() / KEYS_DELAY_DIV;
+    bool keys_typed = opt.keys.empty();
+    while (cpu->total_cycles() < end) {
+        u64 before = cpu->total_cycles();
+        if (!keys_typed && before >= keys_at) {
+            computer.keyboard_type(opt.keys);
+            keys_typed = true;
+        }
+        u64 left = end - before;
+        if (!keys_typed && keys_at - before < left) left = keys_at - before;
+
+        // Inputs all delivered: this chunk is the last (the firmware's answer)
+        bool host_done = !serial || (serial->closed() && serial->rx().empty());
+        bool keys_done = keys_typed && computer.keyboard_idle();
+        bool inputs_done = (serial || !opt.keys.empty()) && host_done && keys_done;
+
+        computer.run((int)(left < chunk ? left : chunk));
+        if (cpu->total_cycles() == before) {
+            std::cerr << "[Headless] CPU halted." << std::endl;
+            break;
+        }
+        if (inputs_done && opt.cycles == 0) break;
+    }
+
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    std::fprintf(report, "cycles=%llu time=%.3fs (%.1f MHz)\n", (unsigned long long)cpu->total_cycles(), secs,
+                 secs > 0 ? cpu->total_cycles() / secs / 1e6 : 0.0);
+    std::fprintf(report, "PC=%04X A=%02X X=%02X Y=%02X S=%02X P=%02X\n",
+                 cpu->get_pc(), cpu->get_a(), cpu->get_x(), cpu->get_y(), cpu->get_sp(), cpu->get_flags());
+    for (const std::string& line : computer.get_lcd()->get_display_lines()) {
+        std::fprintf(report, "LCD |%s|\n", line.c_str());
+    }
+
+    if (!opt.save_snapshot.empty()) {
+        machine_snapshot snap;
+        computer.capture_snapshot(snap);
+        if (!snap.save(opt.save_snapshot)) return -1;
+    }
+    return 0;
+}
+
+// ============================================================================
+// 3. HEADLESS GDB SESSION
+// ============================================================================
+//  WHAT: Serves one GDB client with no window: the board starts halted and
+//        only runs between 'c' and the next stop.
+//  HOW:  Runs short slices so Ctrl-C and breakpoints are answered quickly;
+//        sleeps while halted. Ends when the client goes away.
+// ============================================================================
+static int run_gdb_headless(mb_driver& computer, gdb_server& gdb) {
+    device_debug& dbg = computer.get_cpu()->debug();
+    bool is_paused = true;
+    bool seen_client = false;
+
+    std::cerr << "[Headless] Waiting for GDB..." << std::endl;
+    while (true) {
+        if (gdb.connected()) seen_client = true;
+        else if (seen_client) break;
+
+        if (!is_paused) computer.run(10000);
+        gdb.poll(is_paused);
+        if (dbg.consume_break()) is_paused = true;
+        if (is_paused) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return 0;
+}
+
+// ============================================================================
+// 4. SNAPSHOT DIFF
+// ============================================================================
+//  WHAT: Prints the changed ranges between two state files.
+//  WHY:  Regression triage next to --save-snapshot: run the old and new
+//        firmware headless to the same cycle, then diff.
+//  HOW:  Exit code 0 = identical, 1 = different, -1 = error.
+// ============================================================================
+static int run_diff(const launch_options& opt) {
+    std::unique_ptr<machine_snapshot> a = std::make_unique<machine_snapshot>();
+    std::unique_ptr<machine_snapshot> b = std::make_unique<machine_snapshot>();
+    if (!a->load(opt.diff_a) || !b->load(opt.diff_b)) return -1;
+
+    snapshot_diff diff;
+    diff.compare(*a, *b);
+
+    std::printf("--- %s (cycle %llu)\n", opt.diff_a.c_str(), (unsigned long long)a->cycle);
+    std::printf("+++ %s (cycle %llu)\n", opt.diff_b.c_str(), (unsigned long long)b->cycle);
+    for (const diff_range& r : diff.ranges) {
+        std::printf("%s\n", diff.format_range(r, 16).c_str());
+    }
+    std::printf("%zu range%s, %u byte%s changed%s\n", diff.ranges.size(), diff.ranges.size() == 1 ? "" : "s",
+                diff.total_bytes, diff.total_bytes == 1 ? "" : "s", diff.truncated ? " (list truncated)" : "");
+    return diff.ranges.empty() ? 0 : 1;
+}
+
+// ============================================================================
+// 5. MAIN ENTRY POINT
+// ============================================================================
+int main(int argc, char* argv[]) {
     std::cerr << "[System] Initializing Emulator..." << std::endl;
 
+    launch_options opt;
+    if (!parse_args(argc, argv, opt)) return -1;
+    if (!opt.diff_a.empty()) return run_diff(opt);
+
     // 1. Setup UI
     Renderer renderer;
-    if (!renderer.init(1920, 1080, "Ben Eater 6502 Emulator")) {
+    if (!opt.headless && !renderer.init(1920, 1080, "Ben Eater 6502 Emulator")) {
         std::cerr << "[System] Renderer Init Failed!" << std::endl;
         return -1;
     }
@@ -29,8 +255,71 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
     // This runs the internal init(), loads the ROM, and wires the schematic.
     mb_driver computer;
     computer.init();
+    if (!opt.rom.empty() && !computer.load_rom(opt.rom.c_str())) return -1;
     computer.reset();
 
+    // Debugger labels: explicit file, else the .sym written next to the ROM
+    symbol_table& symbols = computer.get_cpu()->debug().symbols();
+    if (!opt.symbols.empty()) {
+        if (!symbols.load(opt.symbols)) return -1;
+    } else {
+        std::string companion = symbol_table::companion_path(opt.rom.empty() ? "rom.bin" : opt.rom);
+        std::error_code ec;
+        if (std::filesystem::exists(companion, ec)) symbols.load(companion);
+    }
+
+    // Hardware variant (before a recording starts: the header carries it)
+    if (opt.machine) computer.set_machine_type((MachineType)(opt.machine - 1));
+
+    // Journals start from the freshly reset board
+    if (!opt.replay.empty()) {
+        if (!computer.start_replay(opt.replay)) return -1;
+    } else if (!opt.record.empty()) {
+        if (!computer.start_recording(opt.record)) return -1;
+    }
+
+    // GDB stub: one instruction per step, on the same board the UI drives
+    std::unique_ptr<gdb_server> gdb;
+    if (!opt.gdb.empty()) {
+        gdb = std::make_unique<gdb_server>(*computer.get_cpu(), [&computer] { computer.run(1); });
+        if (!gdb->start(opt.gdb)) return -1;
+    }
+
+    // Serial host bridge: the ACIA talks to a pty or to stdin/stdout
+    std::unique_ptr<serial_bridge> serial;
+    if (!opt.serial.empty()) {
+        serial = std::make_unique<serial_bridge>(opt.serial_depth ? opt.serial_depth : serial_bridge::DEFAULT_DEPTH);
+        if (!serial->start(opt.serial)) return -1;
+        computer.attach_serial(serial.get());
+    }
+    // After the journal has started, so a recording carries the setting
+    if (opt.serial_turbo) computer.set_serial_turbo(true);
+
+    // Sound pins to a WAV file (or a player reading one from a pipe)
+    std::unique_ptr<audio_out> audio;
+    if (!opt.audio.empty()) {
+        audio = std::make_unique<audio_out>();
+        if (!audio->open(opt.audio)) return -1;
+        computer.attach_audio(audio.get());
+    }
+
+    // SD card: the image is mapped, not loaded, and written in place
+    std::unique_ptr<sd_card> sdcard;
+    if (!opt.sdcard.empty()) {
+        sdcard = std::make_unique<sd_card>();
+        if (!sdcard->open(opt.sdcard)) return -1;
+        computer.attach_sdcard(sdcard.get());
+    }
+
+    if (opt.headless) {
+        int rc = gdb ? run_gdb_headless(computer, *gdb) : run_headless(computer, opt, serial.get());
+        computer.stop_journal();
+        computer.attach_serial(nullptr);
+        computer.attach_audio(nullptr);
+        computer.attach_sdcard(nullptr);
+        return rc;
+    }
+
     // 3. Setup Debugger
     // We pass the pointers to the specific chips so the UI can "peek" at them.
     bool is_paused = true; 
@@ -83,6 +372,9 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
             step_req = false;
         }
 
+        // Remote debugger: before the UI, so it sees a breakpoint stop first
+        if (gdb) gdb->poll(is_paused);
+
         // Draw UI
         debugger.draw(is_paused, step_req);
         
@@ -99,6 +391,10 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
         }
     }
     std::cerr << "Main Loop Exited." << std::endl;
+    computer.stop_journal();
+    computer.attach_serial(nullptr);
+    computer.attach_audio(nullptr);
+    computer.attach_sdcard(nullptr);
     renderer.shutdown();
     return 0;
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "../../../vendor/imgui/imgui.h"
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <string>
 #include <cmath>
 #include <windows.h>
@@ -12,6 +13,12 @@
 // We need the CPU definition to access registers (A, X, Y, PC)
 // Ensure this path matches where you put your CPU file
 #include "devices/cpu/m6502.h" 
+#include "emu/debug/dvdisasm.h"
+#include "emu/debug/heatmap.h"
+#include "emu/debug/search.h"
+#include "emu/snapshot.h"
+#include <filesystem>
+#include <GLFW/glfw3.h>     // OpenGL 1.1 texture calls (heatmap, LCD glyph atlas)
 
 bool DebugView::m_enable_trace = false;
 bool DebugView::m_en_cpu_trace = false;
@@ -91,6 +98,19 @@ DebugView::DebugView(mb_driver* driver)
     m_via = driver->get_via();
     m_acia = driver->get_acia();
     m_lcd = driver->get_lcd();
+
+    // Disassembly cache: invalidated through the board's page generations
+    if (m_cpu) {
+        m_disasm = std::make_unique<debug_disasm>(*m_cpu, [driver](u8 page) {
+            return driver->page_generation(page);
+        });
+        m_disasm->set_symbols(&m_cpu->debug().symbols());
+    }
+}
+
+DebugView::~DebugView() {
+    // The CPU must not keep counting into a heatmap we are about to free
+    if (m_heatmap && m_cpu) m_cpu->debug().attach_heatmap(nullptr);
 }
 
 // ============================================================================
@@ -101,7 +121,18 @@ DebugView::DebugView(mb_driver* driver)
 //  WHY:  Orchestrates which windows are drawn based on user selection.
 // ============================================================================
 void DebugView::draw(bool& is_paused, bool& step_request) {
+
+    // 0. Did the last run slice stop on a breakpoint / watchpoint?
+    if (m_cpu && m_cpu->debug().consume_break()) {
+        is_paused = true;
+        m_status_message = m_cpu->debug().break_reason();
+        m_status_timer = 8.0f;
+        add_log(LOG_INFO, "[Debug] %s", m_status_message.c_str());
+    }
     
+    // Memory views snapshot lazily, at most once per frame
+    m_mem_valid = false;
+
     // 1. Draw Top Menu
     draw_menu_bar(is_paused, step_request);
 
@@ -110,12 +141,55 @@ void DebugView::draw(bool& is_paused, bool& step_request) {
     if (m_show_stack)       draw_stack_smart();
     if (m_show_via)         draw_via_window();
     if (m_show_acia)        draw_acia_window();
+    if (m_show_keyboard)    draw_keyboard_window();
     if (m_show_ram)         draw_memory_window();
     if (m_show_lcd)         draw_lcd_window();
     if (m_show_rom)         draw_rom_window();
     if (m_show_speed)       draw_speed_control();
     if (m_show_status_bar)  draw_status_bar();
     if (m_show_log)         draw_log_window();
+    if (m_show_breakpoints) draw_breakpoint_window();
+    if (m_show_disasm)      draw_disasm_window();
+    if (m_show_search)      draw_search_window();
+    if (m_show_diff)        draw_diff_window();
+
+    // Heatmap counters exist (and cost bus time) only while it is shown
+    if (m_show_heatmap != (m_heatmap != nullptr)) set_heatmap_enabled(m_show_heatmap);
+    if (m_show_heatmap)     draw_heatmap_window();
+
+    // Memory window closed: stop timestamping RAM writes
+    if (!m_show_ram && m_ram_obs_first >= 0) observe_ram_pages(0, -1);
+}
+
+// ============================================================================
+// Memory Snapshot
+// ============================================================================
+//  WHAT: The frame's copy of the 64K address space.
+//  HOW:  RAM and ROM pages are memcpy'd (RAM only when its dirty bit is
+//        set, ROM only when its page generation moved), I/O pages go
+//        through the debug (peek) handlers, so drawing never disturbs the
+//        hardware.
+// ============================================================================
+const uint8_t* DebugView::memory_snapshot() {
+    if (m_mem_valid || !m_cpu) return m_mem;
+
+    // Only re-copy pages whose contents changed. I/O pages have no
+    // generation counter (0) and are always re-read.
+    const u64 ram_dirty = m_driver->take_ram_dirty();
+    for (int p = 0; p < 256; p++) {
+        if (p < 64) {
+            if (m_mem_primed && !((ram_dirty >> p) & 1)) continue;
+            m_cpu->read_range_debug((u16)(p << 8), 256, m_mem + (p << 8));
+            continue;
+        }
+        u32 gen = m_driver->page_generation((u8)p);
+        if (gen != 0 && m_mem_primed && gen == m_mem_gen[p]) continue;
+        m_cpu->read_range_debug((u16)(p << 8), 256, m_mem + (p << 8));
+        m_mem_gen[p] = gen;
+    }
+    m_mem_primed = true;
+    m_mem_valid = true;
+    return m_mem;
 }
 
 // ============================================================================
@@ -136,7 +210,22 @@ void DebugView::draw_menu_bar(bool& is_paused, bool& step_request) {
             ImGui::Separator();
             
             if (ImGui::MenuItem("Reset CPU")) {
-                if (m_cpu) m_cpu->device_reset();
+                m_driver->reset_cpu();
+            }
+
+            ImGui::Separator();
+
+            // Input Journal status (recording/replay is started from the command line)
+            const input_journal& journal = m_driver->get_journal();
+            if (journal.is_recording()) {
+                ImGui::TextColored(ImVec4(1, 0.3f, 0.3f, 1), "Journal: Recording (%zu inputs)", journal.event_count());
+                if (ImGui::MenuItem("Stop Recording")) m_driver->stop_journal();
+            } else if (journal.is_replaying()) {
+                ImGui::TextColored(ImVec4(0.3f, 1, 0.3f, 1), "Journal: Replaying (%zu / %zu)",
+                                   journal.events_done(), journal.event_count());
+                if (ImGui::MenuItem("Stop Replay")) m_driver->stop_journal();
+            } else {
+                ImGui::TextDisabled("Journal: Idle");
             }
             ImGui::EndMenu();
         }
@@ -147,10 +236,16 @@ void DebugView::draw_menu_bar(bool& is_paused, bool& step_request) {
             ImGui::MenuItem("Stack Viewer",  nullptr, &m_show_stack);
             ImGui::MenuItem("VIA (U5)",      nullptr, &m_show_via);
             ImGui::MenuItem("ACIA (U7)",     nullptr, &m_show_acia);
+            ImGui::MenuItem("PS/2 Keyboard", nullptr, &m_show_keyboard);
             ImGui::MenuItem("Memory Dump",   nullptr, &m_show_ram);
             ImGui::MenuItem("Rom",           nullptr, &m_show_rom);
             ImGui::MenuItem("LCD Display",   nullptr, &m_show_lcd);
             ImGui::MenuItem("Speed Control", nullptr, &m_show_speed);
+            ImGui::MenuItem("Breakpoints",   nullptr, &m_show_breakpoints);
+            ImGui::MenuItem("Disassembly",   nullptr, &m_show_disasm);
+            ImGui::MenuItem("Memory Heatmap", nullptr, &m_show_heatmap);
+            ImGui::MenuItem("Memory Search", nullptr, &m_show_search);
+            ImGui::MenuItem("Snapshot Diff", nullptr, &m_show_diff);
             ImGui::EndMenu();
         }
 
@@ -228,9 +323,10 @@ void DebugView::draw_rom_window() {
         if (m_driver->load_rom(m_rom_path)) {
             // 2. Reset CPU to load new Vector
             m_driver->reset();
-            snprintf(m_status_msg, 128, "Success: Loaded %s", m_rom_path);
+            snprintf(m_status_msg, sizeof(m_status_msg), "Success: Loaded %.100s", m_rom_path);
+            load_companion_symbols(m_rom_path);
         } else {
-            snprintf(m_status_msg, 128, "Error: File not found!");
+            snprintf(m_status_msg, sizeof(m_status_msg), "Error: File not found!");
         }
     }
 
@@ -238,9 +334,38 @@ void DebugView::draw_rom_window() {
     ImGui::SameLine();
     ImGui::TextColored(ImVec4(1, 1, 0, 1), "%s", m_status_msg);
 
+    // Symbols (label = $addr, ca65/vasm label files, rom_build.py output)
+    ImGui::Separator();
+    ImGui::InputText("Symbols", m_sym_path, 256);
+    if (ImGui::Button("Load Symbols") && m_cpu) {
+        symbol_table fresh;
+        if (fresh.load(m_sym_path)) {
+            symbol_table& syms = m_cpu->debug().symbols();
+            syms.replace(std::move(fresh));
+            snprintf(m_status_msg, sizeof(m_status_msg), "Loaded %zu symbols", syms.size());
+        } else {
+            snprintf(m_status_msg, sizeof(m_status_msg), "Error: Could not open %.100s", m_sym_path);
+        }
+    }
+    if (m_cpu) {
+        ImGui::SameLine();
+        ImGui::TextDisabled("(%zu loaded)", m_cpu->debug().symbols().size());
+    }
+
     ImGui::End();
 }
 
+void DebugView::load_companion_symbols(const char* rom_path) {
+    if (!m_cpu) return;
+    std::string path = symbol_table::companion_path(rom_path);
+    std::error_code ec;
+    if (!std::filesystem::exists(path, ec)) return;
+
+    symbol_table& syms = m_cpu->debug().symbols();
+    syms.clear();
+    if (syms.load(path)) snprintf(m_sym_path, sizeof(m_sym_path), "%s", path.c_str());
+}
+
 // ============================================================================
 // CPU Window
 // ============================================================================
@@ -298,7 +423,7 @@ void DebugView::draw_cpu_window(bool& is_paused, bool& step_request) {
              if (ImGui::Button("Run")) is_paused = false;
              ImGui::SameLine();
              if (ImGui::Button("Reset")) {
-                if (m_cpu) m_cpu->device_reset();
+                m_driver->reset_cpu();
              }
         } else {
              if (ImGui::Button("Pause")) is_paused = true;
@@ -312,7 +437,7 @@ void DebugView::draw_cpu_window(bool& is_paused, bool& step_request) {
         int current_idx = (int)current;
         
         // 2. Define Names
-        const char* items[] = { "Schematic 1 (Basic)", "Schematic 2 (Serial)" };
+        const char* items[] = { "Schematic 1 (Basic)", "Schematic 2 (Serial)", "Schematic 3 (Keyboard)" };
         
         // 3. Draw Combo Box
         if (ImGui::Combo("Motherboard", &current_idx, items, IM_ARRAYSIZE(items))) {
@@ -326,6 +451,9 @@ void DebugView::draw_cpu_window(bool& is_paused, bool& step_request) {
         if (current_idx == 1) {
             ImGui::TextColored(ImVec4(1,1,0,1), "Note: Requires ROM with Serial support!");
         }
+        if (current_idx == 2) {
+            ImGui::TextColored(ImVec4(1,1,0,1), "Note: Requires ROM with a 4-bit LCD driver!");
+        }
 
     } else {
         ImGui::TextColored(ImVec4(1, 0, 0, 1), "CPU Not Connected");
@@ -368,9 +496,10 @@ void DebugView::draw_stack_smart() {
                 //    Actually, stacks are usually visualized "Top Down" (Latest on top).
                 //    Let's loop from SP+1 (Latest) up to 0xFF (Oldest).
                 
+                const u8* mem = memory_snapshot();
                 for (int i = sp + 1; i <= 0xFF; i++) {
                     u16 addr = 0x0100 + i;
-                    u8 val = m_cpu->debug_peek(addr);
+                    u8 val = mem[addr];
 
                     ImGui::TableNextRow();
                     
@@ -392,6 +521,24 @@ void DebugView::draw_stack_smart() {
                     
                     if (i == 0xFF) ImGui::TextDisabled("Base (01FF)");
                     else if (i == sp + 1) ImGui::TextColored(ImVec4(0,1,0,1), "Top of Stack");
+
+                    // JSR pushes (return address - 1), high byte first. If this
+                    // byte and the next look like one that follows a JSR,
+                    // name the caller.
+                    if (i < 0xFF) {
+                        u16 ret = (u16)(val | (mem[0x0100 + i + 1] << 8));
+                        u16 jsr = (u16)(ret - 2);
+                        if (mem[jsr] == 0x20) {
+                            const symbol_table& syms = m_cpu->debug().symbols();
+                            char caller[48];
+                            ImGui::SameLine();
+                            if (syms.format(jsr, caller, sizeof(caller))) {
+                                ImGui::TextColored(ImVec4(1, 0.6f, 0, 1), "ret %04X (%s)", (u16)(ret + 1), caller);
+                            } else {
+                                ImGui::TextColored(ImVec4(1, 0.6f, 0, 1), "ret %04X", (u16)(ret + 1));
+                            }
+                        }
+                    }
                 }
                 ImGui::EndTable();
             }
@@ -438,6 +585,14 @@ void DebugView::draw_via_window() {
         DrawBinary("DDRA", ddra);
         DrawBinary("ORA ", ora);
 
+        // Shift Register (ACR bits 4-2 select the mode)
+        ImGui::Separator();
+        static const char* sr_modes[8] = { "Disabled", "In / T2", "In / PHI2", "In / CB1",
+                                           "Out / T2 free-run", "Out / T2", "Out / PHI2", "Out / CB1" };
+        DrawBinary("SR  ", m_via->peek(10));
+        ImGui::Text("Mode %d: %s  (%d bits%s)", m_via->sr_mode(), sr_modes[m_via->sr_mode()], m_via->sr_bits(),
+                    m_via->sr_busy() ? ", shifting" : "");
+
         ImGui::Separator();
         
         // Interrupt Flags
@@ -459,9 +614,10 @@ void DebugView::draw_acia_window() {
     
     if (m_acia) {
         // W65C51 Registers: 0=Data, 1=Status, 2=Command, 3=Control
-        u8 status = m_acia->read(1); // Read status (Note: might clear IRQs in some emus)
-        u8 cmd    = m_acia->read(2);
-        u8 ctrl   = m_acia->read(3);
+        // peek: a real status read would clear the IRQ flag every frame
+        u8 status = m_acia->peek(1);
+        u8 cmd    = m_acia->peek(2);
+        u8 ctrl   = m_acia->peek(3);
 
         ImGui::Text("Status:  %02X", status);
         ImGui::Text("Command: %02X", cmd);
@@ -473,9 +629,113 @@ void DebugView::draw_acia_window() {
         if (status & 0x80) ImGui::TextColored(ImVec4(1,0,0,1), "IRQ Active");
         if (status & 0x10) ImGui::Text("Tx Empty");
         if (status & 0x08) ImGui::TextColored(ImVec4(0,1,0,1), "Rx Full (Data Available)");
+        if (status & 0x04) ImGui::TextColored(ImVec4(1,0.5f,0,1), "Overrun");
         
         ImGui::Separator();
-        ImGui::TextDisabled("(Serial Terminal not implemented yet)");
+
+        // Line timing: a character per frame time at the programmed rate, or none
+        bool turbo = m_driver->serial_turbo();
+        if (ImGui::Checkbox("Turbo", &turbo)) m_driver->set_serial_turbo(turbo);
+        ImGui::SameLine();
+        if (turbo) ImGui::TextDisabled("(baud rate ignored)");
+        else       ImGui::TextDisabled("(%u cycles/char)", m_acia->char_cycles(m_cpu->clock()));
+
+        // Serial Terminal: what the firmware sent (a lone CR starts a new line)
+        const std::string& console = m_driver->serial_console();
+        std::string text;
+        text.reserve(console.size());
+        for (size_t i = 0; i < console.size(); i++) {
+            char c = console[i];
+            if (c == '\r') {
+                if (i + 1 < console.size() && console[i + 1] == '\n') continue;
+                c = '\n';
+            }
+            text += c;
+        }
+        ImGui::BeginChild("SerialTerminal", ImVec2(0, -ImGui::GetFrameHeightWithSpacing()), true);
+        ImGui::TextUnformatted(text.c_str());
+        if (ImGui::GetScrollY() >= ImGui::GetScrollMaxY())
+            ImGui::SetScrollHereY(1.0f);
+        ImGui::EndChild();
+
+        // Enter sends the line with a CR, like a terminal would
+        if (ImGui::InputText("Send", m_serial_input, sizeof(m_serial_input), ImGuiInputTextFlags_EnterReturnsTrue)) {
+            m_driver->serial_type(std::string(m_serial_input) + "\r");
+            m_serial_input[0] = '\0';
+            ImGui::SetKeyboardFocusHere(-1);
+        }
+    }
+    ImGui::End();
+}
+
+// ============================================================================
+//  PS/2 Keyboard Window
+// ============================================================================
+//  WHAT: While the window has focus, host keys go to the emulated keyboard
+//        as set 2 make/break codes; held keys repeat at the host's rate
+//        (like typematic). The "Type" line sends whole strings instead.
+// ============================================================================
+static const struct { ImGuiKey key; u16 code; } s_ps2_keys[] = {
+    { ImGuiKey_A, 0x1C }, { ImGuiKey_B, 0x32 }, { ImGuiKey_C, 0x21 }, { ImGuiKey_D, 0x23 },
+    { ImGuiKey_E, 0x24 }, { ImGuiKey_F, 0x2B }, { ImGuiKey_G, 0x34 }, { ImGuiKey_H, 0x33 },
+    { ImGuiKey_I, 0x43 }, { ImGuiKey_J, 0x3B }, { ImGuiKey_K, 0x42 }, { ImGuiKey_L, 0x4B },
+    { ImGuiKey_M, 0x3A }, { ImGuiKey_N, 0x31 }, { ImGuiKey_O, 0x44 }, { ImGuiKey_P, 0x4D },
+    { ImGuiKey_Q, 0x15 }, { ImGuiKey_R, 0x2D }, { ImGuiKey_S, 0x1B }, { ImGuiKey_T, 0x2C },
+    { ImGuiKey_U, 0x3C }, { ImGuiKey_V, 0x2A }, { ImGuiKey_W, 0x1D }, { ImGuiKey_X, 0x22 },
+    { ImGuiKey_Y, 0x35 }, { ImGuiKey_Z, 0x1A },
+    { ImGuiKey_0, 0x45 }, { ImGuiKey_1, 0x16 }, { ImGuiKey_2, 0x1E }, { ImGuiKey_3, 0x26 },
+    { ImGuiKey_4, 0x25 }, { ImGuiKey_5, 0x2E }, { ImGuiKey_6, 0x36 }, { ImGuiKey_7, 0x3D },
+    { ImGuiKey_8, 0x3E }, { ImGuiKey_9, 0x46 },
+    { ImGuiKey_GraveAccent, 0x0E }, { ImGuiKey_Minus, 0x4E }, { ImGuiKey_Equal, 0x55 },
+    { ImGuiKey_LeftBracket, 0x54 }, { ImGuiKey_RightBracket, 0x5B }, { ImGuiKey_Backslash, 0x5D },
+    { ImGuiKey_Semicolon, 0x4C }, { ImGuiKey_Apostrophe, 0x52 }, { ImGuiKey_Comma, 0x41 },
+    { ImGuiKey_Period, 0x49 }, { ImGuiKey_Slash, 0x4A },
+    { ImGuiKey_Space, ps2_keyboard::KEY_SPACE }, { ImGuiKey_Enter, ps2_keyboard::KEY_ENTER },
+    { ImGuiKey_Backspace, ps2_keyboard::KEY_BACKSPACE }, { ImGuiKey_Tab, ps2_keyboard::KEY_TAB },
+    { ImGuiKey_Escape, ps2_keyboard::KEY_ESC }, { ImGuiKey_CapsLock, ps2_keyboard::KEY_CAPS },
+    { ImGuiKey_LeftShift, ps2_keyboard::KEY_LSHIFT }, { ImGuiKey_RightShift, ps2_keyboard::KEY_RSHIFT },
+    { ImGuiKey_LeftCtrl, ps2_keyboard::KEY_LCTRL }, { ImGuiKey_LeftAlt, ps2_keyboard::KEY_LALT },
+    { ImGuiKey_RightCtrl, ps2_keyboard::EXTENDED | 0x14 }, { ImGuiKey_RightAlt, ps2_keyboard::EXTENDED | 0x11 },
+    { ImGuiKey_F1, 0x05 }, { ImGuiKey_F2, 0x06 }, { ImGuiKey_F3, 0x04 }, { ImGuiKey_F4, 0x0C },
+    { ImGuiKey_F5, 0x03 }, { ImGuiKey_F6, 0x0B }, { ImGuiKey_F7, 0x83 }, { ImGuiKey_F8, 0x0A },
+    { ImGuiKey_F9, 0x01 }, { ImGuiKey_F10, 0x09 }, { ImGuiKey_F11, 0x78 }, { ImGuiKey_F12, 0x07 },
+    { ImGuiKey_UpArrow, ps2_keyboard::KEY_UP }, { ImGuiKey_DownArrow, ps2_keyboard::KEY_DOWN },
+    { ImGuiKey_LeftArrow, ps2_keyboard::KEY_LEFT }, { ImGuiKey_RightArrow, ps2_keyboard::KEY_RIGHT },
+    { ImGuiKey_Home, ps2_keyboard::EXTENDED | 0x6C }, { ImGuiKey_End, ps2_keyboard::EXTENDED | 0x69 },
+    { ImGuiKey_PageUp, ps2_keyboard::EXTENDED | 0x7D }, { ImGuiKey_PageDown, ps2_keyboard::EXTENDED | 0x7A },
+    { ImGuiKey_Insert, ps2_keyboard::EXTENDED | 0x70 }, { ImGuiKey_Delete, ps2_keyboard::EXTENDED | 0x71 },
+};
+
+void DebugView::draw_keyboard_window() {
+    if (!ImGui::Begin("PS/2 Keyboard", &m_show_keyboard)) {
+        ImGui::End();
+        return;
+    }
+
+    const ps2_keyboard& kbd = m_driver->get_keyboard();
+    if (m_driver->get_machine_type() != MachineType::SCHEMATIC_3_KEYBOARD) {
+        ImGui::TextColored(ImVec4(1,1,0,1), "Not fitted: select Schematic 3 (Keyboard).");
+    }
+    ImGui::Text("Last byte: %02X   Sent: %llu", kbd.last_byte(), (unsigned long long)kbd.bytes_sent());
+    ImGui::Text("Buffer:    %d / %d", ps2_keyboard::QUEUE_SIZE - kbd.space(), ps2_keyboard::QUEUE_SIZE);
+    ImGui::Separator();
+
+    // Live keys: only while this window (and not the text box) has focus
+    if (ImGui::IsWindowFocused() && !ImGui::GetIO().WantTextInput) {
+        ImGui::TextColored(ImVec4(0,1,0,1), "Capturing keys");
+        for (const auto& k : s_ps2_keys) {
+            if (ImGui::IsKeyPressed(k.key, true)) m_driver->keyboard_key(k.code, true);
+            if (ImGui::IsKeyReleased(k.key))      m_driver->keyboard_key(k.code, false);
+        }
+    } else {
+        ImGui::TextDisabled("Click here to capture keys");
+    }
+
+    // Enter types the line followed by Enter
+    if (ImGui::InputText("Type", m_kbd_input, sizeof(m_kbd_input), ImGuiInputTextFlags_EnterReturnsTrue)) {
+        m_driver->keyboard_type(std::string(m_kbd_input) + "\n");
+        m_kbd_input[0] = '\0';
+        ImGui::SetKeyboardFocusHere(-1);
     }
     ImGui::End();
 }
@@ -505,6 +765,15 @@ void DebugView::draw_memory_window() {
             }   
         }
 
+        // Another window (e.g. Memory Search) asked us to show an address
+        if (m_mem_goto >= 0) {
+            const u16 target = (u16)m_mem_goto;
+            jump_addr = target;
+            snprintf(addr_buf, sizeof(addr_buf), "%04X", (unsigned)target);
+            trigger_scroll = true;
+            m_mem_goto = -1;
+        }
+
         ImGui::Separator();
 
         // Hex Dump Table
@@ -520,10 +789,22 @@ void DebugView::draw_memory_window() {
             trigger_scroll = false; // Reset flag
         }
 
+        // One side-effect free snapshot per frame; reading $9000 here
+        // won't trigger your "BOOM" trap.
+        const u8* mem = memory_snapshot();
+
+        // Recently changed RAM bytes glow red and fade out
+        ram_62256* ram = m_driver->get_ram();
+        const u64 now = m_cpu->total_cycles();
+        int first_row = 0x1000, last_row = -1;
+
         ImGuiListClipper clipper;
-        clipper.Begin(0x1000); // 4096 rows of 16 bytes = 64KB total
+        clipper.Begin(0x1000, ImGui::GetTextLineHeightWithSpacing()); // 4096 rows of 16 bytes = 64KB total
 
         while (clipper.Step()) {
+            if (clipper.DisplayStart < first_row) first_row = clipper.DisplayStart;
+            if (clipper.DisplayEnd - 1 > last_row) last_row = clipper.DisplayEnd - 1;
+
             for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
                 u16 base_addr = row * 16;
                 
@@ -534,14 +815,15 @@ void DebugView::draw_memory_window() {
                 for (int col = 0; col < 16; col++) {
                     ImGui::SameLine();
                     u16 addr = base_addr + col;
-                    
-                    // === THE CRITICAL PART ===
-                    // We use debug_peek() here. 
-                    // This ensures reading $9000 won't trigger your "BOOM" trap.
-                    u8 val = m_cpu->debug_peek(addr);
+                    u8 val = mem[addr];
 
+                    u64 changed = (addr < 0x4000) ? ram->last_write_cycle(addr) : 0;
+                    if (changed && now - changed < CHANGE_HIGHLIGHT_CYCLES) {
+                        float fade = (float)(now - changed) / (float)CHANGE_HIGHLIGHT_CYCLES;
+                        ImGui::TextColored(ImVec4(1.0f, 0.3f + 0.7f * fade, 0.3f + 0.7f * fade, 1), "%02X", val);
+                    }
                     // Color code zero vs non-zero for readability
-                    if (val == 0) 
+                    else if (val == 0) 
                         ImGui::TextDisabled("00");
                     else 
                         ImGui::Text("%02X", val);
@@ -552,8 +834,7 @@ void DebugView::draw_memory_window() {
                 ImGui::Text(" | ");
                 for (int col = 0; col < 16; col++) {
                     ImGui::SameLine();
-                    u16 addr = base_addr + col;
-                    u8 val = m_cpu->debug_peek(addr);
+                    u8 val = mem[base_addr + col];
                     
                     // Only draw printable chars
                     if (val >= 32 && val < 127) 
@@ -564,83 +845,160 @@ void DebugView::draw_memory_window() {
             }
         }
         ImGui::EndChild();
+
+        // Only the RAM pages on screen pay for change timestamps
+        observe_ram_pages(first_row >> 4, last_row >> 4);
     }
     ImGui::End();
 }
 
+// WHAT: Moves the RAM's observed window to pages [first, last] (clipped to
+//       the $0000-$3FFF RAM). first > last stops observing.
+void DebugView::observe_ram_pages(int first, int last) {
+    if (last > 0x3F) last = 0x3F;
+    if (first == m_ram_obs_first && last == m_ram_obs_last) return;
+
+    ram_62256* ram = m_driver->get_ram();
+    for (int p = m_ram_obs_first; p >= 0 && p <= m_ram_obs_last; p++) {
+        if (p < first || p > last) ram->observe_page((u8)p, false);
+    }
+    for (int p = first; p <= last; p++) ram->observe_page((u8)p, true);
+
+    m_ram_obs_first = (first <= last) ? first : -1;
+    m_ram_obs_last  = (first <= last) ? last  : -1;
+}
+
 // ============================================================================
 //  2. LCD Window (Visualizing U3)
 // ============================================================================
+// ============================================================================
+// LCD Glyph Atlas
+// ============================================================================
+//  WHAT: Rasterizes one 5x8 pattern in the LCD look: lit dots, dimmed unlit
+//        dots and transparent gaps (the panel colour shows through).
+// ============================================================================
+static void render_lcd_glyph(const uint8_t* pattern, uint32_t* out, int stride) {
+    const uint32_t lit   = IM_COL32(30, 40, 10, 255);       // Lit pixel (Dark)
+    const uint32_t unlit = IM_COL32(140, 190, 45, 100);     // Unlit pixel (Slightly darker than BG)
+
+    for (int ty = 0; ty < 8 * 4; ty++) {
+        for (int tx = 0; tx < 5 * 4; tx++) {
+            uint32_t c = 0;
+            if ((tx & 3) != 3 && (ty & 3) != 3) {
+                // Bit 4 is the leftmost dot
+                c = ((pattern[ty >> 2] >> (4 - (tx >> 2))) & 1) ? lit : unlit;
+            }
+            out[ty * stride + tx] = c;
+        }
+    }
+}
+
+void DebugView::build_lcd_atlas() {
+    static_assert(LCD_PITCH == 4, "render_lcd_glyph assumes 3+1 texel dots");
+    static_assert((LCD_CURSOR_SLOT / LCD_ATLAS_COLS + 1) * LCD_GLYPH_H <= LCD_ATLAS_SIZE, "LCD atlas too small");
+
+    std::vector<uint32_t> pixels(LCD_ATLAS_SIZE * LCD_ATLAS_SIZE, 0);
+    std::memcpy(m_lcd_cgram, m_lcd->get_cgram(), sizeof(m_lcd_cgram));
+
+    static const uint8_t block[8] = { 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F };
+    for (int slot = 0; slot <= LCD_CURSOR_SLOT; slot++) {
+        const uint8_t* pattern = (slot == LCD_CURSOR_SLOT) ? block
+                               : (slot < 8) ? &m_lcd_cgram[slot * 8]
+                               : nhd_0216k1z::CGROM_A00[slot];
+        int x = (slot % LCD_ATLAS_COLS) * LCD_GLYPH_W;
+        int y = (slot / LCD_ATLAS_COLS) * LCD_GLYPH_H;
+        render_lcd_glyph(pattern, &pixels[y * LCD_ATLAS_SIZE + x], LCD_ATLAS_SIZE);
+    }
+
+    GLuint tex = 0;
+    glGenTextures(1, &tex);
+    glBindTexture(GL_TEXTURE_2D, tex);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, LCD_ATLAS_SIZE, LCD_ATLAS_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    m_lcd_atlas = tex;
+}
+
+// WHAT: Re-uploads the custom characters the firmware redefined since the
+//       last frame (usually none: one 64-byte compare).
+void DebugView::update_lcd_cgram() {
+    const uint8_t* cgram = m_lcd->get_cgram();
+    if (std::memcmp(cgram, m_lcd_cgram, sizeof(m_lcd_cgram)) == 0) return;
+
+    uint32_t glyph[LCD_GLYPH_W * LCD_GLYPH_H];
+    glBindTexture(GL_TEXTURE_2D, m_lcd_atlas);
+    for (int slot = 0; slot < 8; slot++) {
+        if (std::memcmp(cgram + slot * 8, m_lcd_cgram + slot * 8, 8) == 0) continue;
+        render_lcd_glyph(cgram + slot * 8, glyph, LCD_GLYPH_W);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, (slot % LCD_ATLAS_COLS) * LCD_GLYPH_W, (slot / LCD_ATLAS_COLS) * LCD_GLYPH_H,
+                        LCD_GLYPH_W, LCD_GLYPH_H, GL_RGBA, GL_UNSIGNED_BYTE, glyph);
+    }
+    std::memcpy(m_lcd_cgram, cgram, sizeof(m_lcd_cgram));
+}
+
+// ============================================================================
+// LCD Window
+// ============================================================================
+//  HOW:  One panel rectangle, one textured quad per character from the
+//        glyph atlas, and one more quad for the cursor.
+// ============================================================================
 void DebugView::draw_lcd_window() {
     ImGui::Begin("LCD Display (U3) - Pixel Perfect");
 
+    if (!m_lcd_atlas) build_lcd_atlas();
+    else              update_lcd_cgram();
+
     // Setup Canvas
     ImDrawList* drawList = ImGui::GetWindowDrawList();
     ImVec2 startPos = ImGui::GetCursorScreenPos();
 
-    // Pixel Tuning Parameters
-    float pixelSize = 3.0f;     // Size of each LCD "dot"
-    float pixelGap  = 1.0f;     // Space between dots
-    float charGap   = 4.0f;     // Space between 5x8 characters
-
-    // LCD Colors (Datasheet-accurate)
-    ImU32 colorBg    = IM_COL32(153, 204, 51, 255);  // Yellow-Green background
-    ImU32 colorPixel = IM_COL32(30, 40, 10, 255);    // Lit pixel (Dark)
-    ImU32 colorDim   = IM_COL32(140, 190, 45, 100);  // Unlit pixel (Slightly darker than BG)
-
-    // 3. Draw the LCD Background Panel
-    float totalW = (16 * (5 * (pixelSize + pixelGap) + charGap));
-    float totalH = (2 * (8 * (pixelSize + pixelGap) + charGap));
+    const float charGap = 4.0f;     // Space between 5x8 characters
+    const float cellW = LCD_GLYPH_W + charGap;
+    const float cellH = LCD_GLYPH_H + charGap;
+    const ImTextureID atlas = (ImTextureID)m_lcd_atlas;
+
+    auto glyph_uv = [](int slot, ImVec2& uv0, ImVec2& uv1) {
+        uv0 = ImVec2((float)((slot % LCD_ATLAS_COLS) * LCD_GLYPH_W) / LCD_ATLAS_SIZE,
+                     (float)((slot / LCD_ATLAS_COLS) * LCD_GLYPH_H) / LCD_ATLAS_SIZE);
+        uv1 = ImVec2(uv0.x + (float)LCD_GLYPH_W / LCD_ATLAS_SIZE, uv0.y + (float)LCD_GLYPH_H / LCD_ATLAS_SIZE);
+    };
+
+    // Draw the LCD Background Panel
+    ImU32 colorBg = IM_COL32(153, 204, 51, 255);  // Yellow-Green background
+    float totalW = 16 * cellW;
+    float totalH = 2 * cellH;
     drawList->AddRectFilled(startPos, ImVec2(startPos.x + totalW, startPos.y + totalH), colorBg);
 
-    // 4. Render 2 Rows of 16 Characters
+    // Render 2 Rows of 16 Characters
+    const uint8_t* ddram = m_lcd->get_ddram();
     for (int row = 0; row < 2; row++) {
         for (int col = 0; col < 16; col++) {
-            
-            // Get DDRAM address and character code
-            uint8_t addr = (row == 0) ? (0x00 + col) : (0x40 + col);
-            uint8_t charCode = m_lcd->get_ddram()[addr];
-            uint8_t cursorAC = m_lcd->get_cursor_addr();
-
-            // Fetch bit pattern (Check if CGRAM or CGROM)
-            const uint8_t* pattern;
-            if (charCode < 0x08) {
-                pattern = &m_lcd->get_cgram()[charCode * 8]; // User custom char
-            } else {
-                pattern = nhd_0216k1z::CGROM_A00[charCode];   // Standard ROM char
-            }
-
-            // Draw the 5x8 Matrix for this character
-            for (int y = 0; y < 8; y++) {
-                uint8_t rowBits = pattern[y];
-
-                // Handle Cursor Logic (Blinking or Underscore)
-                bool isCursorPos = (addr == cursorAC);
-                bool blinkOn = m_lcd->is_blink_on() && ((int)(ImGui::GetTime() * 2.0f) % 2 == 0);
-                
-                for (int x = 0; x < 5; x++) {
-                    // Check if pixel is lit (Bit 4 is the leftmost dot)
-                    bool bitLit = (rowBits >> (4 - x)) & 0x01;
-                    
-                    // Logic for Cursor: OR with the character pattern
-                    if (isCursorPos && m_lcd->is_cursor_on()) {
-                        if (m_lcd->is_blink_on()) {
-                            if (blinkOn) bitLit = true; // Full block blink
-                        } else if (y == 7) {
-                            bitLit = true; // Underscore on 8th line [cite: 19, 26]
-                        }
-                    }
-
-                    // Calculate screen position for this specific dot
-                    ImVec2 p1 = {
-                        startPos.x + (col * (5 * (pixelSize + pixelGap) + charGap)) + (x * (pixelSize + pixelGap)),
-                        startPos.y + (row * (8 * (pixelSize + pixelGap) + charGap)) + (y * (pixelSize + pixelGap))
-                    };
-                    ImVec2 p2 = { p1.x + pixelSize, p1.y + pixelSize };
+            uint8_t charCode = ddram[(row == 0 ? 0x00 : 0x40) + col];
+            ImVec2 uv0, uv1;
+            glyph_uv(charCode, uv0, uv1);
+            ImVec2 p1(startPos.x + col * cellW, startPos.y + row * cellH);
+            drawList->AddImage(atlas, p1, ImVec2(p1.x + LCD_GLYPH_W, p1.y + LCD_GLYPH_H), uv0, uv1);
+        }
+    }
 
-                    drawList->AddRectFilled(p1, p2, bitLit ? colorPixel : colorDim);
-                }
-            }
+    // Cursor: blinking full block, or an underscore on the 8th line
+    uint8_t cursorAC = m_lcd->get_cursor_addr();
+    int cursorCol = cursorAC & 0x3F;
+    if (m_lcd->is_cursor_on() && cursorCol < 16 && (cursorAC & 0x80) == 0) {
+        ImVec2 uv0, uv1;
+        glyph_uv(LCD_CURSOR_SLOT, uv0, uv1);
+        ImVec2 p1(startPos.x + cursorCol * cellW, startPos.y + ((cursorAC & 0x40) ? cellH : 0.0f));
+        ImVec2 p2(p1.x + LCD_GLYPH_W, p1.y + LCD_GLYPH_H);
+
+        if (m_lcd->is_blink_on()) {
+            bool blinkOn = ((int)(ImGui::GetTime() * 2.0f) % 2 == 0);
+            if (blinkOn) drawList->AddImage(atlas, p1, p2, uv0, uv1);
+        } else {
+            // Only the last dot row of the block
+            float rowTop = 7.0f * LCD_PITCH;
+            uv0.y += rowTop / LCD_ATLAS_SIZE;
+            p1.y += rowTop;
+            drawList->AddImage(atlas, p1, p2, uv0, uv1);
         }
     }
 
@@ -678,6 +1036,509 @@ void DebugView::draw_speed_control() {
     ImGui::End();
 }
 
+// ============================================================================
+//  Disassembly Window
+// ============================================================================
+//  WHAT: Scrollable W65C02S listing of the whole address space.
+//  WHEN: Every frame if 'm_show_disasm' is true.
+//  WHY:  Decoding is cached in debug_disasm; only rows on screen are
+//        formatted and drawn. Clicking the left gutter toggles a breakpoint.
+// ============================================================================
+void DebugView::draw_disasm_window() {
+    if (!ImGui::Begin("Disassembly", &m_show_disasm)) {
+        ImGui::End();
+        return;
+    }
+    if (!m_cpu || !m_disasm) {
+        ImGui::TextColored(ImVec4(1, 0, 0, 1), "CPU Not Connected");
+        ImGui::End();
+        return;
+    }
+
+    m_disasm->update();
+    device_debug& dbg = m_cpu->debug();
+    const u16 pc = m_cpu->get_pc();
+
+    // --- Controls ---
+    ImGui::Checkbox("Follow PC", &m_disasm_follow_pc);
+    ImGui::SameLine();
+    static char goto_buf[64] = "";
+    ImGui::SetNextItemWidth(140);
+    if (ImGui::InputText("Go To", goto_buf, sizeof(goto_buf), ImGuiInputTextFlags_EnterReturnsTrue)) {
+        // A label, or a hex address
+        u16 target = 0;
+        if (!dbg.symbols().find(goto_buf, target)) {
+            target = (u16)strtoul(goto_buf[0] == '$' ? goto_buf + 1 : goto_buf, nullptr, 16);
+        }
+        m_disasm_follow_pc = false;
+        m_disasm_goto_row = m_disasm->row_of(target);
+    }
+
+    // --- Follow PC ---
+    if (m_disasm_follow_pc && pc != m_disasm_last_pc) {
+        m_disasm_last_pc = pc;
+        int row = m_disasm->row_of(pc);
+        if (m_disasm->line_address(row) != pc) {
+            // PC is in the middle of a decoded instruction: realign there
+            m_disasm->anchor(pc);
+            m_disasm->update();
+            row = m_disasm->row_of(pc);
+        }
+        m_disasm_goto_row = row;
+    }
+
+    ImGui::Separator();
+    ImGui::BeginChild("DisasmScrolling");
+
+    const float line_height = ImGui::GetTextLineHeightWithSpacing();
+    if (m_disasm_goto_row >= 0) {
+        // Scroll only if the row is off screen (keeps the view steady while stepping)
+        float y = m_disasm_goto_row * line_height;
+        float top = ImGui::GetScrollY();
+        float height = ImGui::GetWindowHeight();
+        if (y < top || y > top + height - 2 * line_height) {
+            ImGui::SetScrollY(y - height * 0.33f);
+        }
+        m_disasm_goto_row = -1;
+    }
+
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    ImGuiListClipper clipper;
+    clipper.Begin(m_disasm->line_count(), line_height);
+
+    while (clipper.Step()) {
+        for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+            const u16 addr = m_disasm->line_address(row);
+            const bool has_bp = dbg.breakpoint_at(addr);
+
+            ImGui::PushID(row);
+
+            // Gutter: click to toggle a breakpoint
+            ImVec2 pos = ImGui::GetCursorScreenPos();
+            if (ImGui::InvisibleButton("##bp", ImVec2(line_height, line_height))) {
+                if (has_bp) dbg.breakpoint_clear_address(addr);
+                else        dbg.breakpoint_set(addr);
+            }
+            if (has_bp) {
+                draw_list->AddCircleFilled(ImVec2(pos.x + line_height * 0.5f, pos.y + line_height * 0.5f),
+                                           line_height * 0.3f, IM_COL32(220, 40, 40, 255));
+            }
+            ImGui::SameLine();
+
+            // Listing
+            const std::string& text = m_disasm->line_text(row);
+            if (addr == pc) ImGui::TextColored(ImVec4(1, 1, 0, 1), "> %s", text.c_str());
+            else            ImGui::Text("  %s", text.c_str());
+
+            ImGui::PopID();
+        }
+    }
+    ImGui::EndChild();
+    ImGui::End();
+}
+
+// ============================================================================
+//  Memory Heatmap Window
+// ============================================================================
+//  WHAT: 256x256 picture of the address space ($XX00 rows, $00XX columns).
+//        Red = writes, green = executes, blue = reads.
+//  WHEN: Every frame if 'm_show_heatmap' is true.
+//  WHY:  Hot zero-page variables, stack depth and busy ROM routines show up
+//        immediately. Counts fade each frame so the image tracks the present.
+// ============================================================================
+void DebugView::set_heatmap_enabled(bool enabled) {
+    if (!m_cpu) return;
+
+    if (enabled) {
+        m_heatmap = std::make_unique<debug_heatmap>();
+        m_heat_pixels.assign(0x10000, 0);
+        m_cpu->debug().attach_heatmap(m_heatmap.get());
+    } else {
+        m_cpu->debug().attach_heatmap(nullptr);
+        m_heatmap.reset();
+        m_heat_pixels.clear();
+        m_heat_pixels.shrink_to_fit();
+        if (m_heat_texture) {
+            GLuint tex = m_heat_texture;
+            glDeleteTextures(1, &tex);
+            m_heat_texture = 0;
+        }
+    }
+}
+
+void DebugView::draw_heatmap_window() {
+    if (!ImGui::Begin("Memory Heatmap", &m_show_heatmap) || !m_heatmap) {
+        ImGui::End();
+        return;
+    }
+
+    // --- Controls ---
+    ImGui::SetNextItemWidth(120);
+    ImGui::SliderInt("Fade", &m_heat_fade, 1, 8, m_heat_fade <= 2 ? "fast" : (m_heat_fade >= 6 ? "slow" : "%d"));
+    ImGui::SameLine();
+    if (ImGui::Button("Clear")) m_heatmap->clear();
+    ImGui::SameLine();
+    ImGui::TextColored(ImVec4(1, 0.3f, 0.3f, 1), "Write");
+    ImGui::SameLine();
+    ImGui::TextColored(ImVec4(0.3f, 1, 0.3f, 1), "Exec");
+    ImGui::SameLine();
+    ImGui::TextColored(ImVec4(0.4f, 0.6f, 1, 1), "Read");
+
+    // --- Texture Upload ---
+    // Render what was counted since the last frame, then let it fade.
+    m_heatmap->render(m_heat_pixels.data());
+    m_heatmap->decay(m_heat_fade);
+
+    if (!m_heat_texture) {
+        GLuint tex = 0;
+        glGenTextures(1, &tex);
+        glBindTexture(GL_TEXTURE_2D, tex);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 256, 256, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_heat_pixels.data());
+        m_heat_texture = tex;
+    } else {
+        glBindTexture(GL_TEXTURE_2D, m_heat_texture);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 256, 256, GL_RGBA, GL_UNSIGNED_BYTE, m_heat_pixels.data());
+    }
+
+    // --- Image (square, fills the window) ---
+    ImVec2 avail = ImGui::GetContentRegionAvail();
+    float side = avail.x < avail.y ? avail.x : avail.y;
+    if (side < 256.0f) side = 256.0f;
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    ImGui::Image((ImTextureID)m_heat_texture, ImVec2(side, side));
+
+    // --- Tooltip: address, label and counts under the mouse ---
+    if (ImGui::IsItemHovered()) {
+        ImVec2 mouse = ImGui::GetIO().MousePos;
+        int col = (int)((mouse.x - origin.x) * 256.0f / side);
+        int row = (int)((mouse.y - origin.y) * 256.0f / side);
+        if (col >= 0 && col < 256 && row >= 0 && row < 256) {
+            u16 addr = (u16)((row << 8) | col);
+            char label[48] = "";
+            m_cpu->debug().symbols().format(addr, label, sizeof(label), 0x100);
+            ImGui::BeginTooltip();
+            ImGui::Text("$%04X %s", addr, label);
+            ImGui::Text("R %u  W %u  X %u",
+                        m_heatmap->count(debug_heatmap::READ, addr),
+                        m_heatmap->count(debug_heatmap::WRITE, addr),
+                        m_heatmap->count(debug_heatmap::EXECUTE, addr));
+            ImGui::EndTooltip();
+        }
+    }
+    ImGui::End();
+}
+
+// ============================================================================
+//  Memory Search Window
+// ============================================================================
+//  WHAT: "Find" looks for a byte pattern; "Scan" narrows a set of candidate
+//        addresses each time you press Narrow (run the program in between).
+//  WHEN: Every frame if 'm_show_search' is true.
+//  WHY:  Finding where the firmware keeps a counter or buffer. Both work on
+//        the frame's memory snapshot; clicking a result shows it in the
+//        Memory Dump.
+// ============================================================================
+void DebugView::draw_search_window() {
+    if (!ImGui::Begin("Memory Search", &m_show_search)) {
+        ImGui::End();
+        return;
+    }
+    if (!m_cpu) {
+        ImGui::TextColored(ImVec4(1, 0, 0, 1), "CPU Not Connected");
+        ImGui::End();
+        return;
+    }
+    if (!m_find)    m_find = std::make_unique<memory_find>();
+    if (!m_scanner) m_scanner = std::make_unique<memory_scanner>();
+
+    const symbol_table& syms = m_cpu->debug().symbols();
+    static constexpr size_t MAX_LISTED = 256;
+
+    auto result_row = [&](u16 addr, const char* extra) {
+        char label[48] = "";
+        syms.format(addr, label, sizeof(label), 0x100);
+        char text[96];
+        snprintf(text, sizeof(text), "%04X  %-20s %s", addr, label, extra);
+        if (ImGui::Selectable(text)) {
+            m_mem_goto = addr;
+            m_show_ram = true;
+        }
+    };
+
+    // --- Find ---
+    if (ImGui::CollapsingHeader("Find Pattern", ImGuiTreeNodeFlags_DefaultOpen)) {
+        ImGui::SetNextItemWidth(220);
+        bool go = ImGui::InputText("##pattern", m_find_text, sizeof(m_find_text), ImGuiInputTextFlags_EnterReturnsTrue);
+        ImGui::SameLine();
+        go |= ImGui::Button("Find");
+        ImGui::TextDisabled("Hex bytes, ?? wildcards, \"text\"  e.g. A9 ?? 8D 00 60");
+
+        if (go) {
+            m_find_hits.clear();
+            m_find_error.clear();
+            if (m_find->parse(m_find_text, m_find_error)) {
+                m_find->find(memory_snapshot(), 0x0000, 0xFFFF, m_find_hits, MAX_LISTED);
+            }
+        }
+
+        if (!m_find_error.empty()) {
+            ImGui::TextColored(ImVec4(1, 0.3f, 0.3f, 1), "%s", m_find_error.c_str());
+        } else {
+            ImGui::Text("%zu match%s%s", m_find_hits.size(), m_find_hits.size() == 1 ? "" : "es",
+                        m_find_hits.size() >= MAX_LISTED ? " (list full)" : "");
+            ImGui::BeginChild("FindHits", ImVec2(0, 120), true);
+            for (u16 addr : m_find_hits) result_row(addr, "");
+            ImGui::EndChild();
+        }
+    }
+
+    // --- Scanner ---
+    if (ImGui::CollapsingHeader("Value Scanner", ImGuiTreeNodeFlags_DefaultOpen)) {
+        ImGui::SetNextItemWidth(50);
+        ImGui::InputText("##from", m_scan_start, sizeof(m_scan_start), ImGuiInputTextFlags_CharsHexadecimal);
+        ImGui::SameLine();
+        ImGui::Text("-");
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(50);
+        ImGui::InputText("##to", m_scan_end, sizeof(m_scan_end), ImGuiInputTextFlags_CharsHexadecimal);
+        ImGui::SameLine();
+        if (ImGui::Button("New Scan")) {
+            u16 from = (u16)strtoul(m_scan_start, nullptr, 16);
+            u16 to   = (u16)strtoul(m_scan_end, nullptr, 16);
+            if (to < from) { u16 t = from; from = to; to = t; }
+            m_scanner->start(memory_snapshot(), from, to);
+        }
+
+        static const char* conditions[] = {
+            "== value", "!= value", "> value", "< value",
+            "changed", "unchanged", "increased", "decreased"
+        };
+        ImGui::SetNextItemWidth(110);
+        ImGui::Combo("##cond", &m_scan_cond, conditions, IM_ARRAYSIZE(conditions));
+        if (m_scan_cond < memory_scanner::CHANGED) {
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(40);
+            ImGui::InputText("##value", m_scan_value, sizeof(m_scan_value), ImGuiInputTextFlags_CharsHexadecimal);
+        }
+        ImGui::SameLine();
+        ImGui::BeginDisabled(!m_scanner->started());
+        if (ImGui::Button("Narrow")) {
+            m_scanner->narrow(memory_snapshot(), (memory_scanner::condition)m_scan_cond,
+                              (u8)strtoul(m_scan_value, nullptr, 16));
+        }
+        ImGui::EndDisabled();
+
+        if (!m_scanner->started()) {
+            ImGui::TextDisabled("Press New Scan, run the program, then Narrow.");
+        } else {
+            ImGui::Text("%zu candidate%s", m_scanner->count(), m_scanner->count() == 1 ? "" : "s");
+            std::vector<u16> hits;
+            m_scanner->results(hits, MAX_LISTED);
+            const u8* mem = memory_snapshot();
+            ImGui::BeginChild("ScanHits", ImVec2(0, 0), true);
+            for (u16 addr : hits) {
+                char values[32];
+                snprintf(values, sizeof(values), "%02X (was %02X)", mem[addr], m_scanner->previous(addr));
+                result_row(addr, values);
+            }
+            ImGui::EndChild();
+        }
+    }
+    ImGui::End();
+}
+
+// ============================================================================
+//  Snapshot Diff Window
+// ============================================================================
+//  WHAT: Compares the live board (CPU, RAM, ROM, VIA, ACIA) with a reference
+//        snapshot taken here or loaded from a file (--save-snapshot).
+//  WHEN: Every frame if 'm_show_diff' is true.
+//  WHY:  "What did that routine change?" Take a snapshot, step or run, and
+//        the changed ranges are listed with old and new bytes.
+// ============================================================================
+void DebugView::draw_diff_window() {
+    if (!ImGui::Begin("Snapshot Diff", &m_show_diff)) {
+        ImGui::End();
+        return;
+    }
+    if (!m_snap_now) m_snap_now = std::make_unique<machine_snapshot>();
+    if (!m_diff)     m_diff = std::make_unique<snapshot_diff>();
+
+    // --- Reference ---
+    bool compare = false;
+    if (ImGui::Button("Take Snapshot")) {
+        if (!m_snap_ref) m_snap_ref = std::make_unique<machine_snapshot>();
+        m_driver->capture_snapshot(*m_snap_ref);
+        compare = true;
+    }
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(180);
+    ImGui::InputText("##snap_path", m_snap_path, sizeof(m_snap_path));
+    ImGui::SameLine();
+    if (ImGui::Button("Save")) {
+        m_driver->capture_snapshot(*m_snap_now);
+        if (m_snap_now->save(m_snap_path)) add_log(LOG_INFO, "[Snapshot] Saved %s", m_snap_path);
+        else                               add_log(LOG_ERROR, "[Snapshot] Could not save %s", m_snap_path);
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Load")) {
+        std::unique_ptr<machine_snapshot> loaded = std::make_unique<machine_snapshot>();
+        if (loaded->load(m_snap_path)) {
+            m_snap_ref = std::move(loaded);
+            compare = true;
+            add_log(LOG_INFO, "[Snapshot] Loaded %s", m_snap_path);
+        } else {
+            add_log(LOG_ERROR, "[Snapshot] Could not load %s", m_snap_path);
+        }
+    }
+
+    if (!m_snap_ref) {
+        ImGui::TextDisabled("Take or load a snapshot to compare against.");
+        ImGui::End();
+        return;
+    }
+
+    ImGui::Checkbox("Live", &m_diff_live);
+    ImGui::SameLine();
+    compare |= ImGui::Button("Compare");
+    if (compare || m_diff_live) {
+        m_driver->capture_snapshot(*m_snap_now);
+        m_diff->compare(*m_snap_ref, *m_snap_now);
+    }
+
+    ImGui::Text("Reference cycle %llu, now %llu: %zu range%s, %u byte%s changed%s",
+                (unsigned long long)m_snap_ref->cycle, (unsigned long long)m_cpu->total_cycles(),
+                m_diff->ranges.size(), m_diff->ranges.size() == 1 ? "" : "s",
+                m_diff->total_bytes, m_diff->total_bytes == 1 ? "" : "s",
+                m_diff->truncated ? " (list truncated)" : "");
+    ImGui::Separator();
+
+    // --- Changed Ranges (click a memory range to show it in the dump) ---
+    int block_count = 0;
+    const machine_snapshot::block* blocks = machine_snapshot::blocks(block_count);
+    ImGui::BeginChild("DiffRanges");
+    ImGuiListClipper clipper;
+    clipper.Begin((int)m_diff->ranges.size());
+    while (clipper.Step()) {
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+            const diff_range& r = m_diff->ranges[i];
+            std::string text = m_diff->format_range(r);
+            ImGui::PushID(i);
+            if (ImGui::Selectable(text.c_str()) && r.block != 0) {
+                m_mem_goto = blocks[r.block].base + r.offset;
+                m_show_ram = true;
+            }
+            ImGui::PopID();
+        }
+    }
+    ImGui::EndChild();
+    ImGui::End();
+}
+
+// ============================================================================
+//  Breakpoint Window
+// ============================================================================
+//  WHAT: Lists and edits the CPU's breakpoints and watchpoints.
+//  WHEN: Every frame if 'm_show_breakpoints' is true.
+//  WHY:  The hit test itself lives in device_debug; this is only the editor.
+// ============================================================================
+void DebugView::draw_breakpoint_window() {
+    if (!ImGui::Begin("Breakpoints", &m_show_breakpoints)) {
+        ImGui::End();
+        return;
+    }
+    if (!m_cpu) {
+        ImGui::TextColored(ImVec4(1, 0, 0, 1), "CPU Not Connected");
+        ImGui::End();
+        return;
+    }
+
+    device_debug& dbg = m_cpu->debug();
+
+    // --- Execution Breakpoints ---
+    ImGui::Text("Execution");
+    ImGui::SetNextItemWidth(60);
+    ImGui::InputText("##bpaddr", m_bp_addr, sizeof(m_bp_addr), ImGuiInputTextFlags_CharsHexadecimal);
+    ImGui::SameLine();
+    if (ImGui::Button(m_bp_action[0] ? "Add Tracepoint" : "Add Breakpoint")) {
+        u16 addr = (u16)strtoul(m_bp_addr, nullptr, 16);
+        if (!m_bp_cond[0] && !m_bp_action[0]) {
+            dbg.breakpoint_set(addr);
+        } else {
+            std::string err;
+            if (dbg.breakpoint_set(addr, m_bp_cond, m_bp_action, err) < 0) {
+                m_status_message = "Error: " + err;
+                m_status_timer = 8.0f;
+            }
+        }
+    }
+    ImGui::SetNextItemWidth(-80);
+    ImGui::InputText("Condition", m_bp_cond, sizeof(m_bp_cond));
+    ImGui::SetNextItemWidth(-80);
+    ImGui::InputText("Trace", m_bp_action, sizeof(m_bp_action));
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Log instead of stopping:  \"A=%%02X X=%%02X\", A, X");
+    }
+
+    int remove_bp = -1;
+    for (const auto& bp : dbg.breakpoints()) {
+        ImGui::PushID(bp.index);
+        bool enabled = bp.enabled;
+        if (ImGui::Checkbox("##en", &enabled)) dbg.breakpoint_enable(bp.index, enabled);
+        ImGui::SameLine();
+        ImGui::Text("#%d  $%04X  hits: %u", bp.index, bp.address, bp.hits);
+        if (!bp.condition.is_empty()) {
+            ImGui::SameLine();
+            ImGui::TextColored(ImVec4(1, 1, 0, 1), "if %s", bp.condition.text().c_str());
+        }
+        if (bp.trace) {
+            ImGui::SameLine();
+            ImGui::TextColored(ImVec4(0, 1, 1, 1), "trace %s", bp.action.c_str());
+        }
+        ImGui::SameLine();
+        if (ImGui::SmallButton("X")) remove_bp = bp.index;
+        ImGui::PopID();
+    }
+    if (remove_bp >= 0) dbg.breakpoint_clear(remove_bp);
+
+    ImGui::Separator();
+
+    // --- Memory Watchpoints ---
+    ImGui::Text("Memory");
+    ImGui::SetNextItemWidth(60);
+    ImGui::InputText("##wpstart", m_wp_start, sizeof(m_wp_start), ImGuiInputTextFlags_CharsHexadecimal);
+    ImGui::SameLine(); ImGui::Text("-"); ImGui::SameLine();
+    ImGui::SetNextItemWidth(60);
+    ImGui::InputText("##wpend", m_wp_end, sizeof(m_wp_end), ImGuiInputTextFlags_CharsHexadecimal);
+    ImGui::SameLine();
+    const char* types[] = { "", "Read", "Write", "R/W" };
+    ImGui::SetNextItemWidth(70);
+    ImGui::Combo("##wptype", &m_wp_type, types + 1, 3);
+    ImGui::SameLine();
+    if (ImGui::Button("Add Watchpoint")) {
+        dbg.watchpoint_set((u16)strtoul(m_wp_start, nullptr, 16),
+                           (u16)strtoul(m_wp_end, nullptr, 16),
+                           (u8)(m_wp_type + 1));
+    }
+
+    int remove_wp = -1;
+    for (const auto& wp : dbg.watchpoints()) {
+        ImGui::PushID(1000 + wp.index);
+        bool enabled = wp.enabled;
+        if (ImGui::Checkbox("##en", &enabled)) dbg.watchpoint_enable(wp.index, enabled);
+        ImGui::SameLine();
+        ImGui::Text("#%d  $%04X-$%04X  %-5s hits: %u", wp.index, wp.start, wp.end, types[wp.type & 3], wp.hits);
+        ImGui::SameLine();
+        if (ImGui::SmallButton("X")) remove_wp = wp.index;
+        ImGui::PopID();
+    }
+    if (remove_wp >= 0) dbg.watchpoint_clear(remove_wp);
+
+    ImGui::End();
+}
+
 void DebugView::draw_status_bar() {
     // Position at the very bottom of the viewport
     ImGuiViewport* viewport = ImGui::GetMainViewport();
@@ -6,6 +6,7 @@
 #include <string>
 #include <vector>
 #include <cstdarg>
+#include <memory>
 
 // ============================================================================
 // Forward Declarations
@@ -17,6 +18,12 @@ class w65c22;       // Placeholder for U5
 class w65c51;       // Placeholder for U7
 class mb_driver;    // Placeholder for your mainboard/driver
 class nhd_0216k1z;
+class debug_disasm;
+class debug_heatmap;
+class memory_find;
+class memory_scanner;
+struct machine_snapshot;
+struct snapshot_diff;
 
 enum LogType { LOG_INFO, LOG_CPU, LOG_IO, LOG_ERROR };
 
@@ -30,6 +37,7 @@ public:
     // Constructor: We pass pointers to hardware. 
     // If a device isn't ready, pass 'nullptr'.
     DebugView(mb_driver* driver);
+    ~DebugView();
 
     // Main Draw Loop (Called every frame by Renderer)
     void draw(bool& is_paused, bool& step_request);
@@ -52,6 +60,9 @@ private:
 
     // UI Buffers
     char m_rom_path[256] = "rom.bin";
+    char m_sym_path[256] = "rom.sym";
+    char m_serial_input[128] = "";     // ACIA terminal input line
+    char m_kbd_input[128] = "";        // PS/2 keyboard "Type" line
     char m_status_msg[128] = "System Ready";
     static std::vector<LogEntry> m_logs;
 
@@ -67,12 +78,95 @@ private:
     bool m_show_stack       = true;
     bool m_show_via         = false;
     bool m_show_acia        = false;
+    bool m_show_keyboard    = false;
     bool m_show_ram         = true;  // Generic Memory Viewer
     bool m_show_lcd         = true;
     bool m_show_rom         = false;
     bool m_show_speed       = false;
     bool m_show_status_bar  = true;
     bool m_show_log         = true;
+    bool m_show_breakpoints = false;
+    bool m_show_disasm      = true;
+    bool m_show_heatmap     = false;
+    bool m_show_search      = false;
+    bool m_show_diff        = false;
+
+    // --- Disassembly Window State ---
+    std::unique_ptr<debug_disasm> m_disasm;  // Cached listing of all 64K
+    bool m_disasm_follow_pc = true;
+    int  m_disasm_last_pc   = -1;            // To scroll only when PC moves
+    int  m_disasm_goto_row  = -1;            // Pending scroll target
+
+    // --- Memory Snapshot ---
+    // WHAT: Side-effect free copy of the full 64K space, taken once per frame.
+    // WHY:  The memory and stack views read every visible byte several
+    //       times; one bulk read (mostly memcpy) replaces thousands of
+    //       individual bus lookups.
+    uint8_t  m_mem[0x10000] = {};
+    uint32_t m_mem_gen[256] = {};     // ROM page generation each page was copied at
+    bool     m_mem_primed = false;    // First full copy done?
+    bool     m_mem_valid = false;     // Taken this frame?
+    const uint8_t* memory_snapshot();
+    int      m_mem_goto = -1;         // Address for the memory window to scroll to
+
+    // --- Memory Window Change Highlight ---
+    // Bytes written within this many CPU cycles are tinted (fades out).
+    static constexpr uint64_t CHANGE_HIGHLIGHT_CYCLES = 1000000;
+    int m_ram_obs_first = -1;         // RAM pages currently observed
+    int m_ram_obs_last  = -1;
+    void observe_ram_pages(int first, int last);
+
+    // --- Heatmap Window State ---
+    // Only exists while the window is open; the bus counts nothing otherwise.
+    std::unique_ptr<debug_heatmap> m_heatmap;
+    std::vector<uint32_t> m_heat_pixels;     // 256x256 RGBA
+    unsigned int m_heat_texture = 0;         // OpenGL texture name
+    int  m_heat_fade = 3;                    // Decay shift: higher = slower fade
+    void set_heatmap_enabled(bool enabled);
+
+    // --- LCD Glyph Atlas ---
+    // WHAT: Every character pattern prerendered (dots, gaps and unlit dots)
+    //       into one texture, so the LCD is 32 textured quads per frame.
+    // HOW:  Slots 0-255 are the character codes (0-7 hold CGRAM and are
+    //       re-uploaded only when it changes); slot 256 is the solid block
+    //       used as the cursor overlay.
+    static constexpr int LCD_DOT        = 3;                  // Lit dot, in texels (= screen pixels)
+    static constexpr int LCD_PITCH      = LCD_DOT + 1;        // Dot + gap
+    static constexpr int LCD_GLYPH_W    = 5 * LCD_PITCH;
+    static constexpr int LCD_GLYPH_H    = 8 * LCD_PITCH;
+    static constexpr int LCD_ATLAS_COLS = 25;
+    static constexpr int LCD_ATLAS_SIZE = 512;                // Square, power of two
+    static constexpr int LCD_CURSOR_SLOT = 256;
+    unsigned int m_lcd_atlas = 0;                             // OpenGL texture name
+    uint8_t      m_lcd_cgram[0x40] = {};                      // CGRAM as last uploaded
+    void build_lcd_atlas();
+    void update_lcd_cgram();
+
+    // --- Memory Search Window State ---
+    std::unique_ptr<memory_find>    m_find;
+    std::unique_ptr<memory_scanner> m_scanner;
+    std::vector<uint16_t> m_find_hits;
+    std::string m_find_error;
+    char m_find_text[128]  = "\"Hello\"";
+    char m_scan_start[8]   = "0000";
+    char m_scan_end[8]     = "3FFF";
+    char m_scan_value[8]   = "00";
+    int  m_scan_cond       = 0;       // memory_scanner::condition
+
+    // --- Snapshot Diff Window State ---
+    std::unique_ptr<machine_snapshot> m_snap_ref;    // Taken or loaded reference
+    std::unique_ptr<machine_snapshot> m_snap_now;    // Scratch copy of the live board
+    std::unique_ptr<snapshot_diff>    m_diff;
+    char m_snap_path[256] = "state.snap";
+    bool m_diff_live      = true;    // Re-compare every frame
+
+    // --- Breakpoint Window Buffers ---
+    char m_bp_addr[8]       = "8000";
+    char m_bp_cond[128]     = "";    // e.g. A == $41 && [$0200] > 3
+    char m_bp_action[256]   = "";    // e.g. "A=%02X", A   (tracepoint)
+    char m_wp_start[8]      = "0200";
+    char m_wp_end[8]        = "0200";
+    int  m_wp_type          = 1;     // Combo index: 0=Read 1=Write 2=R/W
 
     // --- Helper Functions ---
     void LaunchAssembler();
@@ -88,10 +182,19 @@ private:
     void draw_stack_smart();
     void draw_via_window();     // Skeleton
     void draw_acia_window();    // Skeleton
+    void draw_keyboard_window();
     void draw_memory_window();  // Skeleton
     void draw_lcd_window();
     void draw_rom_window();
     void draw_speed_control();
+    void draw_breakpoint_window();
+    void draw_disasm_window();
+    void draw_heatmap_window();
+    void draw_search_window();
+    void draw_diff_window();
+
+    // Loads <rom>.sym next to a ROM image if there is one
+    void load_companion_symbols(const char* rom_path);
 
     // Log window for viewing data
     void draw_log_window();
@@ -20,6 +20,11 @@ RS = 0x20
 # Memory Cursor (Start at $8000)
 pc = 0x8000
 
+# Symbol table (written to rom.sym for the emulator's debugger)
+symbols = {
+    "PORTB": PORTB, "PORTA": PORTA, "DDRB": DDRB, "DDRA": DDRA,
+}
+
 # =============================================================================
 # HELPER FUNCTIONS (The Assembler)
 # =============================================================================
@@ -29,6 +34,10 @@ def emit(byte):
         rom[pc - 0x8000] = byte
         pc += 1
 
+def label(name):
+    symbols[name] = pc
+    return pc
+
 def LDA_IMM(val): emit(0xA9); emit(val)
 def LDA_ABS(addr): emit(0xAD); emit(addr & 0xFF); emit(addr >> 8)
 def LDA_ABX(addr): emit(0xBD); emit(addr & 0xFF); emit(addr >> 8)
@@ -61,6 +70,7 @@ ADDR_DATA      = 0x8200
 # MAIN PROGRAM ($8000)
 # =============================================================================
 pc = 0x8000
+label("reset")
 
 # 1. Hardware Init
 LDX_IMM(0xFF); TXS()
@@ -90,7 +100,7 @@ JSR_ABS(ADDR_WAIT_50MS)
 
 # 5. Print Loop
 LDX_IMM(0x00)
-print_label = pc
+print_label = label("print_loop")
 
 LDA_ABX(ADDR_DATA)   # Load char
 BEQ(0x07)            # If 0, jump forward
@@ -100,7 +110,7 @@ INX()
 JMP_ABS(print_label)
 
 # Infinite Loop
-loop_label = pc
+loop_label = label("halt")
 JMP_ABS(loop_label)
 
 # =============================================================================
@@ -109,6 +119,7 @@ JMP_ABS(loop_label)
 
 # --- lcd_instruction ---
 pc = ADDR_LCD_INS
+label("lcd_instruction")
 JSR_ABS(ADDR_WAIT_1MS)
 STA_ABS(PORTB)
 LDA_IMM(0); STA_ABS(PORTA) # E=0
@@ -118,6 +129,7 @@ RTS()
 
 # --- print_char ---
 pc = ADDR_PRT_CHR
+label("print_char")
 JSR_ABS(ADDR_WAIT_1MS)
 STA_ABS(PORTB)
 LDA_IMM(RS);     STA_ABS(PORTA) # RS=1
@@ -128,10 +140,11 @@ RTS()
 # --- wait_1ms ---
 # Simple loop: 255 iterations
 pc = ADDR_WAIT_1MS
+label("wait_1ms")
 PHA(); TXA(); PHA()
 LDX_IMM(0xFF)
 # DEX
-wait_loop = pc
+wait_loop = label("wait_1ms_loop")
 emit(0xCA)
 # BNE wait_loop (-3 bytes)
 emit(0xD0); emit(0xFD)
@@ -141,14 +154,15 @@ RTS()
 # --- wait_50ms ---
 # Nested loop: 255 * 255 iterations
 pc = ADDR_WAIT_50MS
+label("wait_50ms")
 PHA(); TXA(); PHA()
 TYA(); PHA()
 
 LDY_IMM(0xFF) # Outer
-outer_loop = pc
+outer_loop = label("wait_50ms_outer")
 
 LDX_IMM(0xFF) # Inner
-inner_loop = pc
+inner_loop = label("wait_50ms_inner")
 
 emit(0xCA) # DEX
 # BNE inner_loop (-3 bytes)
@@ -165,6 +179,7 @@ RTS()
 # DATA
 # =============================================================================
 pc = ADDR_DATA
+label("message")
 msg = b"Hello, world!\x00"
 for b in msg:
     emit(b)
@@ -183,4 +198,9 @@ rom[0x7FFF - 0x8000] = 0x80
 with open("rom.bin", "wb") as f:
     f.write(rom)
 
+# Symbols: one "label = $addr" per line, loaded automatically next to rom.bin
+with open("rom.sym", "w") as f:
+    for name, addr in sorted(symbols.items(), key=lambda kv: kv[1]):
+        f.write(f"{name} = ${addr:04X}\n")
+
 print("rom.bin generated (Nuclear Option: Safe Delays + Blinking Cursor)")
\ No newline at end of file